@@ -1002,6 +1002,12 @@ ifeq ($(strip $(ANALOG_DRIVER_REQUIRED)), yes)
     QUANTUM_LIB_SRC += analog.c
 endif
 
+ifeq ($(strip $(I2C_QUEUE_ENABLE)), yes)
+    I2C_DRIVER_REQUIRED = yes
+    OPT_DEFS += -DI2C_QUEUE_ENABLE
+    QUANTUM_LIB_SRC += i2c_queue.c
+endif
+
 ifeq ($(strip $(I2C_DRIVER_REQUIRED)), yes)
     OPT_DEFS += -DHAL_USE_I2C=TRUE
     QUANTUM_LIB_SRC += i2c_master.c
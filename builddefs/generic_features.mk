@@ -53,6 +53,8 @@ GENERIC_FEATURES = \
     SPACE_CADET \
     SWAP_HANDS \
     TAP_DANCE \
+    TASK_PROFILER \
+    TASK_SCHEDULER \
     TRI_LAYER \
     VIA \
     VIRTSER \
@@ -83,3 +83,13 @@ void eeprom_driver_format(bool erase) {
     (void)erase; /* The default implementation assumes that the eeprom must be erased in order to be usable. */
     eeprom_driver_erase();
 }
+
+void eeprom_driver_task(void) __attribute__((weak));
+void eeprom_driver_task(void) {
+    /* The default implementation writes through, so there's nothing to do in the background. */
+}
+
+void eeprom_driver_flush(void) __attribute__((weak));
+void eeprom_driver_flush(void) {
+    /* The default implementation writes through, so there's never anything to flush. */
+}
@@ -22,3 +22,5 @@
 void eeprom_driver_init(void);
 void eeprom_driver_format(bool erase);
 void eeprom_driver_erase(void);
+void eeprom_driver_task(void);
+void eeprom_driver_flush(void);
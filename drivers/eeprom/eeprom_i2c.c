@@ -42,10 +42,13 @@
 // #define DEBUG_EEPROM_OUTPUT
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-#    include "timer.h"
 #    include "debug.h"
 #endif // DEBUG_EEPROM_OUTPUT
 
+#if (defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)) || defined(EXTERNAL_EEPROM_WRITE_BACK)
+#    include "timer.h"
+#endif
+
 static inline void fill_target_address(uint8_t *buffer, const void *addr) {
     uintptr_t p = (uintptr_t)addr;
     for (int i = 0; i < EXTERNAL_EEPROM_ADDRESS_SIZE; ++i) {
@@ -70,23 +73,69 @@ void eeprom_driver_format(bool erase) {
     }
 }
 
-void eeprom_driver_erase(void) {
-#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-    uint32_t start = timer_read32();
-#endif
+#ifdef EXTERNAL_EEPROM_WRITE_BACK
+typedef struct eeprom_write_back_page_t {
+    uintptr_t address;                                    // start of the buffered page
+    uint16_t  dirty_start;                                // offset of the first modified byte
+    uint16_t  dirty_end;                                  // offset past the last modified byte, the page is unused while this equals dirty_start
+    uint8_t   known[(EXTERNAL_EEPROM_PAGE_SIZE + 7) / 8]; // bitmap of bytes in data which hold a pending write or a value read back
+    uint8_t   data[EXTERNAL_EEPROM_PAGE_SIZE];
+} eeprom_write_back_page_t;
 
-    uint8_t buf[EXTERNAL_EEPROM_PAGE_SIZE];
-    memset(buf, 0x00, EXTERNAL_EEPROM_PAGE_SIZE);
-    for (uint32_t addr = 0; addr < EXTERNAL_EEPROM_BYTE_COUNT; addr += EXTERNAL_EEPROM_PAGE_SIZE) {
-        eeprom_write_block(buf, (void *)(uintptr_t)addr, EXTERNAL_EEPROM_PAGE_SIZE);
+static eeprom_write_back_page_t write_back_pages[EXTERNAL_EEPROM_WRITE_BACK_PAGES];
+static uint8_t                  write_back_evict    = 0;
+static bool                     write_cycle_pending = false;
+static uint32_t                 write_cycle_start   = 0;
+
+static inline bool write_back_page_in_use(const eeprom_write_back_page_t *page) {
+    return page->dirty_end != page->dirty_start;
+}
+
+static inline bool write_back_byte_known(const eeprom_write_back_page_t *page, uint16_t offset) {
+    return page->known[offset / 8] & (1 << (offset % 8));
+}
+
+static inline void write_back_byte_set_known(eeprom_write_back_page_t *page, uint16_t offset) {
+    page->known[offset / 8] |= (1 << (offset % 8));
+}
+#endif // EXTERNAL_EEPROM_WRITE_BACK
+
+/* Transmits one write, which must not cross a page boundary. Returns without waiting for the write cycle. */
+static void eeprom_i2c_write_page(uintptr_t target_addr, const uint8_t *buf, uint16_t write_length) {
+    uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
+
+    fill_target_address(complete_packet, (const void *)target_addr);
+    for (uint16_t i = 0; i < write_length; i++) {
+        complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + i] = buf[i];
     }
 
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-    dprintf("EEPROM erase took %ldms to complete\n", ((long)(timer_read32() - start)));
+    dprintf("[EEPROM W] 0x%04X: ", ((int)target_addr));
+    for (uint16_t i = 0; i < write_length; i++) {
+        dprintf(" %02X", (int)(buf[i]));
+    }
+    dprintf("\n");
+#endif // DEBUG_EEPROM_OUTPUT
+
+    i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS(target_addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + write_length, 100);
+}
+
+static void eeprom_i2c_write_protect(bool protect) {
+#if defined(EXTERNAL_EEPROM_WP_PIN)
+    if (protect) {
+        /* We are setting the WP pin to high in a way that requires at least two bit-flips to change back to 0 */
+        gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 1);
+        gpio_set_pin_input_high(EXTERNAL_EEPROM_WP_PIN);
+    } else {
+        gpio_set_pin_output(EXTERNAL_EEPROM_WP_PIN);
+        gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 0);
+    }
+#else
+    (void)protect;
 #endif
 }
 
-void eeprom_read_block(void *buf, const void *addr, size_t len) {
+static void eeprom_i2c_read_block(void *buf, const void *addr, size_t len) {
     uint8_t complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE];
     fill_target_address(complete_packet, addr);
 
@@ -102,47 +151,220 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
 #endif // DEBUG_EEPROM_OUTPUT
 }
 
-void eeprom_write_block(const void *buf, void *addr, size_t len) {
-    uint8_t   complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + EXTERNAL_EEPROM_PAGE_SIZE];
-    uint8_t * read_buf    = (uint8_t *)buf;
-    uintptr_t target_addr = (uintptr_t)addr;
+#ifdef EXTERNAL_EEPROM_WRITE_BACK
+/* Checks whether the last background write has finished, optionally blocking until it has. */
+static bool eeprom_i2c_write_cycle_complete(bool block) {
+    if (write_cycle_pending) {
+        // Millisecond ticks may already be partway through, so wait for one more than the cycle time
+        while (timer_elapsed32(write_cycle_start) <= EXTERNAL_EEPROM_WRITE_TIME) {
+            if (!block) {
+                return false;
+            }
+        }
+        write_cycle_pending = false;
+        eeprom_i2c_write_protect(true);
+    }
+    return true;
+}
 
-#if defined(EXTERNAL_EEPROM_WP_PIN)
-    gpio_set_pin_output(EXTERNAL_EEPROM_WP_PIN);
-    gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 0);
-#endif
+/* Starts the write of a dirty page, leaving the EEPROM busy in the background. */
+static void eeprom_i2c_write_back_start(eeprom_write_back_page_t *page) {
+    eeprom_i2c_write_cycle_complete(true);
+
+    // Merged writes may have left a gap, fill it from the EEPROM now that it is idle
+    for (uint16_t i = page->dirty_start; i < page->dirty_end; i++) {
+        if (!write_back_byte_known(page, i)) {
+            uint8_t current[EXTERNAL_EEPROM_PAGE_SIZE];
+            eeprom_i2c_read_block(current, (const void *)(page->address + page->dirty_start), page->dirty_end - page->dirty_start);
+            for (; i < page->dirty_end; i++) {
+                if (!write_back_byte_known(page, i)) {
+                    page->data[i] = current[i - page->dirty_start];
+                }
+            }
+            break;
+        }
+    }
+
+    eeprom_i2c_write_protect(false);
+    eeprom_i2c_write_page(page->address + page->dirty_start, &page->data[page->dirty_start], page->dirty_end - page->dirty_start);
+    page->dirty_start = page->dirty_end = 0;
+    write_cycle_start                   = timer_read32();
+    write_cycle_pending                 = true;
+}
+#endif // EXTERNAL_EEPROM_WRITE_BACK
+
+static void eeprom_i2c_write_block(const void *buf, void *addr, size_t len) {
+    const uint8_t *read_buf    = (const uint8_t *)buf;
+    uintptr_t      target_addr = (uintptr_t)addr;
+
+#ifdef EXTERNAL_EEPROM_WRITE_BACK
+    eeprom_i2c_write_cycle_complete(true);
+#endif // EXTERNAL_EEPROM_WRITE_BACK
+    eeprom_i2c_write_protect(false);
 
     while (len > 0) {
         uintptr_t page_offset  = target_addr % EXTERNAL_EEPROM_PAGE_SIZE;
-        int       write_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
+        size_t    write_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
         if (write_length > len) {
             write_length = len;
         }
 
-        fill_target_address(complete_packet, (const void *)target_addr);
-        for (uint8_t i = 0; i < write_length; i++) {
-            complete_packet[EXTERNAL_EEPROM_ADDRESS_SIZE + i] = read_buf[i];
-        }
+        eeprom_i2c_write_page(target_addr, read_buf, write_length);
+        wait_ms(EXTERNAL_EEPROM_WRITE_TIME);
+
+        read_buf += write_length;
+        target_addr += write_length;
+        len -= write_length;
+    }
 
+    eeprom_i2c_write_protect(true);
+}
+
+void eeprom_driver_erase(void) {
 #if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
-        dprintf("[EEPROM W] 0x%04X: ", ((int)target_addr));
-        for (uint8_t i = 0; i < write_length; i++) {
-            dprintf(" %02X", (int)(read_buf[i]));
+    uint32_t start = timer_read32();
+#endif
+
+#ifdef EXTERNAL_EEPROM_WRITE_BACK
+    // Anything still buffered is about to be overwritten anyway
+    memset(write_back_pages, 0, sizeof(write_back_pages));
+#endif // EXTERNAL_EEPROM_WRITE_BACK
+
+    uint8_t buf[EXTERNAL_EEPROM_PAGE_SIZE];
+    memset(buf, 0x00, EXTERNAL_EEPROM_PAGE_SIZE);
+    for (uint32_t addr = 0; addr < EXTERNAL_EEPROM_BYTE_COUNT; addr += EXTERNAL_EEPROM_PAGE_SIZE) {
+        eeprom_i2c_write_block(buf, (void *)(uintptr_t)addr, EXTERNAL_EEPROM_PAGE_SIZE);
+    }
+
+#if defined(CONSOLE_ENABLE) && defined(DEBUG_EEPROM_OUTPUT)
+    dprintf("EEPROM erase took %ldms to complete\n", ((long)(timer_read32() - start)));
+#endif
+}
+
+#ifdef EXTERNAL_EEPROM_WRITE_BACK
+/* Copies the bytes the buffered pages know into `buf`, and if `learn` is set, remembers the rest from `buf`. Returns the number of bytes copied. */
+static size_t eeprom_i2c_write_back_merge(uint8_t *buf, uintptr_t start, uintptr_t end, bool learn) {
+    size_t copied = 0;
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_WRITE_BACK_PAGES; i++) {
+        eeprom_write_back_page_t *page = &write_back_pages[i];
+        if (!write_back_page_in_use(page) || page->address >= end || page->address + EXTERNAL_EEPROM_PAGE_SIZE <= start) {
+            continue;
         }
-        dprintf("\n");
-#endif // DEBUG_EEPROM_OUTPUT
+        uintptr_t from = page->address > start ? page->address : start;
+        uintptr_t to   = page->address + EXTERNAL_EEPROM_PAGE_SIZE < end ? page->address + EXTERNAL_EEPROM_PAGE_SIZE : end;
+        for (uintptr_t addr = from; addr < to; addr++) {
+            uint16_t offset = addr - page->address;
+            if (write_back_byte_known(page, offset)) {
+                buf[addr - start] = page->data[offset];
+                copied++;
+            } else if (learn) {
+                page->data[offset] = buf[addr - start];
+                write_back_byte_set_known(page, offset);
+            }
+        }
+    }
+    return copied;
+}
 
-        i2c_transmit(EXTERNAL_EEPROM_I2C_ADDRESS((uintptr_t)addr), complete_packet, EXTERNAL_EEPROM_ADDRESS_SIZE + write_length, 100);
-        wait_ms(EXTERNAL_EEPROM_WRITE_TIME);
+void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    uintptr_t start = (uintptr_t)addr;
+    uintptr_t end   = start + len;
 
-        read_buf += write_length;
+    // Reads covered entirely by the buffered pages never touch the bus, even mid write cycle
+    if (eeprom_i2c_write_back_merge(buf, start, end, false) == len) {
+        return;
+    }
+
+    // The EEPROM ignores reads during a write cycle
+    eeprom_i2c_write_cycle_complete(true);
+    eeprom_i2c_read_block(buf, addr, len);
+
+    // Overlay anything which hasn't been written out yet, and keep what was read for the next read-modify-write
+    eeprom_i2c_write_back_merge(buf, start, end, true);
+}
+
+void eeprom_write_block(const void *buf, void *addr, size_t len) {
+    const uint8_t *src         = (const uint8_t *)buf;
+    uintptr_t      target_addr = (uintptr_t)addr;
+
+    while (len > 0) {
+        uintptr_t page_address = target_addr - (target_addr % EXTERNAL_EEPROM_PAGE_SIZE);
+        uint16_t  page_offset  = target_addr - page_address;
+        uint16_t  write_length = EXTERNAL_EEPROM_PAGE_SIZE - page_offset;
+        if (write_length > len) {
+            write_length = len;
+        }
+
+        eeprom_write_back_page_t *page = NULL;
+        eeprom_write_back_page_t *unused = NULL;
+        for (uint8_t i = 0; i < EXTERNAL_EEPROM_WRITE_BACK_PAGES; i++) {
+            if (!write_back_page_in_use(&write_back_pages[i])) {
+                unused = unused ? unused : &write_back_pages[i];
+            } else if (write_back_pages[i].address == page_address) {
+                page = &write_back_pages[i];
+                break;
+            }
+        }
+
+        if (!page) {
+            if (!unused) {
+                // Journal is full, write out the next page in turn to make room
+                unused           = &write_back_pages[write_back_evict];
+                write_back_evict = (write_back_evict + 1) % EXTERNAL_EEPROM_WRITE_BACK_PAGES;
+                eeprom_i2c_write_back_start(unused);
+            }
+            // The rest of the page is read lazily, any gap between merged writes is filled at write out
+            page          = unused;
+            page->address = page_address;
+            memset(page->known, 0, sizeof(page->known));
+            page->dirty_start = page_offset;
+            page->dirty_end   = page_offset;
+        }
+
+        memcpy(&page->data[page_offset], src, write_length);
+        for (uint16_t i = page_offset; i < page_offset + write_length; i++) {
+            write_back_byte_set_known(page, i);
+        }
+        if (!write_back_page_in_use(page) || page_offset < page->dirty_start) {
+            page->dirty_start = page_offset;
+        }
+        if (page_offset + write_length > page->dirty_end) {
+            page->dirty_end = page_offset + write_length;
+        }
+
+        src += write_length;
         target_addr += write_length;
         len -= write_length;
     }
+}
 
-#if defined(EXTERNAL_EEPROM_WP_PIN)
-    /* We are setting the WP pin to high in a way that requires at least two bit-flips to change back to 0 */
-    gpio_write_pin(EXTERNAL_EEPROM_WP_PIN, 1);
-    gpio_set_pin_input_high(EXTERNAL_EEPROM_WP_PIN);
-#endif
+void eeprom_driver_task(void) {
+    // One page per pass, and only once the EEPROM has finished the previous one
+    if (!eeprom_i2c_write_cycle_complete(false)) {
+        return;
+    }
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_WRITE_BACK_PAGES; i++) {
+        if (write_back_page_in_use(&write_back_pages[i])) {
+            eeprom_i2c_write_back_start(&write_back_pages[i]);
+            return;
+        }
+    }
+}
+
+void eeprom_driver_flush(void) {
+    for (uint8_t i = 0; i < EXTERNAL_EEPROM_WRITE_BACK_PAGES; i++) {
+        if (write_back_page_in_use(&write_back_pages[i])) {
+            eeprom_i2c_write_back_start(&write_back_pages[i]);
+        }
+    }
+    eeprom_i2c_write_cycle_complete(true);
+}
+#else
+void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    eeprom_i2c_read_block(buf, addr, len);
+}
+
+void eeprom_write_block(const void *buf, void *addr, size_t len) {
+    eeprom_i2c_write_block(buf, addr, len);
 }
+#endif // EXTERNAL_EEPROM_WRITE_BACK
@@ -123,3 +123,14 @@
 #ifndef EXTERNAL_EEPROM_WRITE_TIME
 #    define EXTERNAL_EEPROM_WRITE_TIME 5
 #endif
+
+/*
+    The number of EEPROM pages held in RAM when EXTERNAL_EEPROM_WRITE_BACK is
+    defined. Writes land in these buffers and return immediately; dirty pages
+    are written out one at a time from housekeeping, without waiting for the
+    EEPROM's write cycle to complete. Each buffer costs roughly
+    EXTERNAL_EEPROM_PAGE_SIZE bytes of RAM.
+*/
+#ifndef EXTERNAL_EEPROM_WRITE_BACK_PAGES
+#    define EXTERNAL_EEPROM_WRITE_BACK_PAGES 4
+#endif
@@ -6,6 +6,16 @@
 #include "eeprom_driver.h"
 #include "wear_leveling.h"
 
+#ifdef WEAR_LEVELING_WRITE_BATCHING
+#    include "timer.h"
+
+#    ifndef WEAR_LEVELING_WRITE_BATCH_WINDOW_MS
+#        define WEAR_LEVELING_WRITE_BATCH_WINDOW_MS 250
+#    endif
+
+static uint32_t pending_since = 0;
+#endif // WEAR_LEVELING_WRITE_BATCHING
+
 void eeprom_driver_init(void) {
     wear_leveling_init();
 }
@@ -25,5 +35,26 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
 }
 
 void eeprom_write_block(const void *buf, void *addr, size_t len) {
+#ifdef WEAR_LEVELING_WRITE_BATCHING
+    bool was_pending = wear_leveling_has_pending();
+#endif // WEAR_LEVELING_WRITE_BATCHING
     wear_leveling_write((uint32_t)addr, buf, len);
+#ifdef WEAR_LEVELING_WRITE_BATCHING
+    if (!was_pending) {
+        pending_since = timer_read32();
+    }
+#endif // WEAR_LEVELING_WRITE_BATCHING
+}
+
+#ifdef WEAR_LEVELING_WRITE_BATCHING
+void eeprom_driver_task(void) {
+    // Writes arriving within the window are logged together
+    if (wear_leveling_has_pending() && timer_elapsed32(pending_since) >= WEAR_LEVELING_WRITE_BATCH_WINDOW_MS) {
+        wear_leveling_flush();
+    }
+}
+
+void eeprom_driver_flush(void) {
+    wear_leveling_flush();
 }
+#endif // WEAR_LEVELING_WRITE_BATCHING
@@ -0,0 +1,190 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "i2c_queue.h"
+#include <stddef.h>
+#include <string.h>
+
+#if I2C_QUEUE_SIZE < 1 || I2C_QUEUE_SIZE > UINT8_MAX
+#    error I2C_QUEUE_SIZE must be between 1 and 255
+#endif
+
+#if I2C_QUEUE_DATA_SIZE > UINT16_MAX
+#    error I2C_QUEUE_DATA_SIZE must not exceed 65535
+#endif
+
+typedef enum i2c_queue_op_t {
+    I2C_QUEUE_OP_TRANSMIT,
+    I2C_QUEUE_OP_RECEIVE,
+    I2C_QUEUE_OP_WRITE_REGISTER,
+    I2C_QUEUE_OP_READ_REGISTER,
+} i2c_queue_op_t;
+
+typedef struct i2c_queue_entry_t {
+    uint8_t              op;
+    uint8_t              address;
+    uint8_t              regaddr;
+    bool                 burst;
+    uint16_t             length;
+    uint16_t             timeout;
+    uint16_t             offset; // into the data pool, for writes
+    uint8_t*             buffer; // to read into
+    i2c_queue_callback_t callback;
+    void*                context;
+} i2c_queue_entry_t;
+
+static i2c_queue_entry_t entries[I2C_QUEUE_SIZE];
+static uint8_t           entry_head  = 0;
+static uint8_t           entry_count = 0;
+
+// Write data is allocated contiguously, in queue order, wrapping to the start of the pool when the end is reached
+static uint8_t  pool[I2C_QUEUE_DATA_SIZE];
+static uint16_t pool_head = 0;
+static uint16_t pool_tail = 0;
+
+static i2c_queue_entry_t* entry_at(uint8_t index) {
+    return &entries[(entry_head + index) % I2C_QUEUE_SIZE];
+}
+
+/**
+ * \brief Finds `length` contiguous bytes in the data pool, without claiming them.
+ *
+ * \return The offset of the bytes, or -1 if there is not enough room.
+ */
+static int32_t pool_find(uint16_t length) {
+    if (entry_count == 0) {
+        pool_head = 0;
+        pool_tail = 0;
+    }
+
+    if (pool_head >= pool_tail) {
+        if (length <= I2C_QUEUE_DATA_SIZE - pool_head) {
+            return pool_head;
+        }
+        // Wrapping around must leave pool_head behind pool_tail, so that a full pool is not mistaken for an empty one
+        if (length < pool_tail) {
+            return 0;
+        }
+    } else if (pool_head + length < pool_tail) {
+        return pool_head;
+    }
+    return -1;
+}
+
+static bool enqueue(uint8_t op, uint8_t address, uint8_t regaddr, bool burst, const uint8_t* data, uint8_t* buffer, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* context) {
+    if (data == NULL && buffer == NULL && length > 0) {
+        return false;
+    }
+
+    int32_t offset = 0;
+    if (data != NULL && length > 0) {
+        offset = pool_find(length);
+        if (offset < 0) {
+            return false;
+        }
+    }
+
+    if (burst && entry_count > 0) {
+        i2c_queue_entry_t* last = entry_at(entry_count - 1);
+        if (last->burst && last->callback == NULL && last->address == address && last->regaddr + last->length == regaddr && last->offset + last->length == offset && last->length <= UINT16_MAX - length) {
+            memcpy(&pool[offset], data, length);
+            pool_head = offset + length;
+
+            last->length += length;
+            last->timeout  = timeout > last->timeout ? timeout : last->timeout;
+            last->callback = callback;
+            last->context  = context;
+            return true;
+        }
+    }
+
+    if (entry_count == I2C_QUEUE_SIZE) {
+        return false;
+    }
+
+    if (data != NULL && length > 0) {
+        memcpy(&pool[offset], data, length);
+        pool_head = offset + length;
+    }
+
+    *entry_at(entry_count++) = (i2c_queue_entry_t){
+        .op       = op,
+        .address  = address,
+        .regaddr  = regaddr,
+        .burst    = burst,
+        .length   = length,
+        .timeout  = timeout,
+        .offset   = offset,
+        .buffer   = buffer,
+        .callback = callback,
+        .context  = context,
+    };
+    return true;
+}
+
+bool i2c_queue_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* context) {
+    return enqueue(I2C_QUEUE_OP_TRANSMIT, address, 0, false, data, NULL, length, timeout, callback, context);
+}
+
+bool i2c_queue_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* context) {
+    return enqueue(I2C_QUEUE_OP_RECEIVE, address, 0, false, NULL, data, length, timeout, callback, context);
+}
+
+bool i2c_queue_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* context) {
+    return enqueue(I2C_QUEUE_OP_WRITE_REGISTER, devaddr, regaddr, false, data, NULL, length, timeout, callback, context);
+}
+
+bool i2c_queue_write_register_burst(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* context) {
+    return enqueue(I2C_QUEUE_OP_WRITE_REGISTER, devaddr, regaddr, true, data, NULL, length, timeout, callback, context);
+}
+
+bool i2c_queue_read_register(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* context) {
+    return enqueue(I2C_QUEUE_OP_READ_REGISTER, devaddr, regaddr, false, NULL, data, length, timeout, callback, context);
+}
+
+uint8_t i2c_queue_pending(void) {
+    return entry_count;
+}
+
+static void run_next(void) {
+    i2c_queue_entry_t entry = *entry_at(0);
+
+    i2c_status_t status = I2C_STATUS_ERROR;
+    switch (entry.op) {
+        case I2C_QUEUE_OP_TRANSMIT:
+            status = i2c_transmit(entry.address, &pool[entry.offset], entry.length, entry.timeout);
+            break;
+        case I2C_QUEUE_OP_RECEIVE:
+            status = i2c_receive(entry.address, entry.buffer, entry.length, entry.timeout);
+            break;
+        case I2C_QUEUE_OP_WRITE_REGISTER:
+            status = i2c_write_register(entry.address, entry.regaddr, &pool[entry.offset], entry.length, entry.timeout);
+            break;
+        case I2C_QUEUE_OP_READ_REGISTER:
+            status = i2c_read_register(entry.address, entry.regaddr, entry.buffer, entry.length, entry.timeout);
+            break;
+    }
+
+    // Free the entry before the callback runs, so that it can queue a follow up transaction
+    if (entry.buffer == NULL && entry.length > 0) {
+        pool_tail = entry.offset + entry.length;
+    }
+    entry_head = (entry_head + 1) % I2C_QUEUE_SIZE;
+    entry_count--;
+
+    if (entry.callback != NULL) {
+        entry.callback(status, entry.context);
+    }
+}
+
+void i2c_queue_task(void) {
+    for (uint8_t i = 0; i < I2C_QUEUE_TASK_TRANSACTIONS && entry_count > 0; i++) {
+        run_next();
+    }
+}
+
+void i2c_queue_flush(void) {
+    while (entry_count > 0) {
+        run_next();
+    }
+}
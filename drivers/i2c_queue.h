@@ -0,0 +1,141 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "i2c_master.h"
+
+/**
+ * \file
+ *
+ * \defgroup i2c_queue I2C Transaction Queue
+ *
+ * \brief Queues I2C transactions so that they run from the main loop, rather than stalling the caller.
+ *
+ * Transactions run in the order they were queued, I2C_QUEUE_TASK_TRANSACTIONS at a time from i2c_queue_task(),
+ * on top of the blocking I2C Master API. Data to be written is copied into the queue, so the caller's buffer may
+ * be reused straight away. Buffers to be read into must stay valid until the transaction has completed.
+ *
+ * The queue functions return false, without queueing anything, when the queue is full. Callers may retry later, or
+ * call i2c_queue_flush() to drain it first.
+ *
+ * Transactions made directly through the I2C Master API are not ordered against queued ones; call
+ * i2c_queue_flush() beforehand where that matters.
+ * \{
+ */
+
+#ifndef I2C_QUEUE_SIZE
+#    define I2C_QUEUE_SIZE 8
+#endif
+
+#ifndef I2C_QUEUE_DATA_SIZE
+#    define I2C_QUEUE_DATA_SIZE 256
+#endif
+
+#ifndef I2C_QUEUE_TASK_TRANSACTIONS
+#    define I2C_QUEUE_TASK_TRANSACTIONS 1
+#endif
+
+/**
+ * \brief Called once a queued transaction has completed.
+ *
+ * \param status The result of the transaction, as returned by the I2C Master API.
+ * \param context The context given when the transaction was queued.
+ */
+typedef void (*i2c_queue_callback_t)(i2c_status_t status, void* context);
+
+/**
+ * \brief Queue sending multiple bytes to the selected I2C device.
+ *
+ * \param address The 7-bit I2C address of the device.
+ * \param data A pointer to the data to transmit, which is copied into the queue.
+ * \param length The number of bytes to write.
+ * \param timeout The time in milliseconds to wait for a response from the target device.
+ * \param callback Called once the transaction has completed. May be `NULL`.
+ * \param context Passed to `callback`.
+ *
+ * \return `true` if the transaction was queued.
+ */
+bool i2c_queue_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* context);
+
+/**
+ * \brief Queue receiving multiple bytes from the selected I2C device.
+ *
+ * \param address The 7-bit I2C address of the device.
+ * \param data A pointer to a buffer to read into, which must stay valid until the transaction has completed.
+ * \param length The number of bytes to read.
+ * \param timeout The time in milliseconds to wait for a response from the target device.
+ * \param callback Called once the transaction has completed. May be `NULL`.
+ * \param context Passed to `callback`.
+ *
+ * \return `true` if the transaction was queued.
+ */
+bool i2c_queue_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* context);
+
+/**
+ * \brief Queue a write to a register with an 8-bit address on the I2C device.
+ *
+ * \param devaddr The 7-bit I2C address of the device.
+ * \param regaddr The register address to write to.
+ * \param data A pointer to the data to transmit, which is copied into the queue.
+ * \param length The number of bytes to write.
+ * \param timeout The time in milliseconds to wait for a response from the target device.
+ * \param callback Called once the transaction has completed. May be `NULL`.
+ * \param context Passed to `callback`.
+ *
+ * \return `true` if the transaction was queued.
+ */
+bool i2c_queue_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* context);
+
+/**
+ * \brief Queue a write to a register with an 8-bit address, on an I2C device which auto-increments the register
+ * address.
+ *
+ * If the last queued transaction is a burst write to the same device, without a callback, ending at `regaddr`,
+ * the data is appended to it so that both are sent in a single transfer.
+ *
+ * \param devaddr The 7-bit I2C address of the device.
+ * \param regaddr The register address to write to.
+ * \param data A pointer to the data to transmit, which is copied into the queue.
+ * \param length The number of bytes to write.
+ * \param timeout The time in milliseconds to wait for a response from the target device.
+ * \param callback Called once the transaction has completed. May be `NULL`.
+ * \param context Passed to `callback`.
+ *
+ * \return `true` if the transaction was queued.
+ */
+bool i2c_queue_write_register_burst(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* context);
+
+/**
+ * \brief Queue a read from a register with an 8-bit address on the I2C device.
+ *
+ * \param devaddr The 7-bit I2C address of the device.
+ * \param regaddr The register address to read from.
+ * \param data A pointer to a buffer to read into, which must stay valid until the transaction has completed.
+ * \param length The number of bytes to read.
+ * \param timeout The time in milliseconds to wait for a response from the target device.
+ * \param callback Called once the transaction has completed. May be `NULL`.
+ * \param context Passed to `callback`.
+ *
+ * \return `true` if the transaction was queued.
+ */
+bool i2c_queue_read_register(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout, i2c_queue_callback_t callback, void* context);
+
+/**
+ * \brief The number of transactions waiting to run.
+ */
+uint8_t i2c_queue_pending(void);
+
+/**
+ * \brief Run the next I2C_QUEUE_TASK_TRANSACTIONS queued transactions. Called from the main loop.
+ */
+void i2c_queue_task(void);
+
+/**
+ * \brief Run all queued transactions, including any queued by their callbacks, before returning.
+ */
+void i2c_queue_flush(void);
+
+/** \} */
@@ -0,0 +1,48 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include "i2c_master.h"
+
+/**
+ * \file
+ *
+ * Dirty tracking for LED driver PWM buffers which are transferred in fixed size blocks of registers.
+ *
+ * Each bit of an is31_dirty_blocks_t marks one block that has changed since the last flush. Only those blocks
+ * are written, and runs of adjacent dirty blocks are sent as a single transfer, relying on the register address
+ * auto-increment. Each driver passes its own block size, and the buffer may span at most 16 blocks.
+ */
+
+typedef uint16_t is31_dirty_blocks_t;
+
+// The dirty bit of the block holding the given register
+#define IS31_DIRTY_BLOCK(reg, block_size) ((is31_dirty_blocks_t)1 << ((reg) / (block_size)))
+
+/**
+ * \brief Writes the dirty blocks of `buffer`.
+ *
+ * \param address The 7-bit I2C address of the driver.
+ * \param first_register The register holding `buffer[0]`.
+ * \param block_size The number of registers tracked by each dirty bit.
+ * \param persistence The number of attempts per transfer; 0 makes a single attempt.
+ */
+static inline void is31_dirty_blocks_write(uint8_t address, uint8_t first_register, const uint8_t *buffer, is31_dirty_blocks_t dirty, uint8_t block_size, uint16_t timeout, uint8_t persistence) {
+    while (dirty) {
+        uint8_t first = __builtin_ctz(dirty);
+        uint8_t count = __builtin_ctz(~((unsigned int)dirty >> first));
+
+        uint8_t offset = first * block_size;
+        uint8_t length = count * block_size;
+        uint8_t tries  = 0;
+
+        i2c_status_t status;
+        do {
+            status = i2c_write_register(address << 1, first_register + offset, buffer + offset, length, timeout);
+        } while (status != I2C_STATUS_SUCCESS && ++tries < persistence);
+
+        dirty &= ~(((1u << count) - 1) << first);
+    }
+}
@@ -18,10 +18,12 @@
 
 #include "is31fl3731.h"
 #include "i2c_master.h"
+#include "is31_dirty_blocks.h"
 #include "gpio.h"
 #include "wait.h"
 
 #define IS31FL3731_PWM_REGISTER_COUNT 144
+#define IS31FL3731_PWM_BLOCK_SIZE 16
 #define IS31FL3731_LED_CONTROL_REGISTER_COUNT 18
 
 #ifndef IS31FL3731_I2C_TIMEOUT
@@ -51,15 +53,15 @@ const uint8_t i2c_addresses[IS31FL3731_DRIVER_COUNT] = {
 // buffers and the transfers in is31fl3731_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 typedef struct is31fl3731_driver_t {
-    uint8_t pwm_buffer[IS31FL3731_PWM_REGISTER_COUNT];
-    bool    pwm_buffer_dirty;
-    uint8_t led_control_buffer[IS31FL3731_LED_CONTROL_REGISTER_COUNT];
-    bool    led_control_buffer_dirty;
+    uint8_t             pwm_buffer[IS31FL3731_PWM_REGISTER_COUNT];
+    is31_dirty_blocks_t pwm_buffer_dirty;
+    uint8_t             led_control_buffer[IS31FL3731_LED_CONTROL_REGISTER_COUNT];
+    bool                led_control_buffer_dirty;
 } PACKED is31fl3731_driver_t;
 
 is31fl3731_driver_t driver_buffers[IS31FL3731_DRIVER_COUNT] = {{
     .pwm_buffer               = {0},
-    .pwm_buffer_dirty         = false,
+    .pwm_buffer_dirty         = 0,
     .led_control_buffer       = {0},
     .led_control_buffer_dirty = false,
 }};
@@ -80,18 +82,9 @@ void is31fl3731_select_page(uint8_t index, uint8_t page) {
 
 void is31fl3731_write_pwm_buffer(uint8_t index) {
     // Assumes page 0 is already selected.
-    // Transmit PWM registers in 9 transfers of 16 bytes.
-
-    // Iterate over the pwm_buffer contents at 16 byte intervals.
-    for (uint8_t i = 0; i < IS31FL3731_PWM_REGISTER_COUNT; i += 16) {
-#if IS31FL3731_I2C_PERSISTENCE > 0
-        for (uint8_t j = 0; j < IS31FL3731_I2C_PERSISTENCE; j++) {
-            if (i2c_write_register(i2c_addresses[index] << 1, IS31FL3731_FRAME_REG_PWM + i, driver_buffers[index].pwm_buffer + i, 16, IS31FL3731_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
-        }
-#else
-        i2c_write_register(i2c_addresses[index] << 1, IS31FL3731_FRAME_REG_PWM + i, driver_buffers[index].pwm_buffer + i, 16, IS31FL3731_I2C_TIMEOUT);
-#endif
-    }
+    // Transmit only the 16 byte blocks of PWM registers which have changed,
+    // with adjacent blocks merged into a single transfer.
+    is31_dirty_blocks_write(i2c_addresses[index], IS31FL3731_FRAME_REG_PWM, driver_buffers[index].pwm_buffer, driver_buffers[index].pwm_buffer_dirty, IS31FL3731_PWM_BLOCK_SIZE, IS31FL3731_I2C_TIMEOUT, IS31FL3731_I2C_PERSISTENCE);
 }
 
 void is31fl3731_init_drivers(void) {
@@ -180,7 +173,7 @@ void is31fl3731_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
         driver_buffers[led.driver].pwm_buffer[led.r] = red;
         driver_buffers[led.driver].pwm_buffer[led.g] = green;
         driver_buffers[led.driver].pwm_buffer[led.b] = blue;
-        driver_buffers[led.driver].pwm_buffer_dirty  = true;
+        driver_buffers[led.driver].pwm_buffer_dirty |= IS31_DIRTY_BLOCK(led.r, IS31FL3731_PWM_BLOCK_SIZE) | IS31_DIRTY_BLOCK(led.g, IS31FL3731_PWM_BLOCK_SIZE) | IS31_DIRTY_BLOCK(led.b, IS31FL3731_PWM_BLOCK_SIZE);
     }
 }
 
@@ -224,7 +217,7 @@ void is31fl3731_update_pwm_buffers(uint8_t index) {
     if (driver_buffers[index].pwm_buffer_dirty) {
         is31fl3731_write_pwm_buffer(index);
 
-        driver_buffers[index].pwm_buffer_dirty = false;
+        driver_buffers[index].pwm_buffer_dirty = 0;
     }
 }
 
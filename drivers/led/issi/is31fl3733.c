@@ -19,10 +19,12 @@
 
 #include "is31fl3733.h"
 #include "i2c_master.h"
+#include "is31_dirty_blocks.h"
 #include "gpio.h"
 #include "wait.h"
 
 #define IS31FL3733_PWM_REGISTER_COUNT 192
+#define IS31FL3733_PWM_BLOCK_SIZE 16
 #define IS31FL3733_LED_CONTROL_REGISTER_COUNT 24
 
 #ifndef IS31FL3733_I2C_TIMEOUT
@@ -95,15 +97,15 @@ const uint8_t driver_sync[IS31FL3733_DRIVER_COUNT] = {
 // buffers and the transfers in is31fl3733_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 typedef struct is31fl3733_driver_t {
-    uint8_t pwm_buffer[IS31FL3733_PWM_REGISTER_COUNT];
-    bool    pwm_buffer_dirty;
-    uint8_t led_control_buffer[IS31FL3733_LED_CONTROL_REGISTER_COUNT];
-    bool    led_control_buffer_dirty;
+    uint8_t             pwm_buffer[IS31FL3733_PWM_REGISTER_COUNT];
+    is31_dirty_blocks_t pwm_buffer_dirty;
+    uint8_t             led_control_buffer[IS31FL3733_LED_CONTROL_REGISTER_COUNT];
+    bool                led_control_buffer_dirty;
 } PACKED is31fl3733_driver_t;
 
 is31fl3733_driver_t driver_buffers[IS31FL3733_DRIVER_COUNT] = {{
     .pwm_buffer               = {0},
-    .pwm_buffer_dirty         = false,
+    .pwm_buffer_dirty         = 0,
     .led_control_buffer       = {0},
     .led_control_buffer_dirty = false,
 }};
@@ -125,18 +127,9 @@ void is31fl3733_select_page(uint8_t index, uint8_t page) {
 
 void is31fl3733_write_pwm_buffer(uint8_t index) {
     // Assumes page 1 is already selected.
-    // Transmit PWM registers in 12 transfers of 16 bytes.
-
-    // Iterate over the pwm_buffer contents at 16 byte intervals.
-    for (uint8_t i = 0; i < IS31FL3733_PWM_REGISTER_COUNT; i += 16) {
-#if IS31FL3733_I2C_PERSISTENCE > 0
-        for (uint8_t j = 0; j < IS31FL3733_I2C_PERSISTENCE; j++) {
-            if (i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer + i, 16, IS31FL3733_I2C_TIMEOUT) == I2C_STATUS_SUCCESS) break;
-        }
-#else
-        i2c_write_register(i2c_addresses[index] << 1, i, driver_buffers[index].pwm_buffer + i, 16, IS31FL3733_I2C_TIMEOUT);
-#endif
-    }
+    // Transmit only the 16 byte blocks of PWM registers which have changed,
+    // with adjacent blocks merged into a single transfer.
+    is31_dirty_blocks_write(i2c_addresses[index], 0, driver_buffers[index].pwm_buffer, driver_buffers[index].pwm_buffer_dirty, IS31FL3733_PWM_BLOCK_SIZE, IS31FL3733_I2C_TIMEOUT, IS31FL3733_I2C_PERSISTENCE);
 }
 
 void is31fl3733_init_drivers(void) {
@@ -211,7 +204,7 @@ void is31fl3733_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
         driver_buffers[led.driver].pwm_buffer[led.r] = red;
         driver_buffers[led.driver].pwm_buffer[led.g] = green;
         driver_buffers[led.driver].pwm_buffer[led.b] = blue;
-        driver_buffers[led.driver].pwm_buffer_dirty  = true;
+        driver_buffers[led.driver].pwm_buffer_dirty |= IS31_DIRTY_BLOCK(led.r, IS31FL3733_PWM_BLOCK_SIZE) | IS31_DIRTY_BLOCK(led.g, IS31FL3733_PWM_BLOCK_SIZE) | IS31_DIRTY_BLOCK(led.b, IS31FL3733_PWM_BLOCK_SIZE);
     }
 }
 
@@ -257,7 +250,7 @@ void is31fl3733_update_pwm_buffers(uint8_t index) {
 
         is31fl3733_write_pwm_buffer(index);
 
-        driver_buffers[index].pwm_buffer_dirty = false;
+        driver_buffers[index].pwm_buffer_dirty = 0;
     }
 }
 
@@ -21,6 +21,24 @@
 #    define SURFACE_NUM_DEVICES 1
 #endif
 
+#ifndef SURFACE_DIRTY_REGIONS
+/**
+ * @def This controls the number of separate dirty regions each surface tracks. Changes far apart from each other, such
+ *      as a clock and a layer indicator in opposite corners, are kept as separate regions and sent to the target
+ *      device separately, instead of as the one rectangle enclosing both. Each region requires 8 bytes of RAM.
+ */
+#    define SURFACE_DIRTY_REGIONS 4
+#endif
+
+#ifndef SURFACE_DIRTY_MERGE_DISTANCE
+/**
+ * @def Changes within this many pixels of an existing dirty region are merged into it, rather than starting another.
+ *      Each region costs a viewport command when drawn to the target, so merging nearby changes is cheaper than
+ *      sending them separately.
+ */
+#    define SURFACE_DIRTY_MERGE_DISTANCE 8
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Forward declarations
 
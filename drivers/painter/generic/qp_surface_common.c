@@ -5,6 +5,10 @@
 #include "qp_draw.h"
 #include "qp_surface_internal.h"
 
+#if SURFACE_DIRTY_REGIONS < 1 || SURFACE_DIRTY_REGIONS > 255
+#    error SURFACE_DIRTY_REGIONS must be between 1 and 255
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Driver storage
 
@@ -29,6 +33,51 @@ void qp_surface_increment_pixdata_location(surface_viewport_data_t *viewport) {
     }
 }
 
+static inline bool rect_contains(const surface_dirty_rect_t *rect, uint16_t x, uint16_t y) {
+    return x >= rect->l && x <= rect->r && y >= rect->t && y <= rect->b;
+}
+
+// Whether the rectangles are close enough together to be worth merging
+static inline bool rects_near(const surface_dirty_rect_t *a, const surface_dirty_rect_t *b) {
+    return a->l <= b->r + SURFACE_DIRTY_MERGE_DISTANCE && b->l <= a->r + SURFACE_DIRTY_MERGE_DISTANCE && a->t <= b->b + SURFACE_DIRTY_MERGE_DISTANCE && b->t <= a->b + SURFACE_DIRTY_MERGE_DISTANCE;
+}
+
+static inline void rect_extend(surface_dirty_rect_t *rect, const surface_dirty_rect_t *other) {
+    rect->l = QP_MIN(rect->l, other->l);
+    rect->t = QP_MIN(rect->t, other->t);
+    rect->r = QP_MAX(rect->r, other->r);
+    rect->b = QP_MAX(rect->b, other->b);
+}
+
+// The number of pixels a rectangle would grow by, if extended to cover the other
+static inline uint32_t rect_growth(const surface_dirty_rect_t *rect, const surface_dirty_rect_t *other) {
+    surface_dirty_rect_t extended = *rect;
+    rect_extend(&extended, other);
+    return (uint32_t)(extended.r - extended.l + 1) * (extended.b - extended.t + 1) - (uint32_t)(rect->r - rect->l + 1) * (rect->b - rect->t + 1);
+}
+
+// Folds any other regions which the given one has grown close to into it, so that regions never overlap
+static void merge_dirty_regions(surface_dirty_data_t *dirty, uint8_t index) {
+    uint8_t i = 0;
+    while (i < dirty->region_count) {
+        if (i == index || !rects_near(&dirty->regions[index], &dirty->regions[i])) {
+            i++;
+            continue;
+        }
+
+        rect_extend(&dirty->regions[index], &dirty->regions[i]);
+
+        // Move the last region into the gap, and start over as the extended region may now be near others
+        dirty->region_count--;
+        if (index == dirty->region_count) {
+            index = i;
+        }
+        dirty->regions[i] = dirty->regions[dirty->region_count];
+        i                 = 0;
+    }
+    dirty->last_region = index;
+}
+
 void qp_surface_update_dirty(surface_dirty_data_t *dirty, uint16_t x, uint16_t y) {
     // Maintain dirty region
     if (dirty->l > x) {
@@ -47,6 +96,41 @@ void qp_surface_update_dirty(surface_dirty_data_t *dirty, uint16_t x, uint16_t y
         dirty->b        = y;
         dirty->is_dirty = true;
     }
+
+    // Maintain the separate regions within it, checking the most recently extended region first
+    if (dirty->region_count > 0 && rect_contains(&dirty->regions[dirty->last_region], x, y)) {
+        return;
+    }
+
+    surface_dirty_rect_t pixel        = {.l = x, .t = y, .r = x, .b = y};
+    int16_t              best         = -1;
+    uint32_t             best_growth  = UINT32_MAX;
+    bool                 best_is_near = false;
+    for (uint8_t i = 0; i < dirty->region_count; i++) {
+        if (rect_contains(&dirty->regions[i], x, y)) {
+            dirty->last_region = i;
+            return;
+        }
+
+        // Prefer extending a nearby region, then whichever grows the least
+        bool     is_near = rects_near(&dirty->regions[i], &pixel);
+        uint32_t growth  = rect_growth(&dirty->regions[i], &pixel);
+        if ((is_near && !best_is_near) || (is_near == best_is_near && growth < best_growth)) {
+            best         = i;
+            best_growth  = growth;
+            best_is_near = is_near;
+        }
+    }
+
+    // Start a new region if there's nothing nearby to extend, and room for one
+    if (!best_is_near && dirty->region_count < SURFACE_DIRTY_REGIONS) {
+        dirty->regions[dirty->region_count] = pixel;
+        dirty->last_region                  = dirty->region_count++;
+        return;
+    }
+
+    rect_extend(&dirty->regions[best], &pixel);
+    merge_dirty_regions(dirty, best);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -57,11 +141,14 @@ bool qp_surface_init(painter_device_t device, painter_rotation_t rotation) {
     surface_painter_device_t *surface = (surface_painter_device_t *)driver;
     memset(surface->buffer, 0, SURFACE_REQUIRED_BUFFER_BYTE_SIZE(driver->panel_width, driver->panel_height, driver->native_bits_per_pixel));
 
-    surface->dirty.l        = 0;
-    surface->dirty.t        = 0;
-    surface->dirty.r        = surface->base.panel_width - 1;
-    surface->dirty.b        = surface->base.panel_height - 1;
-    surface->dirty.is_dirty = true;
+    surface->dirty.l            = 0;
+    surface->dirty.t            = 0;
+    surface->dirty.r            = surface->base.panel_width - 1;
+    surface->dirty.b            = surface->base.panel_height - 1;
+    surface->dirty.is_dirty     = true;
+    surface->dirty.regions[0]   = (surface_dirty_rect_t){.l = surface->dirty.l, .t = surface->dirty.t, .r = surface->dirty.r, .b = surface->dirty.b};
+    surface->dirty.region_count = 1;
+    surface->dirty.last_region  = 0;
 
     return true;
 }
@@ -83,6 +170,8 @@ bool qp_surface_flush(painter_device_t device) {
     surface->dirty.l = surface->dirty.t = UINT16_MAX;
     surface->dirty.r = surface->dirty.b = 0;
     surface->dirty.is_dirty             = false;
+    surface->dirty.region_count         = 0;
+    surface->dirty.last_region          = 0;
     return true;
 }
 
@@ -16,12 +16,24 @@ typedef struct surface_painter_driver_vtable_t {
     bool (*target_pixdata_transfer)(painter_driver_t *surface_driver, painter_driver_t *target_driver, uint16_t x, uint16_t y, bool entire_surface);
 } surface_painter_driver_vtable_t;
 
+typedef struct surface_dirty_rect_t {
+    uint16_t l;
+    uint16_t t;
+    uint16_t r;
+    uint16_t b;
+} surface_dirty_rect_t;
+
 typedef struct surface_dirty_data_t {
     bool     is_dirty;
     uint16_t l;
     uint16_t t;
     uint16_t r;
     uint16_t b;
+
+    // The dirty pixels, as up to SURFACE_DIRTY_REGIONS non-overlapping rectangles within the bounds above
+    uint8_t              region_count;
+    uint8_t              last_region; // most recently extended, as consecutive pixels tend to be close together
+    surface_dirty_rect_t regions[SURFACE_DIRTY_REGIONS];
 } surface_dirty_data_t;
 
 typedef struct surface_viewport_data_t {
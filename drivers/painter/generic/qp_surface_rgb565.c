@@ -4,6 +4,7 @@
 #ifdef QUANTUM_PAINTER_SURFACE_ENABLE
 
 #    include "color.h"
+#    include "qp_comms.h"
 #    include "qp_draw.h"
 #    include "qp_surface_internal.h"
 #    include "qp_comms_dummy.h"
@@ -68,23 +69,16 @@ static bool qp_surface_append_pixels_rgb565(painter_device_t device, uint8_t *ta
     return true;
 }
 
-static bool rgb565_target_pixdata_transfer(painter_driver_t *surface_driver, painter_driver_t *target_driver, uint16_t x, uint16_t y, bool entire_surface) {
-    surface_painter_device_t *surface_handle = (surface_painter_device_t *)surface_driver;
-
-    uint16_t l = entire_surface ? 0 : surface_handle->dirty.l;
-    uint16_t t = entire_surface ? 0 : surface_handle->dirty.t;
-    uint16_t r = entire_surface ? (surface_handle->base.panel_width - 1) : surface_handle->dirty.r;
-    uint16_t b = entire_surface ? (surface_handle->base.panel_height - 1) : surface_handle->dirty.b;
-
+static bool rgb565_target_pixdata_transfer_rect(surface_painter_device_t *surface_handle, painter_driver_t *target_driver, uint16_t x, uint16_t y, uint16_t l, uint16_t t, uint16_t r, uint16_t b) {
     // Set the target drawing area
-    bool ok = qp_viewport((painter_device_t)target_driver, x + l, y + t, x + r, y + b);
+    bool ok = target_driver->driver_vtable->viewport((painter_device_t)target_driver, x + l, y + t, x + r, y + b);
     if (!ok) {
         qp_dprintf("rgb565_target_pixdata_transfer: fail (could not set target viewport)\n");
         return false;
     }
 
     // Housekeeping of the amount of pixels to transfer
-    uint32_t  total_pixel_count = (8 * QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE) / surface_driver->native_bits_per_pixel;
+    uint32_t  total_pixel_count = (8 * QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE) / surface_handle->base.native_bits_per_pixel;
     uint32_t  pixel_counter     = 0;
     uint16_t *target_buffer     = (uint16_t *)qp_internal_global_pixdata_buffer;
 
@@ -96,20 +90,21 @@ static bool rgb565_target_pixdata_transfer(painter_driver_t *surface_driver, pai
 
             // If we've accumulated enough data, send it
             if (pixel_counter == total_pixel_count) {
-                ok = qp_pixdata((painter_device_t)target_driver, qp_internal_global_pixdata_buffer, pixel_counter);
+                ok = qp_internal_send_pixdata_and_swap((painter_device_t)target_driver, pixel_counter);
                 if (!ok) {
                     qp_dprintf("rgb565_target_pixdata_transfer: fail (could not stream pixdata to target)\n");
                     return false;
                 }
-                // Reset the counter
+                // Reset the counter, carrying on in whichever buffer is now current
                 pixel_counter = 0;
+                target_buffer = (uint16_t *)qp_internal_global_pixdata_buffer;
             }
         }
     }
 
     // If there's any leftover data, send it
     if (pixel_counter > 0) {
-        ok = qp_pixdata((painter_device_t)target_driver, qp_internal_global_pixdata_buffer, pixel_counter);
+        ok = qp_internal_send_pixdata_and_swap((painter_device_t)target_driver, pixel_counter);
         if (!ok) {
             qp_dprintf("rgb565_target_pixdata_transfer: fail (could not stream pixdata to target)\n");
             return false;
@@ -119,6 +114,30 @@ static bool rgb565_target_pixdata_transfer(painter_driver_t *surface_driver, pai
     return true;
 }
 
+static bool rgb565_target_pixdata_transfer(painter_driver_t *surface_driver, painter_driver_t *target_driver, uint16_t x, uint16_t y, bool entire_surface) {
+    surface_painter_device_t *surface_handle = (surface_painter_device_t *)surface_driver;
+
+    // Keep the target's comms running for the whole transfer, so that pixel data can be sent while the next is prepared
+    if (!qp_comms_start((painter_device_t)target_driver)) {
+        qp_dprintf("rgb565_target_pixdata_transfer: fail (could not start comms)\n");
+        return false;
+    }
+
+    bool ok = true;
+    if (entire_surface) {
+        ok = rgb565_target_pixdata_transfer_rect(surface_handle, target_driver, x, y, 0, 0, surface_handle->base.panel_width - 1, surface_handle->base.panel_height - 1);
+    } else {
+        // Send each dirty region separately, with its own viewport
+        for (uint8_t i = 0; ok && i < surface_handle->dirty.region_count; ++i) {
+            surface_dirty_rect_t *region = &surface_handle->dirty.regions[i];
+            ok                           = rgb565_target_pixdata_transfer_rect(surface_handle, target_driver, x, y, region->l, region->t, region->r, region->b);
+        }
+    }
+
+    qp_comms_stop((painter_device_t)target_driver);
+    return ok;
+}
+
 static bool qp_surface_append_pixdata_rgb565(painter_device_t device, uint8_t *target_buffer, uint32_t pixdata_offset, uint8_t pixdata_byte) {
     target_buffer[pixdata_offset] = pixdata_byte;
     return true;
@@ -93,6 +93,23 @@ spi_status_t spi_read(void);
  */
 spi_status_t spi_transmit(const uint8_t *data, uint16_t length);
 
+/**
+ * \brief Start sending multiple bytes to the selected SPI device, returning before they have been sent where the platform allows it.
+ *
+ * Waits for any previous asynchronous transmit to finish first. Other SPI operations must not be performed until `spi_transmit_async_wait()` has been called, other than `spi_stop()` which waits itself.
+ *
+ * \param data A pointer to the data to write from, which must not be modified until the transmit has finished.
+ * \param length The number of bytes to write. Take care not to overrun the length of `data`.
+ *
+ * \return `SPI_STATUS_ERROR` if an error occurs, otherwise `SPI_STATUS_SUCCESS`.
+ */
+spi_status_t spi_transmit_async(const uint8_t *data, uint16_t length);
+
+/**
+ * \brief Wait for the last `spi_transmit_async()` to finish.
+ */
+void spi_transmit_async_wait(void);
+
 /**
  * \brief Receive multiple bytes from the selected SPI device.
  *
@@ -136,6 +136,7 @@ class QFFUnicodeGlyphTableV1:
         self.header.length = len(self.glyphs.keys()) * 6
         self.header.write(fp)
 
+        # Quantum Painter binary searches the table, so glyphs must be written in code point order
         for n in sorted(self.glyphs.keys()):
             self.glyphs[n].write(fp, True)
 
@@ -171,6 +171,13 @@ spi_status_t spi_transmit(const uint8_t *data, uint16_t length) {
     return SPI_STATUS_SUCCESS;
 }
 
+spi_status_t spi_transmit_async(const uint8_t *data, uint16_t length) {
+    // No DMA, so this is the same as a blocking transmit
+    return spi_transmit(data, length);
+}
+
+void spi_transmit_async_wait(void) {}
+
 spi_status_t spi_receive(uint8_t *data, uint16_t length) {
     spi_status_t status;
 
@@ -440,6 +440,18 @@ spi_status_t spi_transmit(const uint8_t *data, uint16_t length) {
     return SPI_STATUS_SUCCESS;
 }
 
+spi_status_t spi_transmit_async(const uint8_t *data, uint16_t length) {
+    spi_transmit_async_wait();
+    spiStartSend(&SPI_DRIVER, length, data);
+    return SPI_STATUS_SUCCESS;
+}
+
+void spi_transmit_async_wait(void) {
+    // The driver goes back to ready from the transfer complete interrupt
+    while (*(volatile spistate_t *)&SPI_DRIVER.state == SPI_ACTIVE) {
+    }
+}
+
 spi_status_t spi_receive(uint8_t *data, uint16_t length) {
     spiReceive(&SPI_DRIVER, length, data);
     return SPI_STATUS_SUCCESS;
@@ -447,6 +459,7 @@ spi_status_t spi_receive(uint8_t *data, uint16_t length) {
 
 void spi_stop(void) {
     if (spiStarted) {
+        spi_transmit_async_wait();
         spi_unselect();
         spiStop(&SPI_DRIVER);
         spiStarted = false;
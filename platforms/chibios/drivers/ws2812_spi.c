@@ -2,6 +2,7 @@
 #include "gpio.h"
 #include "util.h"
 #include "chibios_config.h"
+#include <string.h>
 
 /* Adapted from https://github.com/gamazeps/ws2812b-chibios-SPIDMA/ */
 
@@ -113,59 +114,88 @@
 #define RESET_SIZE (1000 * WS2812_TRST_US / (2 * WS2812_TIMING))
 #define PREAMBLE_SIZE 4
 
-static uint8_t txbuf[PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE] = {0};
+#define TXBUF_SIZE (PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE)
+
+#if !defined(WS2812_SPI_USE_CIRCULAR_BUFFER) && !defined(WS2812_SPI_SYNC)
+#    define WS2812_SPI_ASYNC
+#endif
+
+// With a second buffer the next frame is encoded while the previous one is still being sent
+#if defined(WS2812_SPI_ASYNC) && defined(WS2812_SPI_DOUBLE_BUFFER)
+#    define TXBUF_COUNT 2
+#else
+#    define TXBUF_COUNT 1
+#endif
+
+static uint8_t txbufs[TXBUF_COUNT][TXBUF_SIZE] = {{0}};
+static uint8_t txbuf_index                     = 0;
+
+#ifdef WS2812_SPI_ASYNC
+static volatile bool spi_busy = false;
+
+static void spi_end_cb(SPIDriver* spip) {
+    (void)spip;
+    spi_busy = false;
+}
+
+static void spi_wait(void) {
+    while (spi_busy) {
+    }
+}
+#endif
 
 /*
  * As the trick here is to use the SPI to send a huge pattern of 0 and 1 to
- * the ws2812b protocol, we use this helper function to translate bytes into
- * 0s and 1s for the LED (with the appropriate timing).
+ * the ws2812b protocol, each LED bit is sent as 4 SPI bits with the
+ * appropriate timing: 0b1110 for a 1 and 0b1000 for a 0. This table holds
+ * the two SPI bytes for each nibble of LED data.
  */
-static uint8_t get_protocol_eq(uint8_t data, int pos) {
-    uint8_t eq = 0;
-    if (data & (1 << (2 * (3 - pos))))
-        eq = 0b1110;
-    else
-        eq = 0b1000;
-    if (data & (2 << (2 * (3 - pos))))
-        eq += 0b11100000;
-    else
-        eq += 0b10000000;
-    return eq;
+#define PROTOCOL_BIT(data, bit) ((data) & (1 << (bit)) ? 0b1110 : 0b1000)
+#define PROTOCOL_NIBBLE(n) {(PROTOCOL_BIT(n, 3) << 4) | PROTOCOL_BIT(n, 2), (PROTOCOL_BIT(n, 1) << 4) | PROTOCOL_BIT(n, 0)}
+
+static const uint8_t protocol_nibbles[16][2] = {
+    PROTOCOL_NIBBLE(0),  PROTOCOL_NIBBLE(1),  PROTOCOL_NIBBLE(2),  PROTOCOL_NIBBLE(3),  //
+    PROTOCOL_NIBBLE(4),  PROTOCOL_NIBBLE(5),  PROTOCOL_NIBBLE(6),  PROTOCOL_NIBBLE(7),  //
+    PROTOCOL_NIBBLE(8),  PROTOCOL_NIBBLE(9),  PROTOCOL_NIBBLE(10), PROTOCOL_NIBBLE(11), //
+    PROTOCOL_NIBBLE(12), PROTOCOL_NIBBLE(13), PROTOCOL_NIBBLE(14), PROTOCOL_NIBBLE(15), //
+};
+
+static inline void set_led_byte(uint8_t* dest, uint8_t data) {
+    const uint8_t* high = protocol_nibbles[data >> 4];
+    const uint8_t* low  = protocol_nibbles[data & 0x0F];
+
+    dest[0] = high[0];
+    dest[1] = high[1];
+    dest[2] = low[0];
+    dest[3] = low[1];
 }
 
-static void set_led_color_rgb(ws2812_led_t color, int pos) {
-    uint8_t* tx_start = &txbuf[PREAMBLE_SIZE];
+static void set_led_color_rgb(uint8_t* txbuf, ws2812_led_t color, int pos) {
+    uint8_t* tx_start = &txbuf[PREAMBLE_SIZE + BYTES_FOR_LED * pos];
 
 #if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.r, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.b, j);
+    set_led_byte(tx_start, color.g);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE, color.r);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE * 2, color.b);
 #elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.r, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.b, j);
+    set_led_byte(tx_start, color.r);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE, color.g);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE * 2, color.b);
 #elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + j] = get_protocol_eq(color.b, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE + j] = get_protocol_eq(color.g, j);
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 2 + j] = get_protocol_eq(color.r, j);
+    set_led_byte(tx_start, color.b);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE, color.g);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE * 2, color.r);
 #endif
 #ifdef WS2812_RGBW
-    for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 3 + j] = get_protocol_eq(color.w, j);
+    set_led_byte(tx_start + BYTES_FOR_LED_BYTE * 3, color.w);
 #endif
 }
 
 ws2812_led_t ws2812_leds[WS2812_LED_COUNT];
 
+// Set when ws2812_leds no longer matches the last frame sent
+static bool leds_dirty = true;
+
 void ws2812_init(void) {
     palSetLineMode(WS2812_DI_PIN, WS2812_MOSI_OUTPUT_MODE);
 
@@ -180,7 +210,11 @@ void ws2812_init(void) {
 #    if SPI_SUPPORTS_CIRCULAR == TRUE
         WS2812_SPI_BUFFER_MODE,
 #    endif
+#    ifdef WS2812_SPI_ASYNC
+        spi_end_cb, // end_cb
+#    else
         NULL, // end_cb
+#    endif
         PAL_PORT(WS2812_DI_PIN),
         PAL_PAD(WS2812_DI_PIN),
 #    if defined(WB32F3G71xx) || defined(WB32FQ95xx)
@@ -199,7 +233,11 @@ void ws2812_init(void) {
 #    if SPI_SUPPORTS_SLAVE_MODE == TRUE
         false,
 #    endif
+#    ifdef WS2812_SPI_ASYNC
+        spi_end_cb, // data_cb
+#    else
         NULL, // data_cb
+#    endif
         NULL, // error_cb
         PAL_PORT(WS2812_DI_PIN),
         PAL_PAD(WS2812_DI_PIN),
@@ -220,17 +258,20 @@ void ws2812_init(void) {
     spiStart(&WS2812_SPI_DRIVER, &spicfg); /* Setup transfer parameters.       */
     spiSelect(&WS2812_SPI_DRIVER);         /* Slave Select assertion.          */
 #ifdef WS2812_SPI_USE_CIRCULAR_BUFFER
-    spiStartSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
+    spiStartSend(&WS2812_SPI_DRIVER, TXBUF_SIZE, txbufs[0]);
 #endif
 }
 
 void ws2812_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
-    ws2812_leds[index].r = red;
-    ws2812_leds[index].g = green;
-    ws2812_leds[index].b = blue;
+    ws2812_led_t led = {.r = red, .g = green, .b = blue};
 #if defined(WS2812_RGBW)
-    ws2812_rgb_to_rgbw(&ws2812_leds[index]);
+    ws2812_rgb_to_rgbw(&led);
 #endif
+
+    if (memcmp(&ws2812_leds[index], &led, sizeof(led)) != 0) {
+        ws2812_leds[index] = led;
+        leds_dirty         = true;
+    }
 }
 
 void ws2812_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
@@ -240,17 +281,30 @@ void ws2812_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
 }
 
 void ws2812_flush(void) {
+    // The LEDs latch the last frame, so there is nothing to send if it hasn't changed
+    if (!leds_dirty) {
+        return;
+    }
+    leds_dirty = false;
+
+#if defined(WS2812_SPI_ASYNC) && TXBUF_COUNT == 1
+    // The buffer can't be rewritten while the previous frame is still being sent
+    spi_wait();
+#endif
+
+    uint8_t* txbuf = txbufs[txbuf_index];
     for (int i = 0; i < WS2812_LED_COUNT; i++) {
-        set_led_color_rgb(ws2812_leds[i], i);
+        set_led_color_rgb(txbuf, ws2812_leds[i], i);
     }
 
-    // Send async - each led takes ~0.03ms, 50 leds ~1.5ms, animations flushing faster than send will cause issues.
-    // Instead spiSend can be used to send synchronously (or the thread logic can be added back).
-#ifndef WS2812_SPI_USE_CIRCULAR_BUFFER
-#    ifdef WS2812_SPI_SYNC
-    spiSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
-#    else
-    spiStartSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
-#    endif
+    // Send async - each led takes ~0.03ms, 50 leds ~1.5ms, so the previous frame may still be in flight.
+    // Instead spiSend can be used to send synchronously.
+#if defined(WS2812_SPI_ASYNC)
+    spi_wait();
+    spi_busy = true;
+    spiStartSend(&WS2812_SPI_DRIVER, TXBUF_SIZE, txbuf);
+    txbuf_index = (txbuf_index + 1) % TXBUF_COUNT;
+#elif defined(WS2812_SPI_SYNC)
+    spiSend(&WS2812_SPI_DRIVER, TXBUF_SIZE, txbuf);
 #endif
 }
@@ -0,0 +1,109 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "i2c_master_mock.h"
+#include <string.h>
+
+uint8_t i2c_mock_registers[256];
+
+static i2c_mock_transaction_t log_entries[I2C_MOCK_LOG_SIZE];
+static uint16_t               log_count;
+static uint16_t               fail_count;
+static i2c_status_t           fail_status;
+
+void i2c_mock_reset(void) {
+    memset(i2c_mock_registers, 0, sizeof(i2c_mock_registers));
+    log_count  = 0;
+    fail_count = 0;
+}
+
+uint16_t i2c_mock_transaction_count(void) {
+    return log_count;
+}
+
+const i2c_mock_transaction_t* i2c_mock_transaction(uint16_t index) {
+    return index < log_count ? &log_entries[index] : NULL;
+}
+
+void i2c_mock_fail_next(uint16_t count, i2c_status_t status) {
+    fail_count  = count;
+    fail_status = status;
+}
+
+static i2c_status_t log_transaction(uint8_t address, bool read, const uint8_t* prefix, uint16_t prefix_length, const uint8_t* data, uint16_t length) {
+    i2c_status_t status = I2C_STATUS_SUCCESS;
+    if (fail_count > 0) {
+        fail_count--;
+        status = fail_status;
+    }
+
+    if (log_count < I2C_MOCK_LOG_SIZE) {
+        i2c_mock_transaction_t* entry = &log_entries[log_count++];
+        memset(entry, 0, sizeof(i2c_mock_transaction_t));
+        entry->address = address;
+        entry->read    = read;
+        entry->length  = prefix_length + length;
+        entry->status  = status;
+
+        uint16_t copied = prefix_length < I2C_MOCK_DATA_SIZE ? prefix_length : I2C_MOCK_DATA_SIZE;
+        if (prefix != NULL) {
+            memcpy(entry->data, prefix, copied);
+        }
+        if (data != NULL && copied < I2C_MOCK_DATA_SIZE) {
+            memcpy(&entry->data[copied], data, length < I2C_MOCK_DATA_SIZE - copied ? length : I2C_MOCK_DATA_SIZE - copied);
+        }
+    }
+    return status;
+}
+
+void i2c_init(void) {}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    return log_transaction(address, false, NULL, 0, data, length);
+}
+
+i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_status_t status = log_transaction(address, true, NULL, 0, NULL, length);
+    if (status == I2C_STATUS_SUCCESS) {
+        memset(data, 0, length);
+    }
+    return status;
+}
+
+i2c_status_t i2c_write_register(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_status_t status = log_transaction(devaddr, false, &regaddr, 1, data, length);
+    if (status == I2C_STATUS_SUCCESS) {
+        for (uint16_t i = 0; i < length; i++) {
+            i2c_mock_registers[(uint8_t)(regaddr + i)] = data[i];
+        }
+    }
+    return status;
+}
+
+i2c_status_t i2c_write_register16(uint8_t devaddr, uint16_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    uint8_t register_packet[2] = {regaddr >> 8, regaddr & 0xFF};
+    return log_transaction(devaddr, false, register_packet, 2, data, length);
+}
+
+i2c_status_t i2c_read_register(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_status_t status = log_transaction(devaddr, true, &regaddr, 1, NULL, length);
+    if (status == I2C_STATUS_SUCCESS) {
+        for (uint16_t i = 0; i < length; i++) {
+            data[i] = i2c_mock_registers[(uint8_t)(regaddr + i)];
+        }
+    }
+    return status;
+}
+
+i2c_status_t i2c_read_register16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    uint8_t      register_packet[2] = {regaddr >> 8, regaddr & 0xFF};
+    i2c_status_t status             = log_transaction(devaddr, true, register_packet, 2, NULL, length);
+    if (status == I2C_STATUS_SUCCESS) {
+        memset(data, 0, length);
+    }
+    return status;
+}
+
+i2c_status_t i2c_ping_address(uint8_t address, uint16_t timeout) {
+    return log_transaction(address, false, NULL, 0, NULL, 0);
+}
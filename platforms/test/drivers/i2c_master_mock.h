@@ -0,0 +1,43 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "i2c_master.h"
+
+/**
+ * \file
+ *
+ * Host side I2C bus for tests. Every transaction is logged in order, register reads are served from a single
+ * 256 byte register map shared by all devices, and failures can be injected.
+ */
+
+#ifndef I2C_MOCK_LOG_SIZE
+#    define I2C_MOCK_LOG_SIZE 64
+#endif
+
+#ifndef I2C_MOCK_DATA_SIZE
+#    define I2C_MOCK_DATA_SIZE 258
+#endif
+
+typedef struct i2c_mock_transaction_t {
+    uint8_t      address;
+    bool         read;
+    uint16_t     length;                   // bytes on the bus, including any register address
+    uint8_t      data[I2C_MOCK_DATA_SIZE]; // bytes written, starting with any register address
+    i2c_status_t status;
+} i2c_mock_transaction_t;
+
+extern uint8_t i2c_mock_registers[256];
+
+void i2c_mock_reset(void);
+
+uint16_t                      i2c_mock_transaction_count(void);
+const i2c_mock_transaction_t* i2c_mock_transaction(uint16_t index);
+
+/**
+ * \brief Makes the next `count` transactions fail with `status`.
+ */
+void i2c_mock_fail_next(uint16_t count, i2c_status_t status);
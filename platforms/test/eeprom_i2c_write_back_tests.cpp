@@ -0,0 +1,134 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+extern "C" {
+#include "eeprom.h"
+#include "eeprom_driver.h"
+#include "i2c_master_mock.h"
+
+void     simulate_async_tick(uint32_t t);
+uint32_t timer_read_internal(void);
+}
+
+using testing::ElementsAre;
+using testing::UnorderedElementsAre;
+
+class EepromI2CWriteBack : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        // Blocking waits spin on the timer, so let it move on every read
+        simulate_async_tick(1);
+        eeprom_driver_flush();
+        i2c_mock_reset();
+    }
+
+    static std::vector<uint8_t> sent(uint16_t index) {
+        const i2c_mock_transaction_t* transaction = i2c_mock_transaction(index);
+        return std::vector<uint8_t>(transaction->data, transaction->data + transaction->length);
+    }
+
+    static std::vector<uint8_t> read(uintptr_t address, size_t length) {
+        std::vector<uint8_t> buffer(length, 0xAA);
+        eeprom_read_block(buffer.data(), (const void*)address, length);
+        return buffer;
+    }
+
+    static void write(uintptr_t address, std::vector<uint8_t> data) {
+        eeprom_write_block(data.data(), (void*)address, data.size());
+    }
+};
+
+/**
+ * This test verifies that starting a new page neither reads the EEPROM nor waits for a write cycle in progress.
+ */
+TEST_F(EepromI2CWriteBack, StartingAPageDoesNotTouchTheBus) {
+    write(0x00, {1, 2, 3, 4});
+    EXPECT_EQ(i2c_mock_transaction_count(), 0);
+
+    eeprom_driver_task();
+    ASSERT_EQ(i2c_mock_transaction_count(), 1);
+    EXPECT_THAT(sent(0), ElementsAre(0x00, 0x00, 1, 2, 3, 4));
+
+    uint32_t now = timer_read_internal();
+    write(0x44, {5, 6});
+    EXPECT_EQ(i2c_mock_transaction_count(), 1);
+    EXPECT_EQ(timer_read_internal(), now) << "Nothing should have waited for the write cycle";
+}
+
+/**
+ * This test verifies that a read which buffered pages fully cover is served from RAM, even mid write cycle.
+ */
+TEST_F(EepromI2CWriteBack, BufferedReadsAreServedFromRam) {
+    write(0x00, {1, 2, 3, 4});
+    write(0x40, {5, 6, 7, 8});
+    write(0x5E, {9, 10, 11, 12}); // spans two pages
+    eeprom_driver_task();
+    ASSERT_EQ(i2c_mock_transaction_count(), 1);
+
+    uint32_t now = timer_read_internal();
+    EXPECT_THAT(read(0x41, 2), ElementsAre(6, 7));
+    EXPECT_THAT(read(0x5E, 4), ElementsAre(9, 10, 11, 12));
+    EXPECT_EQ(i2c_mock_transaction_count(), 1);
+    EXPECT_EQ(timer_read_internal(), now) << "Nothing should have waited for the write cycle";
+}
+
+/**
+ * This test verifies that a read which buffered pages only partly cover goes to the bus, and that what it read is
+ * kept for the next read of the same page.
+ */
+TEST_F(EepromI2CWriteBack, PartialReadsAreRememberedForTheNextRead) {
+    write(0x40, {5, 6});
+
+    EXPECT_THAT(read(0x40, 4), ElementsAre(5, 6, 0, 0));
+    ASSERT_EQ(i2c_mock_transaction_count(), 2);
+    EXPECT_THAT(sent(0), ElementsAre(0x00, 0x40));
+    EXPECT_TRUE(i2c_mock_transaction(1)->read);
+
+    // The read-modify-write of an update only needs the bus once
+    EXPECT_THAT(read(0x42, 2), ElementsAre(0, 0));
+    EXPECT_EQ(i2c_mock_transaction_count(), 2);
+}
+
+/**
+ * This test verifies that a gap between writes merged into the same page is filled from the EEPROM at write out,
+ * rather than from whatever the page buffer held before.
+ */
+TEST_F(EepromI2CWriteBack, GapsAreFilledFromTheEepromAtWriteOut) {
+    write(0x40, std::vector<uint8_t>(32, 0xFF));
+    eeprom_driver_flush();
+    i2c_mock_reset();
+
+    write(0x40, {1, 2});
+    write(0x46, {3, 4});
+    EXPECT_EQ(i2c_mock_transaction_count(), 0);
+
+    eeprom_driver_task();
+    ASSERT_EQ(i2c_mock_transaction_count(), 3);
+    EXPECT_THAT(sent(0), ElementsAre(0x00, 0x40));
+    EXPECT_TRUE(i2c_mock_transaction(1)->read);
+    EXPECT_EQ(i2c_mock_transaction(1)->length, 8);
+    EXPECT_THAT(sent(2), ElementsAre(0x00, 0x40, 1, 2, 0, 0, 0, 0, 3, 4));
+}
+
+/**
+ * This test verifies that a full journal makes room by writing out the buffered pages in turn.
+ */
+TEST_F(EepromI2CWriteBack, FullJournalWritesOutPagesInTurn) {
+    write(0x00, {1});
+    write(0x20, {2});
+    EXPECT_EQ(i2c_mock_transaction_count(), 0);
+
+    // Where the turn starts depends on earlier evictions, but the page just started must never be the next one out
+    write(0x40, {3});
+    write(0x60, {4});
+    ASSERT_EQ(i2c_mock_transaction_count(), 2);
+    EXPECT_THAT((std::vector<std::vector<uint8_t>>{sent(0), sent(1)}), UnorderedElementsAre(ElementsAre(0x00, 0x00, 1), ElementsAre(0x00, 0x20, 2)));
+
+    eeprom_driver_flush();
+    ASSERT_EQ(i2c_mock_transaction_count(), 4);
+    EXPECT_THAT((std::vector<std::vector<uint8_t>>{sent(2), sent(3)}), UnorderedElementsAre(ElementsAre(0x00, 0x40, 3), ElementsAre(0x00, 0x60, 4)));
+}
@@ -0,0 +1,237 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+extern "C" {
+#include "i2c_queue.h"
+#include "i2c_master_mock.h"
+}
+
+using testing::ElementsAre;
+using testing::ElementsAreArray;
+
+class I2CQueue : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        i2c_queue_flush();
+        i2c_mock_reset();
+        completions.clear();
+    }
+
+    struct completion_t {
+        i2c_status_t status;
+        int          id;
+    };
+
+    static std::vector<completion_t> completions;
+
+    static void record(i2c_status_t status, void* context) {
+        completions.push_back({status, (int)(intptr_t)context});
+    }
+
+    static void* id(int value) {
+        return (void*)(intptr_t)value;
+    }
+
+    static std::vector<uint8_t> sent(uint16_t index) {
+        const i2c_mock_transaction_t* transaction = i2c_mock_transaction(index);
+        return std::vector<uint8_t>(transaction->data, transaction->data + transaction->length);
+    }
+};
+
+std::vector<I2CQueue::completion_t> I2CQueue::completions;
+
+/**
+ * This test verifies that nothing reaches the bus until the queue is drained, and then everything does in order.
+ */
+TEST_F(I2CQueue, TransactionsRunInOrder) {
+    uint8_t payload[] = {0x11, 0x22};
+    uint8_t readback[2];
+    i2c_mock_registers[0x40] = 0xAB;
+    i2c_mock_registers[0x41] = 0xCD;
+
+    EXPECT_TRUE(i2c_queue_write_register(0x50, 0x10, payload, sizeof(payload), 100, record, id(1)));
+    EXPECT_TRUE(i2c_queue_read_register(0x52, 0x40, readback, sizeof(readback), 100, record, id(2)));
+    EXPECT_TRUE(i2c_queue_transmit(0x54, payload, 1, 100, record, id(3)));
+    EXPECT_EQ(i2c_queue_pending(), 3);
+    EXPECT_EQ(i2c_mock_transaction_count(), 0);
+
+    i2c_queue_flush();
+    EXPECT_EQ(i2c_queue_pending(), 0);
+
+    ASSERT_EQ(i2c_mock_transaction_count(), 3);
+    EXPECT_EQ(i2c_mock_transaction(0)->address, 0x50);
+    EXPECT_THAT(sent(0), ElementsAre(0x10, 0x11, 0x22));
+    EXPECT_EQ(i2c_mock_transaction(1)->address, 0x52);
+    EXPECT_TRUE(i2c_mock_transaction(1)->read);
+    EXPECT_THAT(readback, ElementsAre(0xAB, 0xCD));
+    EXPECT_EQ(i2c_mock_transaction(2)->address, 0x54);
+    EXPECT_THAT(sent(2), ElementsAre(0x11));
+
+    ASSERT_EQ(completions.size(), 3);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(completions[i].id, i + 1);
+        EXPECT_EQ(completions[i].status, I2C_STATUS_SUCCESS);
+    }
+}
+
+/**
+ * This test verifies that each task call runs at most I2C_QUEUE_TASK_TRANSACTIONS transactions.
+ */
+TEST_F(I2CQueue, TaskIsBounded) {
+    uint8_t value = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+        EXPECT_TRUE(i2c_queue_write_register(0x50, i, &value, 1, 100, NULL, NULL));
+    }
+
+    i2c_queue_task();
+    EXPECT_EQ(i2c_mock_transaction_count(), I2C_QUEUE_TASK_TRANSACTIONS);
+    i2c_queue_task();
+    EXPECT_EQ(i2c_mock_transaction_count(), 3);
+    EXPECT_EQ(i2c_queue_pending(), 0);
+}
+
+/**
+ * This test verifies that written data is copied, so the caller's buffer can be reused once the call returns.
+ */
+TEST_F(I2CQueue, WriteDataIsCopied) {
+    uint8_t buffer[4] = {1, 2, 3, 4};
+    EXPECT_TRUE(i2c_queue_transmit(0x50, buffer, sizeof(buffer), 100, NULL, NULL));
+    buffer[0] = 0xFF;
+
+    i2c_queue_flush();
+    EXPECT_THAT(sent(0), ElementsAre(1, 2, 3, 4));
+}
+
+/**
+ * This test verifies that a full queue rejects transactions until there is room again.
+ */
+TEST_F(I2CQueue, FullQueueAppliesBackPressure) {
+    uint8_t value = 0;
+    for (uint8_t i = 0; i < I2C_QUEUE_SIZE; i++) {
+        EXPECT_TRUE(i2c_queue_write_register(0x50, i, &value, 1, 100, NULL, NULL));
+    }
+    EXPECT_FALSE(i2c_queue_write_register(0x50, 0x80, &value, 1, 100, NULL, NULL)) << "The queue should be full";
+
+    i2c_queue_task();
+    EXPECT_TRUE(i2c_queue_write_register(0x50, 0x80, &value, 1, 100, NULL, NULL)) << "A task should have made room";
+
+    i2c_queue_flush();
+    EXPECT_EQ(i2c_mock_transaction_count(), I2C_QUEUE_SIZE + 1);
+    EXPECT_THAT(sent(I2C_QUEUE_SIZE), ElementsAre(0x80, 0));
+}
+
+/**
+ * This test verifies that running out of room for write data rejects transactions, and that the room wraps around.
+ */
+TEST_F(I2CQueue, FullDataPoolAppliesBackPressure) {
+    std::vector<uint8_t> block(I2C_QUEUE_DATA_SIZE / 2, 0x5A);
+    EXPECT_TRUE(i2c_queue_transmit(0x50, block.data(), block.size(), 100, NULL, NULL));
+    EXPECT_TRUE(i2c_queue_transmit(0x50, block.data(), block.size(), 100, NULL, NULL));
+    EXPECT_FALSE(i2c_queue_transmit(0x50, block.data(), 1, 100, NULL, NULL)) << "The data pool should be full";
+
+    uint8_t readback;
+    EXPECT_TRUE(i2c_queue_receive(0x50, &readback, 1, 100, NULL, NULL)) << "Reads don't need room in the data pool";
+
+    i2c_queue_task();
+    block.assign(block.size() - 1, 0xA5);
+    EXPECT_TRUE(i2c_queue_transmit(0x50, block.data(), block.size(), 100, NULL, NULL)) << "The first block should have been freed";
+
+    i2c_queue_flush();
+    ASSERT_EQ(i2c_mock_transaction_count(), 4);
+    EXPECT_THAT(sent(3), ElementsAreArray(block));
+}
+
+/**
+ * This test verifies that burst writes to adjacent registers of the same device are sent as a single transfer.
+ */
+TEST_F(I2CQueue, AdjacentBurstWritesAreMerged) {
+    std::vector<uint8_t> pwm(192);
+    for (size_t i = 0; i < pwm.size(); i++) {
+        pwm[i] = i;
+    }
+
+    // Twelve blocks of 16 registers, more than the queue could hold as separate transactions
+    for (uint8_t i = 0; i < 192; i += 16) {
+        EXPECT_TRUE(i2c_queue_write_register_burst(0x50, i, &pwm[i], 16, 100, NULL, NULL));
+    }
+    EXPECT_EQ(i2c_queue_pending(), 1);
+
+    i2c_queue_flush();
+    ASSERT_EQ(i2c_mock_transaction_count(), 1);
+    EXPECT_EQ(i2c_mock_transaction(0)->length, 193);
+    EXPECT_THAT(std::vector<uint8_t>(i2c_mock_registers, i2c_mock_registers + 192), ElementsAreArray(pwm));
+}
+
+/**
+ * This test verifies that writes which can't be merged are kept apart.
+ */
+TEST_F(I2CQueue, UnrelatedWritesAreNotMerged) {
+    uint8_t data[2] = {0};
+
+    EXPECT_TRUE(i2c_queue_write_register_burst(0x50, 0x00, data, 2, 100, NULL, NULL));
+    EXPECT_TRUE(i2c_queue_write_register_burst(0x50, 0x04, data, 2, 100, NULL, NULL)); // gap
+    EXPECT_TRUE(i2c_queue_write_register_burst(0x52, 0x06, data, 2, 100, NULL, NULL)); // other device
+    EXPECT_TRUE(i2c_queue_write_register(0x52, 0x08, data, 2, 100, NULL, NULL));       // not a burst write
+    EXPECT_EQ(i2c_queue_pending(), 4);
+
+    i2c_queue_flush();
+    EXPECT_EQ(i2c_mock_transaction_count(), 4);
+}
+
+/**
+ * This test verifies that a merged write completes through the callback of the last write merged into it, and
+ * that nothing is merged into a write which already has a callback.
+ */
+TEST_F(I2CQueue, MergedWritesCompleteOnce) {
+    uint8_t data[2] = {0};
+
+    EXPECT_TRUE(i2c_queue_write_register_burst(0x50, 0x00, data, 2, 100, NULL, NULL));
+    EXPECT_TRUE(i2c_queue_write_register_burst(0x50, 0x02, data, 2, 100, record, id(1)));
+    EXPECT_TRUE(i2c_queue_write_register_burst(0x50, 0x04, data, 2, 100, record, id(2)));
+    EXPECT_EQ(i2c_queue_pending(), 2);
+
+    i2c_queue_flush();
+    ASSERT_EQ(i2c_mock_transaction_count(), 2);
+    EXPECT_EQ(i2c_mock_transaction(0)->length, 5);
+    ASSERT_EQ(completions.size(), 2);
+    EXPECT_EQ(completions[0].id, 1);
+    EXPECT_EQ(completions[1].id, 2);
+}
+
+/**
+ * This test verifies that failures are reported to the callback, and don't hold up the rest of the queue.
+ */
+TEST_F(I2CQueue, FailuresAreReported) {
+    uint8_t value = 0;
+    i2c_mock_fail_next(1, I2C_STATUS_TIMEOUT);
+
+    EXPECT_TRUE(i2c_queue_write_register(0x50, 0x00, &value, 1, 100, record, id(1)));
+    EXPECT_TRUE(i2c_queue_write_register(0x50, 0x01, &value, 1, 100, record, id(2)));
+    i2c_queue_flush();
+
+    ASSERT_EQ(completions.size(), 2);
+    EXPECT_EQ(completions[0].status, I2C_STATUS_TIMEOUT);
+    EXPECT_EQ(completions[1].status, I2C_STATUS_SUCCESS);
+}
+
+/**
+ * This test verifies that a callback can queue a follow up transaction, which runs after those already queued.
+ */
+TEST_F(I2CQueue, CallbacksCanQueueTransactions) {
+    static uint8_t value = 0x42;
+
+    i2c_queue_callback_t follow_up = [](i2c_status_t status, void* context) {
+        EXPECT_TRUE(i2c_queue_write_register(0x50, 0x02, &value, 1, 100, NULL, NULL));
+    };
+    EXPECT_TRUE(i2c_queue_write_register(0x50, 0x00, &value, 1, 100, follow_up, NULL));
+    EXPECT_TRUE(i2c_queue_write_register(0x50, 0x01, &value, 1, 100, NULL, NULL));
+    i2c_queue_flush();
+
+    ASSERT_EQ(i2c_mock_transaction_count(), 3);
+    EXPECT_THAT(sent(1), ElementsAre(0x01, 0x42));
+    EXPECT_THAT(sent(2), ElementsAre(0x02, 0x42));
+}
@@ -23,3 +23,27 @@ eeprom_legacy_emulated_flash_SRC := \
 	$(PLATFORM_PATH)/chibios/drivers/eeprom/eeprom_legacy_emulated_flash.c
 eeprom_legacy_emulated_flash_tiny_SRC := $(eeprom_legacy_emulated_flash_SRC)
 eeprom_legacy_emulated_flash_large_SRC := $(eeprom_legacy_emulated_flash_SRC)
+
+i2c_queue_DEFS := -DI2C_QUEUE_SIZE=4 -DI2C_QUEUE_DATA_SIZE=256 -DI2C_QUEUE_TASK_TRANSACTIONS=2
+i2c_queue_INC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/drivers/
+i2c_queue_SRC := \
+	$(TOP_DIR)/drivers/i2c_queue.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/drivers/i2c_master.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/i2c_queue_tests.cpp
+
+eeprom_i2c_write_back_DEFS := \
+	-DEEPROM_I2C \
+	-DEXTERNAL_EEPROM_WRITE_BACK \
+	-DEXTERNAL_EEPROM_WRITE_BACK_PAGES=2 \
+	-DEXTERNAL_EEPROM_PAGE_SIZE=32 \
+	-DEXTERNAL_EEPROM_WRITE_TIME=5
+eeprom_i2c_write_back_INC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/drivers/ \
+	$(TOP_DIR)/drivers/eeprom/
+eeprom_i2c_write_back_SRC := \
+	$(TOP_DIR)/drivers/eeprom/eeprom_i2c.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/drivers/i2c_master.c \
+	$(PLATFORM_PATH)/timer.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/eeprom_i2c_write_back_tests.cpp
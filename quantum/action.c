@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "wait.h"
 #include "qmk_settings.h"
 #include "keycode_config.h"
+#include "keymap_introspection.h"
 #include "debug.h"
 #include "quantum.h"
 
@@ -72,6 +73,121 @@ __attribute__((weak)) bool get_retro_tapping(uint16_t keycode, keyrecord_t *reco
 }
 #endif
 
+#ifdef KEY_FAST_PATH
+#    if defined(NO_ACTION_TAPPING) || defined(COMBO_ENABLE) || defined(KEY_OVERRIDE_ENABLE) || defined(TAP_DANCE_ENABLE) || defined(AUTO_SHIFT_ENABLE) || defined(CAPS_WORD_ENABLE) || defined(LEADER_ENABLE) || defined(REPEAT_KEY_ENABLE) || defined(DYNAMIC_MACRO_ENABLE) || defined(KEY_LOCK_ENABLE) || defined(SECURE_ENABLE) || defined(AUTOCORRECT_ENABLE) || defined(SEQUENCER_ENABLE) || defined(STENO_ENABLE) || defined(AUDIO_ENABLE) || defined(HAPTIC_ENABLE) || defined(LAYER_LOCK_ENABLE) || defined(COMMUNITY_MODULES_ENABLE) || defined(FLOW_TAP_TERM) || defined(POINTING_DEVICE_AUTO_MOUSE_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))
+#        error "KEY_FAST_PATH cannot be used together with features that need to see every key event, see docs/config_options.md"
+#    endif
+
+/* Positions whose keycode is a basic keycode, KC_NO or KC_TRNS on every layer,
+ * resolved lazily and dropped whenever the keymap changes. */
+static matrix_row_t fast_path_known[MATRIX_ROWS];
+static matrix_row_t fast_path_keys[MATRIX_ROWS];
+/* Keys whose press took the fast path, so that their release does too. */
+static matrix_row_t fast_path_pressed[MATRIX_ROWS];
+
+__attribute__((weak)) bool is_fast_path_key_user(keypos_t key) {
+    return false;
+}
+
+__attribute__((weak)) bool is_fast_path_key_kb(keypos_t key) {
+    return is_fast_path_key_user(key);
+}
+
+/** \brief Key fast path invalidate
+ *
+ * Discards the classification of every position, e.g. after a bulk keymap write.
+ */
+void key_fast_path_invalidate(void) {
+    memset(fast_path_known, 0, sizeof(fast_path_known));
+}
+
+/** \brief Key fast path invalidate key
+ *
+ * Discards the classification of a single position, e.g. after a keycode on
+ * any layer has been changed for that position.
+ */
+void key_fast_path_invalidate_key(keypos_t key) {
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        fast_path_known[key.row] &= ~(MATRIX_ROW_SHIFTER << key.col);
+    }
+}
+
+static bool is_fast_path_key(keypos_t key) {
+    const matrix_row_t col_mask = MATRIX_ROW_SHIFTER << key.col;
+
+    if (!(fast_path_known[key.row] & col_mask)) {
+        bool trivial = is_fast_path_key_kb(key);
+        for (uint8_t layer = 0; trivial && layer < keymap_layer_count(); layer++) {
+            uint16_t keycode = keymap_key_to_keycode(layer, key);
+            trivial          = keycode == KC_NO || keycode == KC_TRANSPARENT || IS_BASIC_KEYCODE(keycode);
+        }
+        if (trivial) {
+            fast_path_keys[key.row] |= col_mask;
+        } else {
+            fast_path_keys[key.row] &= ~col_mask;
+        }
+        fast_path_known[key.row] |= col_mask;
+    }
+    return fast_path_keys[key.row] & col_mask;
+}
+
+/** \brief Key fast path
+ *
+ * Sends plain keys straight to the report, skipping the tapping queue and the
+ * process_record chain, when nothing stateful could be affected by them.
+ *
+ * \return true if the event has been handled
+ */
+static bool key_fast_path(keyevent_t event) {
+    if (!IS_KEYEVENT(event) || event.key.row >= MATRIX_ROWS || event.key.col >= MATRIX_COLS) {
+        return false;
+    }
+
+    const matrix_row_t col_mask = MATRIX_ROW_SHIFTER << event.key.col;
+    if (event.pressed) {
+        if (!is_fast_path_key(event.key) || !action_tapping_is_idle()) {
+            return false;
+        }
+#    ifndef NO_ACTION_ONESHOT
+        if (get_oneshot_mods() || is_oneshot_layer_active()) {
+            return false;
+        }
+#    endif
+        fast_path_pressed[event.key.row] |= col_mask;
+    } else if (fast_path_pressed[event.key.row] & col_mask) {
+        fast_path_pressed[event.key.row] &= ~col_mask;
+    } else {
+        return false;
+    }
+
+    uint16_t keycode = get_event_keycode(event, true);
+#    ifdef RGBLIGHT_ENABLE
+    if (event.pressed) {
+        preprocess_rgblight();
+    }
+#    endif
+#    ifdef WPM_ENABLE
+    if (event.pressed) {
+        update_wpm(keycode);
+    }
+#    endif
+#    ifdef SPACE_CADET_ENABLE
+    // Any other key press turns a held Space Cadet key into a plain modifier
+    if (event.pressed) {
+        reset_space_cadet();
+    }
+#    endif
+
+    keycode = keycode_config(keycode);
+    if (event.pressed) {
+        register_code(keycode);
+    } else {
+        unregister_code(keycode);
+    }
+    return true;
+}
+#endif
+
 /** \brief Called to execute an action.
  *
  * FIXME: Needs documentation.
@@ -125,6 +241,12 @@ if (QS_oneshot_timeout > 0) {
     }
 #endif
 
+#ifdef KEY_FAST_PATH
+    if (key_fast_path(event)) {
+        return;
+    }
+#endif
+
 #ifndef NO_ACTION_TAPPING
 #    if defined(AUTO_SHIFT_ENABLE) && defined(RETRO_SHIFT)
     if (event.pressed) {
@@ -65,6 +65,16 @@ action_t action_for_keycode(uint16_t keycode);
 /* keyboard-specific key event (pre)processing */
 bool process_record_quantum(keyrecord_t *record);
 
+#ifdef KEY_FAST_PATH
+/* whether a position may bypass the tapping queue and process_record chain */
+bool is_fast_path_key_kb(keypos_t key);
+bool is_fast_path_key_user(keypos_t key);
+
+/* drop the fast path classification, after keymap changes */
+void key_fast_path_invalidate(void);
+void key_fast_path_invalidate_key(keypos_t key);
+#endif
+
 /* Utilities for actions.  */
 #if !defined(NO_ACTION_LAYER) && !defined(STRICT_LAYER_RELEASE)
 extern bool disable_action_cache;
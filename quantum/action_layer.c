@@ -1,5 +1,6 @@
 #include <limits.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "keyboard.h"
 #include "action.h"
@@ -347,16 +348,16 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
 #endif
 }
 
-/** \brief Layer switch get layer
+#ifndef NO_ACTION_LAYER
+/** \brief Layer walk
  *
- * Gets the layer based on key info
+ * Walks the active layers from the top down and returns the first one that
+ * does not map the key to KC_TRANSPARENT.
  */
-uint8_t layer_switch_get_layer(keypos_t key) {
-#ifndef NO_ACTION_LAYER
+static uint8_t layer_switch_walk_layers(layer_state_t layers, keypos_t key) {
     action_t action;
     action.code = ACTION_TRANSPARENT;
 
-    layer_state_t layers = layer_state | default_layer_state;
     /* check top layer first */
     for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
         if (layers & ((layer_state_t)1 << i)) {
@@ -368,6 +369,69 @@ uint8_t layer_switch_get_layer(keypos_t key) {
     }
     /* fall back to layer 0 */
     return 0;
+}
+#endif
+
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+#    define LAYER_LOOKUP_CACHE_INVALID 0xFF
+
+/** \brief resolved layer lookup cache
+ *
+ * Holds the topmost non-transparent layer for every matrix position. Entries
+ * are filled lazily on first lookup, and the whole table is discarded whenever
+ * the combined layer state differs from the one it was resolved against.
+ */
+static uint8_t       layer_lookup_cache[MATRIX_ROWS][MATRIX_COLS];
+static layer_state_t layer_lookup_cache_state;
+static bool          layer_lookup_cache_stale = true;
+
+/** \brief Layer lookup cache invalidate
+ *
+ * Discards every cached entry, e.g. after a bulk keymap write.
+ */
+void layer_lookup_cache_invalidate(void) {
+    layer_lookup_cache_stale = true;
+}
+
+/** \brief Layer lookup cache invalidate key
+ *
+ * Discards the cached entry for a single matrix position, e.g. after a keycode
+ * on any layer has been changed for that position.
+ */
+void layer_lookup_cache_invalidate_key(keypos_t key) {
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        layer_lookup_cache[key.row][key.col] = LAYER_LOOKUP_CACHE_INVALID;
+    }
+}
+
+static uint8_t layer_lookup_cache_get(layer_state_t layers, keypos_t key) {
+    if (layer_lookup_cache_stale || layers != layer_lookup_cache_state) {
+        memset(layer_lookup_cache, LAYER_LOOKUP_CACHE_INVALID, sizeof(layer_lookup_cache));
+        layer_lookup_cache_state = layers;
+        layer_lookup_cache_stale = false;
+    }
+
+    uint8_t *entry = &layer_lookup_cache[key.row][key.col];
+    if (*entry == LAYER_LOOKUP_CACHE_INVALID) {
+        *entry = layer_switch_walk_layers(layers, key);
+    }
+    return *entry;
+}
+#endif
+
+/** \brief Layer switch get layer
+ *
+ * Gets the layer based on key info
+ */
+uint8_t layer_switch_get_layer(keypos_t key) {
+#ifndef NO_ACTION_LAYER
+    layer_state_t layers = layer_state | default_layer_state;
+#    ifdef LAYER_LOOKUP_CACHE
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        return layer_lookup_cache_get(layers, key);
+    }
+#    endif
+    return layer_switch_walk_layers(layers, key);
 #else
     return get_highest_layer(default_layer_state);
 #endif
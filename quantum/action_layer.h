@@ -169,5 +169,11 @@ action_t store_or_get_action(bool pressed, keypos_t key);
 /* return the topmost non-transparent layer currently associated with key */
 uint8_t layer_switch_get_layer(keypos_t key);
 
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+/* drop resolved layers cached by layer_switch_get_layer, after keymap changes */
+void layer_lookup_cache_invalidate(void);
+void layer_lookup_cache_invalidate_key(keypos_t key);
+#endif
+
 /* return action depending on current layer status */
 action_t layer_switch_get_action(keypos_t key);
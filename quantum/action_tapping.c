@@ -124,6 +124,15 @@ static void waiting_buffer_scan_tap(void);
 static void debug_tapping_key(void);
 static void debug_waiting_buffer(void);
 
+/** \brief Action Tapping Idle
+ *
+ * True when no tap-hold key is being resolved and no events are waiting, so
+ * a new event can be processed without affecting tapping.
+ */
+bool action_tapping_is_idle(void) {
+    return !IS_EVENT(tapping_key.event) && waiting_buffer_head == waiting_buffer_tail;
+}
+
 /** \brief Action Tapping Process
  *
  * FIXME: Needs doc
@@ -0,0 +1,147 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+Symmetric per-key algorithm, behaving like sym_defer_pk, that only tracks the keys which are bouncing.
+Each changed key gets an entry in a small active set, and a row bitmask of tracked keys lets unchanged rows
+be skipped without looking at their columns. The cost of a scan follows the number of bouncing keys rather
+than the size of the matrix.
+If more than DEBOUNCE_ACTIVE_KEYS keys are bouncing at once, the others start as soon as entries free up.
+*/
+
+#include "debounce.h"
+#include "timer.h"
+#include <string.h>
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+#ifndef DEBOUNCE_ACTIVE_KEYS
+#    define DEBOUNCE_ACTIVE_KEYS 16
+#endif
+
+#if DEBOUNCE_ACTIVE_KEYS > UINT8_MAX
+#    error DEBOUNCE_ACTIVE_KEYS must not exceed 255
+#endif
+
+#define ROW_SHIFTER ((matrix_row_t)1)
+
+typedef struct {
+    uint8_t row;
+    uint8_t col;
+    uint8_t remaining;
+} debounce_active_key_t;
+
+#if DEBOUNCE > 0
+static debounce_active_key_t active_keys[DEBOUNCE_ACTIVE_KEYS];
+static uint8_t               active_count;
+static matrix_row_t          active_mask[MATRIX_ROWS];
+static bool                  active_overflowed;
+static fast_timer_t          last_time;
+static bool                  cooked_changed;
+
+static void update_active_keys_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t elapsed_time);
+static void start_active_keys(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    active_count      = 0;
+    active_overflowed = false;
+    memset(active_mask, 0, sizeof(active_mask));
+}
+
+void debounce_free(void) {
+    active_count = 0;
+}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool updated_last = false;
+    cooked_changed    = false;
+
+    if (active_count > 0) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+        if (elapsed_time > UINT8_MAX) {
+            elapsed_time = UINT8_MAX;
+        }
+
+        if (elapsed_time > 0) {
+            update_active_keys_and_transfer_if_expired(raw, cooked, elapsed_time);
+        }
+    }
+
+    // Keys left out of a full active set are picked up on the following scans
+    if (changed || active_overflowed) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        start_active_keys(raw, cooked, num_rows);
+    }
+
+    return cooked_changed;
+}
+
+static void update_active_keys_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t elapsed_time) {
+    uint8_t i = 0;
+    while (i < active_count) {
+        debounce_active_key_t *key = &active_keys[i];
+        if (key->remaining <= elapsed_time) {
+            matrix_row_t col_mask    = ROW_SHIFTER << key->col;
+            matrix_row_t cooked_next = (cooked[key->row] & ~col_mask) | (raw[key->row] & col_mask);
+            cooked_changed |= cooked[key->row] ^ cooked_next;
+            cooked[key->row] = cooked_next;
+            active_mask[key->row] &= ~col_mask;
+            active_keys[i] = active_keys[--active_count];
+        } else {
+            key->remaining -= elapsed_time;
+            i++;
+        }
+    }
+}
+
+static void start_active_keys(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    // Drop keys which have returned to their debounced state
+    uint8_t i = 0;
+    while (i < active_count) {
+        debounce_active_key_t *key      = &active_keys[i];
+        matrix_row_t           col_mask = ROW_SHIFTER << key->col;
+        if ((raw[key->row] ^ cooked[key->row]) & col_mask) {
+            i++;
+        } else {
+            active_mask[key->row] &= ~col_mask;
+            active_keys[i] = active_keys[--active_count];
+        }
+    }
+
+    active_overflowed = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t started = (raw[row] ^ cooked[row]) & ~active_mask[row];
+        while (started) {
+            if (active_count == DEBOUNCE_ACTIVE_KEYS) {
+                active_overflowed = true;
+                return;
+            }
+
+            uint8_t col = __builtin_ctzl((unsigned long)started);
+            started &= started - 1;
+
+            active_keys[active_count++] = (debounce_active_key_t){.row = row, .col = col, .remaining = DEBOUNCE};
+            active_mask[row] |= ROW_SHIFTER << col;
+        }
+    }
+}
+
+#else
+#    include "none.c"
+#endif
@@ -18,10 +18,12 @@
 #include "dynamic_keymap.h"
 #include "keymap_introspection.h"
 #include "action.h"
+#include "action_layer.h"
 #include "send_string.h"
 #include "keycodes.h"
 #include "action_tapping.h"
 #include "wait.h"
+#include "util.h"
 #include <string.h>
 
 #include "qmk_settings.h"
@@ -41,6 +43,25 @@
 #    define DYNAMIC_KEYMAP_MACRO_DELAY TAP_CODE_DELAY
 #endif
 
+#ifdef DYNAMIC_KEYMAP_MACRO_ASYNC
+#    ifndef DEFERRED_EXEC_ENABLE
+#        error "DYNAMIC_KEYMAP_MACRO_ASYNC requires DEFERRED_EXEC_ENABLE = yes"
+#    endif
+#    include "deferred_exec.h"
+
+#    ifndef DYNAMIC_KEYMAP_MACRO_QUEUE_SIZE
+#        define DYNAMIC_KEYMAP_MACRO_QUEUE_SIZE 4
+#    endif
+
+#    ifndef DYNAMIC_KEYMAP_MACRO_HELD_KEYS
+#        define DYNAMIC_KEYMAP_MACRO_HELD_KEYS 8
+#    endif
+#endif
+
+void dynamic_keymap_init(void) {
+    nvm_dynamic_keymap_init();
+}
+
 uint8_t dynamic_keymap_get_layer_count(void) {
     return DYNAMIC_KEYMAP_LAYER_COUNT;
 }
@@ -51,6 +72,15 @@ uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column)
 
 void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
     nvm_dynamic_keymap_update_keycode(layer, row, column, keycode);
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+    layer_lookup_cache_invalidate_key(MAKE_KEYPOS(row, column));
+#endif
+#ifdef KEY_FAST_PATH
+    key_fast_path_invalidate_key(MAKE_KEYPOS(row, column));
+#endif
+#ifdef MATRIX_HAS_GHOST
+    matrix_ghost_invalidate();
+#endif
 }
 
 #ifdef ENCODER_MAP_ENABLE
@@ -189,6 +219,15 @@ void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
 
 void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
     nvm_dynamic_keymap_update_buffer(offset, size, data);
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+    layer_lookup_cache_invalidate();
+#endif
+#ifdef KEY_FAST_PATH
+    key_fast_path_invalidate();
+#endif
+#ifdef MATRIX_HAS_GHOST
+    matrix_ghost_invalidate();
+#endif
 }
 
 uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
@@ -219,8 +258,57 @@ void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *da
     nvm_dynamic_keymap_macro_read_buffer(offset, size, data);
 }
 
+// Start of each macro in the buffer, found in one pass over the buffer rather
+// than by counting terminators every time a macro is sent.
+#define MACRO_OFFSET_NONE 0xFFFF
+
+static uint16_t macro_offsets[DYNAMIC_KEYMAP_MACRO_COUNT];
+static bool     macro_offsets_valid = false;
+
+static void macro_offsets_build(void) {
+    uint32_t size = nvm_dynamic_keymap_macro_size();
+    uint8_t  chunk[32];
+
+    macro_offsets_valid = true;
+    memset(macro_offsets, 0xFF, sizeof(macro_offsets));
+
+    // Check the last byte of the buffer.
+    // If it's not zero, then we are in the middle
+    // of buffer writing, possibly an aborted buffer
+    // write. So no macros can be sent until it completes.
+    nvm_dynamic_keymap_macro_read_buffer(size - 1, 1, chunk);
+    if (chunk[0] != 0) {
+        return;
+    }
+
+    uint8_t id       = 0;
+    macro_offsets[0] = 0;
+    for (uint32_t offset = 0; offset < size && id < DYNAMIC_KEYMAP_MACRO_COUNT - 1; offset += sizeof(chunk)) {
+        uint32_t length = MIN(sizeof(chunk), size - offset);
+        nvm_dynamic_keymap_macro_read_buffer(offset, length, chunk);
+        for (uint32_t i = 0; i < length && id < DYNAMIC_KEYMAP_MACRO_COUNT - 1; i++) {
+            // A terminator in the last byte is not followed by another macro
+            if (chunk[i] == 0 && offset + i + 1 < size) {
+                macro_offsets[++id] = offset + i + 1;
+            }
+        }
+    }
+}
+
 void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
+#ifdef DYNAMIC_KEYMAP_MACRO_ASYNC
+    // The offsets being played would no longer match the buffer
+    dynamic_keymap_macro_cancel();
+#endif
     nvm_dynamic_keymap_macro_update_buffer(offset, size, data);
+
+    // Writes end by clearing the last byte of the buffer, so index the macros
+    // then rather than on the next send
+    if ((uint32_t)offset + size >= nvm_dynamic_keymap_macro_size()) {
+        macro_offsets_build();
+    } else {
+        macro_offsets_valid = false;
+    }
 }
 
 static uint8_t dynamic_keymap_read_byte(uint32_t offset) {
@@ -230,9 +318,13 @@ static uint8_t dynamic_keymap_read_byte(uint32_t offset) {
 }
 
 void dynamic_keymap_macro_reset(void) {
+#ifdef DYNAMIC_KEYMAP_MACRO_ASYNC
+    dynamic_keymap_macro_cancel();
+#endif
     // Erase the macros, if necessary.
     nvm_dynamic_keymap_macro_erase();
     nvm_dynamic_keymap_macro_reset();
+    macro_offsets_valid = false;
 }
 
 static uint16_t decode_keycode(uint16_t kc) {
@@ -242,92 +334,345 @@ static uint16_t decode_keycode(uint16_t kc) {
     return kc;
 }
 
-void dynamic_keymap_macro_send(uint8_t id) {
-    if (id >= DYNAMIC_KEYMAP_MACRO_COUNT) {
+typedef enum {
+    MACRO_STEP_WAIT,
+    MACRO_STEP_REGISTER,
+    MACRO_STEP_UNREGISTER,
+    MACRO_STEP_VIAL_DOWN,
+    MACRO_STEP_VIAL_UP,
+    MACRO_STEP_SEND_CHAR,
+} macro_step_action_t;
+
+typedef struct {
+    uint8_t  action;
+    uint16_t keycode;
+    uint16_t delay; // in milliseconds, before the next step
+} macro_step_t;
+
+// Enough for the longest macro item: a dead key character that needs both Shift and AltGr
+#define MACRO_ITEM_MAX_STEPS 8
+
+typedef struct {
+    macro_step_t steps[MACRO_ITEM_MAX_STEPS];
+    uint8_t      count;
+} macro_item_t;
+
+static void macro_item_push(macro_item_t *item, uint8_t action, uint16_t keycode, uint16_t delay) {
+    item->steps[item->count++] = (macro_step_t){.action = action, .keycode = keycode, .delay = delay};
+}
+
+// Mirrors tap_code(), followed by a delay
+static void macro_item_push_tap(macro_item_t *item, uint8_t keycode, uint16_t delay) {
+    macro_item_push(item, MACRO_STEP_REGISTER, keycode, keycode == KC_CAPS_LOCK ? QS_tap_hold_caps_delay : QS_tap_code_delay);
+    macro_item_push(item, MACRO_STEP_UNREGISTER, keycode, delay);
+}
+
+// Mirrors send_char_with_delay()
+static void macro_item_push_char(macro_item_t *item, char ascii_code, uint8_t interval) {
+#if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+    if (ascii_code == '\a') {
+        macro_item_push(item, MACRO_STEP_SEND_CHAR, ascii_code, 0);
         return;
     }
+#endif
 
-    // Check the last byte of the buffer.
-    // If it's not zero, then we are in the middle
-    // of buffer writing, possibly an aborted buffer
-    // write. So do nothing.
-    if (dynamic_keymap_read_byte(nvm_dynamic_keymap_macro_size() - 1) != 0) {
-        return;
+    bool    is_shifted, is_altgred, is_dead;
+    uint8_t keycode = send_char_lookup(ascii_code, &is_shifted, &is_altgred, &is_dead);
+
+    if (is_shifted) {
+        macro_item_push(item, MACRO_STEP_REGISTER, KC_LEFT_SHIFT, interval);
+    }
+    if (is_altgred) {
+        macro_item_push(item, MACRO_STEP_REGISTER, KC_RIGHT_ALT, interval);
+    }
+    macro_item_push(item, MACRO_STEP_REGISTER, keycode, interval);
+    macro_item_push(item, MACRO_STEP_UNREGISTER, keycode, interval);
+    if (is_altgred) {
+        macro_item_push(item, MACRO_STEP_UNREGISTER, KC_RIGHT_ALT, interval);
+    }
+    if (is_shifted) {
+        macro_item_push(item, MACRO_STEP_UNREGISTER, KC_LEFT_SHIFT, interval);
     }
+    if (is_dead) {
+        macro_item_push_tap(item, KC_SPACE, interval);
+    }
+}
 
-    // Skip N null characters
-    // offset will then point to the Nth macro
-    uint32_t offset = 0;
-    uint32_t end    = nvm_dynamic_keymap_macro_size();
-    while (id > 0) {
-        // If we are past the end of the buffer, then there is
-        // no Nth macro in the buffer.
-        if (offset == end) {
-            return;
-        }
-        if (dynamic_keymap_read_byte(offset) == 0) {
-            --id;
-        }
-        ++offset;
+/**
+ * Finds the start of the Nth macro in the buffer.
+ *
+ * Returns false if the buffer is being written, or holds fewer macros.
+ */
+static bool macro_find(uint8_t id, uint32_t *offset) {
+    if (id >= DYNAMIC_KEYMAP_MACRO_COUNT) {
+        return false;
     }
 
-    // Send the macro string one or three chars at a time
-    // by making temporary 1 or 3 char strings
-    char data[4] = {0, 0, 0, 0};
+    if (!macro_offsets_valid) {
+        macro_offsets_build();
+    }
+    if (macro_offsets[id] == MACRO_OFFSET_NONE) {
+        return false;
+    }
+
+    *offset = macro_offsets[id];
+    return true;
+}
+
+/**
+ * Decodes the macro item at offset into the steps needed to play it, and
+ * advances offset past it.
+ *
+ * Returns false at the end of the macro.
+ */
+static bool macro_decode_item(uint32_t *offset, macro_item_t *item) {
+    item->count = 0;
+
     // We already checked there was a null at the end of
     // the buffer, so this cannot go past the end
-    while (1) {
-        memset(data, 0, sizeof(data));
-        data[0] = dynamic_keymap_read_byte(offset++);
-        // Stop at the null terminator of this macro string
-        if (data[0] == 0) {
-            break;
+    char data[4] = {0, 0, 0, 0};
+    data[0]      = dynamic_keymap_read_byte((*offset)++);
+    // Stop at the null terminator of this macro string
+    if (data[0] == 0) {
+        return false;
+    }
+    if (data[0] != SS_QMK_PREFIX) {
+        // If the char wasn't magic, just send it
+        macro_item_push_char(item, data[0], DYNAMIC_KEYMAP_MACRO_DELAY);
+        return true;
+    }
+
+    // If the char is magic, process it as indicated by the next character
+    // (tap, down, up, delay)
+    data[1] = dynamic_keymap_read_byte((*offset)++);
+    if (data[1] == 0) {
+        return false;
+    }
+    if (data[1] == SS_TAP_CODE || data[1] == SS_DOWN_CODE || data[1] == SS_UP_CODE) {
+        data[2] = dynamic_keymap_read_byte((*offset)++);
+        if (data[2] == 0) {
+            return false;
         }
-        if (data[0] == SS_QMK_PREFIX) {
-            // If the char is magic, process it as indicated by the next character
-            // (tap, down, up, delay)
-            data[1] = dynamic_keymap_read_byte(offset++);
-            if (data[1] == 0)
+        // Same timing as send_string() gives these
+        switch (data[1]) {
+            case SS_TAP_CODE:
+                macro_item_push_tap(item, data[2], TAP_CODE_DELAY);
                 break;
-            if (data[1] == SS_TAP_CODE || data[1] == SS_DOWN_CODE || data[1] == SS_UP_CODE) {
-                // For tap, down, up, just stuff it into the array and send_string it
-                data[2] = dynamic_keymap_read_byte(offset++);
-                if (data[2] != 0)
-                    send_string(data);
-            } else if (data[1] == VIAL_MACRO_EXT_TAP || data[1] == VIAL_MACRO_EXT_DOWN || data[1] == VIAL_MACRO_EXT_UP) {
-                data[2] = dynamic_keymap_read_byte(offset++);
-                if (data[2] != 0) {
-                    data[3] = dynamic_keymap_read_byte(offset++);
-                    if (data[3] != 0) {
-                        uint16_t kc;
-                        memcpy(&kc, &data[2], sizeof(kc));
-                        kc = decode_keycode(kc);
-                        switch (data[1]) {
-                        case VIAL_MACRO_EXT_TAP:
-                            vial_keycode_tap(kc);
-                            break;
-                        case VIAL_MACRO_EXT_DOWN:
-                            vial_keycode_down(kc);
-                            break;
-                        case VIAL_MACRO_EXT_UP:
-                            vial_keycode_up(kc);
-                            break;
-                        }
-                    }
-                }
-            } else if (data[1] == SS_DELAY_CODE) {
-                // For delay, decode the delay and wait_ms for that amount
-                uint8_t d0 = dynamic_keymap_read_byte(offset++);
-                uint8_t d1 = dynamic_keymap_read_byte(offset++);
-                if (d0 == 0 || d1 == 0)
+            case SS_DOWN_CODE:
+                macro_item_push(item, MACRO_STEP_REGISTER, (uint8_t)data[2], TAP_CODE_DELAY);
+                break;
+            case SS_UP_CODE:
+                macro_item_push(item, MACRO_STEP_UNREGISTER, (uint8_t)data[2], TAP_CODE_DELAY);
+                break;
+        }
+    } else if (data[1] == VIAL_MACRO_EXT_TAP || data[1] == VIAL_MACRO_EXT_DOWN || data[1] == VIAL_MACRO_EXT_UP) {
+        data[2] = dynamic_keymap_read_byte((*offset)++);
+        if (data[2] == 0) {
+            return false;
+        }
+        data[3] = dynamic_keymap_read_byte((*offset)++);
+        if (data[3] == 0) {
+            return false;
+        }
+        uint16_t kc;
+        memcpy(&kc, &data[2], sizeof(kc));
+        kc = decode_keycode(kc);
+        switch (data[1]) {
+            case VIAL_MACRO_EXT_TAP:
+                macro_item_push(item, MACRO_STEP_VIAL_DOWN, kc, QS_tap_code_delay);
+                macro_item_push(item, MACRO_STEP_VIAL_UP, kc, 0);
+                break;
+            case VIAL_MACRO_EXT_DOWN:
+                macro_item_push(item, MACRO_STEP_VIAL_DOWN, kc, 0);
+                break;
+            case VIAL_MACRO_EXT_UP:
+                macro_item_push(item, MACRO_STEP_VIAL_UP, kc, 0);
+                break;
+        }
+    } else if (data[1] == SS_DELAY_CODE) {
+        uint8_t d0 = dynamic_keymap_read_byte((*offset)++);
+        uint8_t d1 = dynamic_keymap_read_byte((*offset)++);
+        if (d0 == 0 || d1 == 0) {
+            return false;
+        }
+        // we cannot use 0 for these, need to subtract 1 and use 255 instead of 256 for delay calculation
+        macro_item_push(item, MACRO_STEP_WAIT, KC_NO, (d0 - 1) + (d1 - 1) * 255);
+    }
+    return true;
+}
+
+static void macro_run_step(const macro_step_t *step) {
+    switch (step->action) {
+        case MACRO_STEP_REGISTER:
+            register_code(step->keycode);
+            break;
+        case MACRO_STEP_UNREGISTER:
+            unregister_code(step->keycode);
+            break;
+        case MACRO_STEP_VIAL_DOWN:
+            vial_keycode_down(step->keycode);
+            break;
+        case MACRO_STEP_VIAL_UP:
+            vial_keycode_up(step->keycode);
+            break;
+        case MACRO_STEP_SEND_CHAR:
+            send_char(step->keycode);
+            break;
+        default:
+            break;
+    }
+}
+
+#ifdef DYNAMIC_KEYMAP_MACRO_ASYNC
+static struct {
+    deferred_token token;
+    uint32_t       offset; // next item of the macro being played
+    macro_item_t   item;
+    uint8_t        step;
+    uint8_t        queue[DYNAMIC_KEYMAP_MACRO_QUEUE_SIZE];
+    uint8_t        queue_head;
+    uint8_t        queue_count;
+    macro_step_t   held[DYNAMIC_KEYMAP_MACRO_HELD_KEYS]; // releases for the keys currently held down, across items
+    uint8_t        held_count;
+} macro_player;
+
+static deferred_executor_t macro_executors[1];
+static uint32_t            macro_last_execution;
+
+static bool macro_player_start_queued(void) {
+    while (macro_player.queue_count > 0) {
+        uint8_t id              = macro_player.queue[macro_player.queue_head];
+        macro_player.queue_head = (macro_player.queue_head + 1) % DYNAMIC_KEYMAP_MACRO_QUEUE_SIZE;
+        macro_player.queue_count--;
+        if (macro_find(id, &macro_player.offset)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Remembers which keys the macro holds down, so that cancelling can release them whichever item pressed them. */
+static void macro_player_track_held(const macro_step_t *step) {
+    uint8_t release;
+    switch (step->action) {
+        case MACRO_STEP_REGISTER:
+            release = MACRO_STEP_UNREGISTER;
+            break;
+        case MACRO_STEP_VIAL_DOWN:
+            release = MACRO_STEP_VIAL_UP;
+            break;
+        case MACRO_STEP_UNREGISTER:
+        case MACRO_STEP_VIAL_UP:
+            for (uint8_t i = 0; i < macro_player.held_count; i++) {
+                if (macro_player.held[i].action == step->action && macro_player.held[i].keycode == step->keycode) {
+                    macro_player.held[i] = macro_player.held[--macro_player.held_count];
                     break;
-                // we cannot use 0 for these, need to subtract 1 and use 255 instead of 256 for delay calculation
-                int ms = (d0 - 1) + (d1 - 1) * 255;
-                while (ms--) wait_ms(1);
+                }
             }
-        } else {
-            // If the char wasn't magic, just send it
-            send_string_with_delay(data, DYNAMIC_KEYMAP_MACRO_DELAY);
+            return;
+        default:
+            return;
+    }
+
+    for (uint8_t i = 0; i < macro_player.held_count; i++) {
+        if (macro_player.held[i].action == release && macro_player.held[i].keycode == step->keycode) {
+            return;
+        }
+    }
+    if (macro_player.held_count < DYNAMIC_KEYMAP_MACRO_HELD_KEYS) {
+        macro_player.held[macro_player.held_count++] = (macro_step_t){.action = release, .keycode = step->keycode};
+    }
+}
+
+/**
+ * Plays the next step, decoding the next item (or macro) when the current one
+ * is done.
+ *
+ * Returns the delay before the following step, or 0 once everything has been played.
+ */
+static uint32_t macro_player_step(void) {
+    while (macro_player.step == macro_player.item.count) {
+        macro_player.step = 0;
+        if (!macro_decode_item(&macro_player.offset, &macro_player.item) && !macro_player_start_queued()) {
+            // Anything still down was left down on purpose, e.g. by a lone SS_DOWN
+            macro_player.item.count = 0;
+            macro_player.held_count = 0;
+            return 0;
+        }
+    }
+
+    const macro_step_t *step = &macro_player.item.steps[macro_player.step++];
+    macro_run_step(step);
+    macro_player_track_held(step);
+    // Deferred executors stop on 0, so back to back steps go out once per millisecond, i.e. one per report
+    return step->delay > 0 ? step->delay : 1;
+}
+
+static uint32_t macro_player_callback(uint32_t trigger_time, void *cb_arg) {
+    uint32_t delay = macro_player_step();
+    if (delay == 0) {
+        macro_player.token = INVALID_DEFERRED_TOKEN;
+    }
+    return delay;
+}
+
+void dynamic_keymap_macro_send(uint8_t id) {
+    // Play one macro at a time, in the order they were triggered
+    if (dynamic_keymap_macro_is_playing()) {
+        if (id < DYNAMIC_KEYMAP_MACRO_COUNT && macro_player.queue_count < DYNAMIC_KEYMAP_MACRO_QUEUE_SIZE) {
+            macro_player.queue[(macro_player.queue_head + macro_player.queue_count++) % DYNAMIC_KEYMAP_MACRO_QUEUE_SIZE] = id;
+        }
+        return;
+    }
+
+    if (!macro_find(id, &macro_player.offset)) {
+        return;
+    }
+
+    macro_player.step       = 0;
+    macro_player.item.count = 0;
+    uint32_t delay          = macro_player_step();
+    if (delay > 0) {
+        macro_player.token = defer_exec_advanced(macro_executors, ARRAY_SIZE(macro_executors), delay, macro_player_callback, NULL);
+    }
+}
+
+bool dynamic_keymap_macro_is_playing(void) {
+    return macro_player.token != INVALID_DEFERRED_TOKEN;
+}
+
+void dynamic_keymap_macro_cancel(void) {
+    if (dynamic_keymap_macro_is_playing()) {
+        cancel_deferred_exec_advanced(macro_executors, ARRAY_SIZE(macro_executors), macro_player.token);
+        macro_player.token = INVALID_DEFERRED_TOKEN;
+    }
+
+    // Release everything still held, most recently pressed first, e.g. Shift for a character or Ctrl from an earlier SS_DOWN
+    while (macro_player.held_count > 0) {
+        macro_run_step(&macro_player.held[--macro_player.held_count]);
+    }
+
+    macro_player.step        = 0;
+    macro_player.item.count  = 0;
+    macro_player.queue_count = 0;
+}
+
+void dynamic_keymap_macro_task(void) {
+    deferred_exec_advanced_task(macro_executors, ARRAY_SIZE(macro_executors), &macro_last_execution);
+}
+#else
+void dynamic_keymap_macro_send(uint8_t id) {
+    uint32_t offset;
+    if (!macro_find(id, &offset)) {
+        return;
+    }
+
+    macro_item_t item;
+    while (macro_decode_item(&offset, &item)) {
+        for (uint8_t i = 0; i < item.count; i++) {
+            macro_run_step(&item.steps[i]);
+            wait_ms(item.steps[i].delay);
         }
     }
 }
+#endif
@@ -30,6 +30,7 @@
 #    define DYNAMIC_KEYMAP_MACRO_COUNT 16
 #endif
 
+void     dynamic_keymap_init(void);
 uint8_t  dynamic_keymap_get_layer_count(void);
 uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column);
 void     dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode);
@@ -99,3 +100,13 @@ void     dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t
 void     dynamic_keymap_macro_reset(void);
 
 void dynamic_keymap_macro_send(uint8_t id);
+
+#ifdef DYNAMIC_KEYMAP_MACRO_ASYNC
+// Macros are played back from dynamic_keymap_macro_task(), one step at a time,
+// so that scanning carries on while they are typed. Macros triggered while
+// another one plays are queued behind it.
+bool dynamic_keymap_macro_is_playing(void);
+// Stops playback, releasing every key the macro still holds down, and drops queued macros
+void dynamic_keymap_macro_cancel(void);
+void dynamic_keymap_macro_task(void);
+#endif
@@ -16,6 +16,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <stdint.h>
+#include <string.h>
 #include "keyboard.h"
 #include "keycode_config.h"
 #include "matrix.h"
@@ -32,6 +33,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "task_profiler.h"
 #ifdef BOOTMAGIC_ENABLE
 #    include "bootmagic.h"
 #endif
@@ -104,6 +106,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef VIA_ENABLE
 #    include "via.h"
 #endif
+#ifdef DYNAMIC_KEYMAP_ENABLE
+#    include "dynamic_keymap.h"
+#endif
 #ifdef DIP_SWITCH_ENABLE
 #    include "dip_switch.h"
 #endif
@@ -158,6 +163,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef CONNECTION_ENABLE
 #    include "connection.h"
 #endif
+#ifdef I2C_QUEUE_ENABLE
+#    include "i2c_queue.h"
+#endif
+#ifdef TASK_SCHEDULER_ENABLE
+#    include "task_scheduler.h"
+#endif
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) {
@@ -237,12 +248,14 @@ uint32_t get_matrix_scan_rate(void) {
 #ifdef MATRIX_HAS_GHOST
 static matrix_row_t get_real_keys(uint8_t row, matrix_row_t rowdata) {
     matrix_row_t out = 0;
-    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+    while (rowdata) {
         // read each key in the row data and check if the keymap defines it as a real key
-        if (keycode_at_keymap_location(0, row, col) && (rowdata & (((matrix_row_t)1) << col))) {
+        const matrix_row_t col_mask = rowdata & -rowdata;
+        if (keycode_at_keymap_location(0, row, __builtin_ctzl((unsigned long)col_mask))) {
             // this creates new row data, if a key is defined in the keymap, it will be set here
-            out |= ((matrix_row_t)1) << col;
+            out |= col_mask;
         }
+        rowdata ^= col_mask;
     }
     return out;
 }
@@ -252,33 +265,65 @@ static inline bool popcount_more_than_one(matrix_row_t rowdata) {
     return rowdata;
 }
 
-static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata) {
+static matrix_row_t ghost_source_rows[MATRIX_ROWS];
+static matrix_row_t ghost_real_keys[MATRIX_ROWS];
+static bool         ghost_rows[MATRIX_ROWS];
+static bool         ghost_keymap_changed = true;
+
+void matrix_ghost_invalidate(void) {
+    ghost_keymap_changed = true;
+}
+
+/* Refreshes the real keys of the rows which changed since the last call, and which rows are ghosting.
+The keymap is only consulted for keys that are down on a changed row, or on every row after the keymap changed. */
+static void update_ghost_rows(const matrix_row_t current_matrix[]) {
+    bool rows_changed    = false;
+    bool refresh_all     = ghost_keymap_changed;
+    ghost_keymap_changed = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (refresh_all || current_matrix[row] != ghost_source_rows[row]) {
+            ghost_source_rows[row] = current_matrix[row];
+            ghost_real_keys[row]   = get_real_keys(row, current_matrix[row]);
+            rows_changed           = true;
+        }
+    }
+    if (!rows_changed) {
+        return;
+    }
+
     /* No ghost exists when less than 2 keys are down on the row.
     If there are "active" blanks in the matrix, the key can't be pressed by the user,
     there is no doubt as to which keys are really being pressed.
-    The ghosts will be ignored, they are KC_NO.   */
-    rowdata = get_real_keys(row, rowdata);
-    if ((popcount_more_than_one(rowdata)) == 0) {
-        return false;
-    }
-    /* Ghost occurs when the row shares a column line with other row,
+    The ghosts will be ignored, they are KC_NO.
+    Ghost occurs when the row shares a column line with other row,
     and two columns are read on each row. Blanks in the matrix don't matter,
     so they are filtered out.
     If there are two or more real keys pressed and they match columns with
-    at least two of another row's real keys, the row will be ignored. Keep in mind,
-    we are checking one row at a time, not all of them at once.
+    at least two of another row's real keys, the row will be ignored.
     */
-    for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
-        if (i != row && popcount_more_than_one(get_real_keys(i, matrix_get_row(i)) & rowdata)) {
-            return true;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        ghost_rows[row] = false;
+        if (!popcount_more_than_one(ghost_real_keys[row])) {
+            continue;
+        }
+        for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
+            if (i != row && popcount_more_than_one(ghost_real_keys[i] & ghost_real_keys[row])) {
+                ghost_rows[row] = true;
+                break;
+            }
         }
     }
-    return false;
+}
+
+static inline bool has_ghost_in_row(uint8_t row) {
+    return ghost_rows[row];
 }
 
 #else
 
-static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata) {
+#    define update_ghost_rows(current_matrix)
+
+static inline bool has_ghost_in_row(uint8_t row) {
     return false;
 }
 
@@ -434,9 +479,14 @@ __attribute__((weak)) void housekeeping_task_user(void) {}
  * Invokes hooks for executing code after QMK is done after each loop iteration.
  */
 void housekeeping_task(void) {
+    TASK_PROFILER_START();
+#ifdef EEPROM_DRIVER
+    eeprom_driver_task();
+#endif
     housekeeping_task_modules();
     housekeeping_task_kb();
     housekeeping_task_user();
+    TASK_PROFILER_LAP(TASK_PROFILER_SLOT_HOUSEKEEPING);
 }
 
 /** \brief quantum_init
@@ -469,12 +519,41 @@ void quantum_init(void) {
  *
  * FIXME: needs doc
  */
+#ifdef TASK_SCHEDULER_ENABLE
+/** \brief Hands the lighting and display tasks to the scheduler, rather than running them on every pass
+ */
+static void scheduled_tasks_init(void) {
+    task_scheduler_init();
+#    if defined(RGBLIGHT_ENABLE)
+    task_scheduler_add(&(task_scheduler_task_t){rgblight_task, TASK_SCHEDULER_LIGHTING_PERIOD, TASK_SCHEDULER_LIGHTING_PRIORITY, TASK_SCHEDULER_LIGHTING_BUDGET, TASK_PROFILER_SLOT_RGBLIGHT});
+#    endif
+#    ifdef LED_MATRIX_ENABLE
+    task_scheduler_add(&(task_scheduler_task_t){led_matrix_task, TASK_SCHEDULER_LIGHTING_PERIOD, TASK_SCHEDULER_LIGHTING_PRIORITY, TASK_SCHEDULER_LIGHTING_BUDGET, TASK_PROFILER_SLOT_LED_MATRIX});
+#    endif
+#    ifdef RGB_MATRIX_ENABLE
+    task_scheduler_add(&(task_scheduler_task_t){rgb_matrix_task, TASK_SCHEDULER_LIGHTING_PERIOD, TASK_SCHEDULER_LIGHTING_PRIORITY, TASK_SCHEDULER_LIGHTING_BUDGET, TASK_PROFILER_SLOT_RGB_MATRIX});
+#    endif
+#    if defined(BACKLIGHT_ENABLE) && (defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS))
+    task_scheduler_add(&(task_scheduler_task_t){backlight_task, TASK_SCHEDULER_LIGHTING_PERIOD, TASK_SCHEDULER_LIGHTING_PRIORITY, TASK_SCHEDULER_LIGHTING_BUDGET, TASK_PROFILER_SLOT_BACKLIGHT});
+#    endif
+#    ifdef OLED_ENABLE
+    task_scheduler_add(&(task_scheduler_task_t){oled_task, TASK_SCHEDULER_DISPLAY_PERIOD, TASK_SCHEDULER_DISPLAY_PRIORITY, TASK_SCHEDULER_DISPLAY_BUDGET, TASK_PROFILER_SLOT_OLED});
+#    endif
+#    ifdef ST7565_ENABLE
+    task_scheduler_add(&(task_scheduler_task_t){st7565_task, TASK_SCHEDULER_DISPLAY_PERIOD, TASK_SCHEDULER_DISPLAY_PRIORITY, TASK_SCHEDULER_DISPLAY_BUDGET, TASK_PROFILER_SLOT_ST7565});
+#    endif
+}
+#endif
+
 void keyboard_init(void) {
     timer_init();
     sync_timer_init();
 #ifdef VIA_ENABLE
     via_init();
 #endif
+#ifdef DYNAMIC_KEYMAP_ENABLE
+    dynamic_keymap_init();
+#endif
 #ifdef SPLIT_KEYBOARD
     split_pre_init();
 #endif
@@ -559,6 +638,12 @@ void keyboard_init(void) {
 #ifdef RPI_ENABLE
     rpi_init();
 #endif
+#ifdef TASK_SCHEDULER_ENABLE
+    scheduled_tasks_init();
+#endif
+#if defined(COMBO_ENABLE) && defined(COMBO_KEY_INDEX)
+    combo_key_index_rebuild();
+#endif
 
 #if defined(DEBUG_MATRIX_SCAN_RATE) && defined(CONSOLE_ENABLE)
     debug_enable = true;
@@ -608,12 +693,14 @@ static bool matrix_task(void) {
     }
 
     static matrix_row_t matrix_previous[MATRIX_ROWS];
+    matrix_row_t        matrix_current[MATRIX_ROWS];
 
     matrix_scan();
-    bool matrix_changed = false;
-    for (uint8_t row = 0; row < MATRIX_ROWS && !matrix_changed; row++) {
-        matrix_changed |= matrix_previous[row] ^ matrix_get_row(row);
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_current[row] = matrix_get_row(row);
     }
+    // Compare the whole matrix at once, rather than row by row
+    bool matrix_changed = memcmp(matrix_previous, matrix_current, sizeof(matrix_current)) != 0;
 
     matrix_scan_perf_task();
 
@@ -627,27 +714,31 @@ static bool matrix_task(void) {
         matrix_print();
     }
 
+    task_profiler_key_edge();
+    update_ghost_rows(matrix_current);
+
     const bool process_keypress = should_process_keypress();
 
     for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
-        const matrix_row_t current_row = matrix_get_row(row);
-        const matrix_row_t row_changes = current_row ^ matrix_previous[row];
+        const matrix_row_t current_row = matrix_current[row];
+        matrix_row_t       row_changes = current_row ^ matrix_previous[row];
 
-        if (!row_changes || has_ghost_in_row(row, current_row)) {
+        if (!row_changes || has_ghost_in_row(row)) {
             continue;
         }
 
-        matrix_row_t col_mask = 1;
-        for (uint8_t col = 0; col < MATRIX_COLS; col++, col_mask <<= 1) {
-            if (row_changes & col_mask) {
-                const bool key_pressed = current_row & col_mask;
+        // Visit only the changed columns, lowest first
+        while (row_changes) {
+            const matrix_row_t col_mask    = row_changes & -row_changes;
+            const uint8_t      col         = __builtin_ctzl((unsigned long)col_mask);
+            const bool         key_pressed = current_row & col_mask;
 
-                if (process_keypress) {
-                    action_exec(MAKE_KEYEVENT(row, col, key_pressed));
-                }
-
-                switch_events(row, col, key_pressed);
+            if (process_keypress) {
+                action_exec(MAKE_KEYEVENT(row, col, key_pressed));
             }
+
+            switch_events(row, col, key_pressed);
+            row_changes ^= col_mask;
         }
 
         matrix_previous[row] = current_row;
@@ -737,32 +828,44 @@ void quantum_task(void) {
 
 /** \brief Main task that is repeatedly called as fast as possible. */
 void keyboard_task(void) {
+    task_profiler_task();
+    TASK_PROFILER_START();
+#ifdef TASK_SCHEDULER_ENABLE
+    task_scheduler_begin();
+#endif
+
     __attribute__((unused)) bool activity_has_occurred = false;
     if (matrix_task()) {
         last_matrix_activity_trigger();
         activity_has_occurred = true;
     }
+    TASK_PROFILER_LAP(TASK_PROFILER_SLOT_MATRIX);
 
     quantum_task();
+    TASK_PROFILER_LAP(TASK_PROFILER_SLOT_QUANTUM);
 
 #if defined(SPLIT_WATCHDOG_ENABLE)
     split_watchdog_task();
 #endif
 
-#if defined(RGBLIGHT_ENABLE)
+#if defined(RGBLIGHT_ENABLE) && !defined(TASK_SCHEDULER_ENABLE)
     rgblight_task();
+    TASK_PROFILER_LAP(TASK_PROFILER_SLOT_RGBLIGHT);
 #endif
 
-#ifdef LED_MATRIX_ENABLE
+#if defined(LED_MATRIX_ENABLE) && !defined(TASK_SCHEDULER_ENABLE)
     led_matrix_task();
+    TASK_PROFILER_LAP(TASK_PROFILER_SLOT_LED_MATRIX);
 #endif
-#ifdef RGB_MATRIX_ENABLE
+#if defined(RGB_MATRIX_ENABLE) && !defined(TASK_SCHEDULER_ENABLE)
     rgb_matrix_task();
+    TASK_PROFILER_LAP(TASK_PROFILER_SLOT_RGB_MATRIX);
 #endif
 
-#if defined(BACKLIGHT_ENABLE)
+#if defined(BACKLIGHT_ENABLE) && !defined(TASK_SCHEDULER_ENABLE)
 #    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
     backlight_task();
+    TASK_PROFILER_LAP(TASK_PROFILER_SLOT_BACKLIGHT);
 #    endif
 #endif
 
@@ -771,6 +874,7 @@ void keyboard_task(void) {
         last_encoder_activity_trigger();
         activity_has_occurred = true;
     }
+    TASK_PROFILER_LAP(TASK_PROFILER_SLOT_ENCODER);
 #endif
 
 #ifdef POINTING_DEVICE_ENABLE
@@ -778,27 +882,47 @@ void keyboard_task(void) {
         last_pointing_device_activity_trigger();
         activity_has_occurred = true;
     }
+    TASK_PROFILER_LAP(TASK_PROFILER_SLOT_POINTING);
 #endif
 
 #ifdef OLED_ENABLE
+#    ifndef TASK_SCHEDULER_ENABLE
     oled_task();
+#    endif
 #    if OLED_TIMEOUT > 0
     // Wake up oled if user is using those fabulous keys or spinning those encoders!
     if (activity_has_occurred) oled_on();
 #    endif
+#    ifndef TASK_SCHEDULER_ENABLE
+    TASK_PROFILER_LAP(TASK_PROFILER_SLOT_OLED);
+#    endif
 #endif
 
 #ifdef ST7565_ENABLE
+#    ifndef TASK_SCHEDULER_ENABLE
     st7565_task();
+#    endif
 #    if ST7565_TIMEOUT > 0
     // Wake up display if user is using those fabulous keys or spinning those encoders!
     if (activity_has_occurred) st7565_on();
 #    endif
+#    ifndef TASK_SCHEDULER_ENABLE
+    TASK_PROFILER_LAP(TASK_PROFILER_SLOT_ST7565);
+#    endif
 #endif
 
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
     mousekey_task();
+    TASK_PROFILER_LAP(TASK_PROFILER_SLOT_MOUSEKEY);
+#endif
+
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_MACRO_ASYNC)
+    dynamic_keymap_macro_task();
+#endif
+
+#ifdef I2C_QUEUE_ENABLE
+    i2c_queue_task();
 #endif
 
 #ifdef PS2_MOUSE_ENABLE
@@ -830,4 +954,12 @@ void keyboard_task(void) {
 #ifdef OS_DETECTION_ENABLE
     os_detection_task();
 #endif
+    TASK_PROFILER_LAP(TASK_PROFILER_SLOT_OTHER);
+
+#ifdef TASK_SCHEDULER_ENABLE
+    // Lighting and displays last, with whatever time is left before the next scan
+    task_scheduler_task();
+    TASK_PROFILER_SKIP();
+#endif
+    TASK_PROFILER_TOTAL(TASK_PROFILER_SLOT_KEYBOARD_TASK);
 }
@@ -139,6 +139,11 @@ void set_activity_timestamps(uint32_t matrix_timestamp, uint32_t encoder_timesta
 
 uint32_t get_matrix_scan_rate(void);
 
+#ifdef MATRIX_HAS_GHOST
+/* drop the cached real keys used for ghost detection, after keymap changes */
+void matrix_ghost_invalidate(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,6 +1,7 @@
 // Copyright 2024 Nick Brassel (@tzarc)
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <string.h>
 #include "compiler_support.h"
 #include "keycodes.h"
 #include "eeprom.h"
@@ -117,35 +118,216 @@ STATIC_ASSERT((int64_t)(DYNAMIC_KEYMAP_EEPROM_MAX_ADDR) - (int64_t)(DYNAMIC_KEYM
 #    define DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE (DYNAMIC_KEYMAP_EEPROM_MAX_ADDR - DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + 1)
 #endif
 
+#define DYNAMIC_KEYMAP_EEPROM_SIZE (DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2)
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+static inline void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t column) {
+    return ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + (layer * MATRIX_ROWS * MATRIX_COLS * 2) + (row * MATRIX_COLS * 2) + (column * 2);
+}
+
+static inline uint16_t eeprom_read_keycode(void *address) {
+    // Big endian, so we can read/write EEPROM directly from host if we want
+    uint16_t keycode = ((uint16_t)eeprom_read_byte(address)) << 8;
+    keycode |= eeprom_read_byte(address + 1);
+    return keycode;
+}
+
+static inline void eeprom_update_keycode(void *address, uint16_t keycode) {
+    // Big endian, so we can read/write EEPROM directly from host if we want
+    eeprom_update_byte(address, (uint8_t)(keycode >> 8));
+    eeprom_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
+}
+
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+// Write-through RAM mirror of the keymap and encoder map, so that reads on the
+// keypress path do not depend on the speed of the EEPROM backend.
+//
+// When compressed, each cell holds an index into a dictionary of the distinct
+// keycodes in use. Entries are reference counted, so that remapping frees the
+// entries of keycodes no longer in the keymap. Keycodes which do not fit in the
+// dictionary are marked as uncached and fall back to reading EEPROM.
+#    ifdef DYNAMIC_KEYMAP_RAM_CACHE_COMPRESSED
+#        ifndef DYNAMIC_KEYMAP_RAM_CACHE_DICTIONARY_SIZE
+#            define DYNAMIC_KEYMAP_RAM_CACHE_DICTIONARY_SIZE 64
+#        endif
+STATIC_ASSERT(DYNAMIC_KEYMAP_RAM_CACHE_DICTIONARY_SIZE < 255, "DYNAMIC_KEYMAP_RAM_CACHE_DICTIONARY_SIZE must be less than 255");
+
+typedef uint8_t keymap_cache_cell_t;
+#        define KEYMAP_CACHE_CELL_UNCACHED 0xFF
+
+static uint16_t keymap_cache_dictionary[DYNAMIC_KEYMAP_RAM_CACHE_DICTIONARY_SIZE];
+static uint16_t keymap_cache_dictionary_refs[DYNAMIC_KEYMAP_RAM_CACHE_DICTIONARY_SIZE]; // cells using each entry, free once zero
+static uint8_t  keymap_cache_dictionary_count = 0;
+#    else
+typedef uint16_t keymap_cache_cell_t;
+#    endif
+
+static keymap_cache_cell_t keymap_cache[DYNAMIC_KEYMAP_LAYER_COUNT][MATRIX_ROWS][MATRIX_COLS];
+#    ifdef ENCODER_MAP_ENABLE
+static keymap_cache_cell_t encoder_cache[DYNAMIC_KEYMAP_LAYER_COUNT][NUM_ENCODERS][2];
+#    endif // ENCODER_MAP_ENABLE
+static bool keymap_cache_loaded = false;
+
+static keymap_cache_cell_t keymap_cache_encode(uint16_t keycode) {
+#    ifdef DYNAMIC_KEYMAP_RAM_CACHE_COMPRESSED
+    uint8_t entry = KEYMAP_CACHE_CELL_UNCACHED;
+    for (uint8_t i = 0; i < keymap_cache_dictionary_count; i++) {
+        if (keymap_cache_dictionary_refs[i] == 0) {
+            if (entry == KEYMAP_CACHE_CELL_UNCACHED) {
+                entry = i;
+            }
+        } else if (keymap_cache_dictionary[i] == keycode) {
+            keymap_cache_dictionary_refs[i]++;
+            return i;
+        }
+    }
+    if (entry == KEYMAP_CACHE_CELL_UNCACHED && keymap_cache_dictionary_count < DYNAMIC_KEYMAP_RAM_CACHE_DICTIONARY_SIZE) {
+        entry = keymap_cache_dictionary_count++;
+    }
+    if (entry != KEYMAP_CACHE_CELL_UNCACHED) {
+        keymap_cache_dictionary[entry]      = keycode;
+        keymap_cache_dictionary_refs[entry] = 1;
+    }
+    return entry;
+#    else
+    return keycode;
+#    endif
+}
+
+// Drops a cell's reference to its dictionary entry, before the cell is overwritten.
+static inline void keymap_cache_release(keymap_cache_cell_t cell) {
+#    ifdef DYNAMIC_KEYMAP_RAM_CACHE_COMPRESSED
+    if (cell != KEYMAP_CACHE_CELL_UNCACHED) {
+        keymap_cache_dictionary_refs[cell]--;
+    }
+#    else
+    (void)cell;
+#    endif
+}
+
+static uint16_t keymap_cache_decode(keymap_cache_cell_t cell, void *address) {
+#    ifdef DYNAMIC_KEYMAP_RAM_CACHE_COMPRESSED
+    if (cell == KEYMAP_CACHE_CELL_UNCACHED) {
+        return eeprom_read_keycode(address);
+    }
+    return keymap_cache_dictionary[cell];
+#    else
+    return cell;
+#    endif
+}
+
+static void keymap_cache_load(void) {
+    uint8_t buffer[MATRIX_COLS * 2];
+
+#    ifdef DYNAMIC_KEYMAP_RAM_CACHE_COMPRESSED
+    keymap_cache_dictionary_count = 0;
+#    endif
+    // Read a row at a time, block reads are considerably cheaper on external EEPROMs
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            eeprom_read_block(buffer, dynamic_keymap_key_to_eeprom_address(layer, row, 0), sizeof(buffer));
+            for (uint8_t column = 0; column < MATRIX_COLS; column++) {
+                keymap_cache[layer][row][column] = keymap_cache_encode((buffer[column * 2] << 8) | buffer[column * 2 + 1]);
+            }
+        }
+    }
+#    ifdef ENCODER_MAP_ENABLE
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        for (uint8_t encoder_id = 0; encoder_id < NUM_ENCODERS; encoder_id++) {
+            void *address = ((void *)DYNAMIC_KEYMAP_ENCODER_EEPROM_ADDR) + (layer * NUM_ENCODERS * 2 * 2) + (encoder_id * 2 * 2);
+            encoder_cache[layer][encoder_id][0] = keymap_cache_encode(eeprom_read_keycode(address));
+            encoder_cache[layer][encoder_id][1] = keymap_cache_encode(eeprom_read_keycode(address + 2));
+        }
+    }
+#    endif // ENCODER_MAP_ENABLE
+    keymap_cache_loaded = true;
+}
+
+static inline void keymap_cache_ensure_loaded(void) {
+    if (!keymap_cache_loaded) {
+        keymap_cache_load();
+    }
+}
+
+// Applies a raw big-endian buffer write, already committed to EEPROM, to the cached keycodes it covers.
+static void keymap_cache_update_buffer(uint32_t offset, uint32_t size, const uint8_t *data) {
+    keymap_cache_cell_t *cells = &keymap_cache[0][0][0];
+    uint32_t             end   = offset + size;
+    if (end > DYNAMIC_KEYMAP_EEPROM_SIZE) {
+        end = DYNAMIC_KEYMAP_EEPROM_SIZE;
+    }
+    for (uint32_t position = offset & ~1UL; position < end; position += 2) {
+        void *   address = ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + position;
+        uint16_t keycode = keymap_cache_decode(cells[position / 2], address);
+        keymap_cache_release(cells[position / 2]);
+        if (position >= offset) {
+            keycode = (keycode & 0x00FF) | (data[position - offset] << 8);
+        }
+        if (position + 1 < end) {
+            keycode = (keycode & 0xFF00) | data[position + 1 - offset];
+        }
+        cells[position / 2] = keymap_cache_encode(keycode);
+    }
+}
+#endif // DYNAMIC_KEYMAP_RAM_CACHE
+
+#ifdef DYNAMIC_KEYMAP_MACRO_RAM_CACHE
+// Write-through RAM mirror of the macro buffer, so that macros are decoded
+// without going through the EEPROM backend one byte at a time.
+static uint8_t macro_cache[DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE];
+static bool    macro_cache_loaded = false;
+
+static inline void macro_cache_ensure_loaded(void) {
+    if (!macro_cache_loaded) {
+        eeprom_read_block(macro_cache, (void *)(uintptr_t)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR), DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
+        macro_cache_loaded = true;
+    }
+}
+#endif // DYNAMIC_KEYMAP_MACRO_RAM_CACHE
+
+void nvm_dynamic_keymap_init(void) {
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    keymap_cache_load();
+#endif
+}
+
 void nvm_dynamic_keymap_erase(void) {
     // No-op, nvm_eeconfig_erase() will have already erased EEPROM if necessary.
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    // The mirror is reloaded on next access, once the keymap has been rewritten.
+    keymap_cache_loaded = false;
+#endif
 }
 
 void nvm_dynamic_keymap_macro_erase(void) {
     // No-op, nvm_eeconfig_erase() will have already erased EEPROM if necessary.
-}
-
-static inline void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t column) {
-    return ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + (layer * MATRIX_ROWS * MATRIX_COLS * 2) + (row * MATRIX_COLS * 2) + (column * 2);
+#ifdef DYNAMIC_KEYMAP_MACRO_RAM_CACHE
+    macro_cache_loaded = false;
+#endif
 }
 
 uint16_t nvm_dynamic_keymap_read_keycode(uint8_t layer, uint8_t row, uint8_t column) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return KC_NO;
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
-    // Big endian, so we can read/write EEPROM directly from host if we want
-    uint16_t keycode = eeprom_read_byte(address) << 8;
-    keycode |= eeprom_read_byte(address + 1);
-    return keycode;
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    keymap_cache_ensure_loaded();
+    return keymap_cache_decode(keymap_cache[layer][row][column], address);
+#else
+    return eeprom_read_keycode(address);
+#endif
 }
 
 void nvm_dynamic_keymap_update_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return;
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
-    // Big endian, so we can read/write EEPROM directly from host if we want
-    eeprom_update_byte(address, (uint8_t)(keycode >> 8));
-    eeprom_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
+    eeprom_update_keycode(address, keycode);
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    if (keymap_cache_loaded) {
+        keymap_cache_release(keymap_cache[layer][row][column]);
+        keymap_cache[layer][row][column] = keymap_cache_encode(keycode);
+    }
+#endif
 }
 
 #ifdef ENCODER_MAP_ENABLE
@@ -155,29 +337,44 @@ static void *dynamic_keymap_encoder_to_eeprom_address(uint8_t layer, uint8_t enc
 
 uint16_t nvm_dynamic_keymap_read_encoder(uint8_t layer, uint8_t encoder_id, bool clockwise) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || encoder_id >= NUM_ENCODERS) return KC_NO;
-    void *address = dynamic_keymap_encoder_to_eeprom_address(layer, encoder_id);
-    // Big endian, so we can read/write EEPROM directly from host if we want
-    uint16_t keycode = ((uint16_t)eeprom_read_byte(address + (clockwise ? 0 : 2))) << 8;
-    keycode |= eeprom_read_byte(address + (clockwise ? 0 : 2) + 1);
-    return keycode;
+    void *address = dynamic_keymap_encoder_to_eeprom_address(layer, encoder_id) + (clockwise ? 0 : 2);
+#    ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    keymap_cache_ensure_loaded();
+    return keymap_cache_decode(encoder_cache[layer][encoder_id][clockwise ? 0 : 1], address);
+#    else
+    return eeprom_read_keycode(address);
+#    endif
 }
 
 void nvm_dynamic_keymap_update_encoder(uint8_t layer, uint8_t encoder_id, bool clockwise, uint16_t keycode) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || encoder_id >= NUM_ENCODERS) return;
-    void *address = dynamic_keymap_encoder_to_eeprom_address(layer, encoder_id);
-    // Big endian, so we can read/write EEPROM directly from host if we want
-    eeprom_update_byte(address + (clockwise ? 0 : 2), (uint8_t)(keycode >> 8));
-    eeprom_update_byte(address + (clockwise ? 0 : 2) + 1, (uint8_t)(keycode & 0xFF));
+    void *address = dynamic_keymap_encoder_to_eeprom_address(layer, encoder_id) + (clockwise ? 0 : 2);
+    eeprom_update_keycode(address, keycode);
+#    ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    if (keymap_cache_loaded) {
+        keymap_cache_release(encoder_cache[layer][encoder_id][clockwise ? 0 : 1]);
+        encoder_cache[layer][encoder_id][clockwise ? 0 : 1] = keymap_cache_encode(keycode);
+    }
+#    endif
 }
 #endif // ENCODER_MAP_ENABLE
 
 void nvm_dynamic_keymap_read_buffer(uint32_t offset, uint32_t size, uint8_t *data) {
-    uint32_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
+    uint32_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_EEPROM_SIZE;
     void *   source                     = (void *)(uintptr_t)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
     uint8_t *target                     = data;
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    keymap_cache_ensure_loaded();
+#endif
     for (uint32_t i = 0; i < size; i++) {
         if (offset + i < dynamic_keymap_eeprom_size) {
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+            uint32_t position = offset + i;
+            uint16_t keycode  = keymap_cache_decode((&keymap_cache[0][0][0])[position / 2], source - (position & 1));
+            *target           = (position & 1) ? (uint8_t)(keycode & 0xFF) : (uint8_t)(keycode >> 8);
+#else
             *target = eeprom_read_byte(source);
+#endif
         } else {
             *target = 0x00;
         }
@@ -187,7 +384,7 @@ void nvm_dynamic_keymap_read_buffer(uint32_t offset, uint32_t size, uint8_t *dat
 }
 
 void nvm_dynamic_keymap_update_buffer(uint32_t offset, uint32_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
+    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_EEPROM_SIZE;
     void *   target                     = (void *)((uintptr_t)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset));
     uint8_t *source                     = data;
 
@@ -242,6 +439,12 @@ void nvm_dynamic_keymap_update_buffer(uint32_t offset, uint32_t size, uint8_t *d
         source++;
         target++;
     }
+
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    if (keymap_cache_loaded) {
+        keymap_cache_update_buffer(offset, size, data);
+    }
+#endif
 }
 
 uint32_t nvm_dynamic_keymap_macro_size(void) {
@@ -249,6 +452,12 @@ uint32_t nvm_dynamic_keymap_macro_size(void) {
 }
 
 void nvm_dynamic_keymap_macro_read_buffer(uint32_t offset, uint32_t size, uint8_t *data) {
+#ifdef DYNAMIC_KEYMAP_MACRO_RAM_CACHE
+    macro_cache_ensure_loaded();
+    for (uint32_t i = 0; i < size; i++) {
+        data[i] = offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE ? macro_cache[offset + i] : 0x00;
+    }
+#else
     void *   source = (void *)(uintptr_t)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
     uint8_t *target = data;
     for (uint16_t i = 0; i < size; i++) {
@@ -260,6 +469,7 @@ void nvm_dynamic_keymap_macro_read_buffer(uint32_t offset, uint32_t size, uint8_
         source++;
         target++;
     }
+#endif
 }
 
 void nvm_dynamic_keymap_macro_update_buffer(uint32_t offset, uint32_t size, uint8_t *data) {
@@ -268,6 +478,9 @@ void nvm_dynamic_keymap_macro_update_buffer(uint32_t offset, uint32_t size, uint
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
             eeprom_update_byte(target, *source);
+#ifdef DYNAMIC_KEYMAP_MACRO_RAM_CACHE
+            macro_cache[offset + i] = *source;
+#endif
         }
         source++;
         target++;
@@ -285,6 +498,10 @@ void nvm_dynamic_keymap_macro_reset(void) {
         start += this_loop;
         remaining -= this_loop;
     }
+#ifdef DYNAMIC_KEYMAP_MACRO_RAM_CACHE
+    memset(macro_cache, 0, sizeof(macro_cache));
+    macro_cache_loaded = true;
+#endif
 }
 
 #ifdef QMK_SETTINGS
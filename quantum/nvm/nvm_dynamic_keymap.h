@@ -5,6 +5,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+void nvm_dynamic_keymap_init(void);
 void nvm_dynamic_keymap_erase(void);
 void nvm_dynamic_keymap_macro_erase(void);
 
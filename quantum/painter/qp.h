@@ -56,6 +56,15 @@
 #    define QUANTUM_PAINTER_LOAD_FONTS_TO_RAM FALSE
 #endif
 
+#ifndef QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE
+/**
+ * @def This controls the number of unicode glyph lookups each loaded font remembers, evicting the least recently used.
+ *      Fonts with many unicode glyphs benefit the most, as each lookup otherwise searches the font's glyph table. Each
+ *      entry requires 8 bytes of RAM for every font in \ref QUANTUM_PAINTER_NUM_FONTS. Defaults to 0, disabled.
+ */
+#    define QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE 0
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE
+
 #ifndef QUANTUM_PAINTER_CONCURRENT_ANIMATIONS
 /**
  * @def This controls the maximum number of animations that Quantum Painter can play simultaneously. Increasing this
@@ -88,6 +97,33 @@
 #    define QUANTUM_PAINTER_SUPPORTS_NATIVE_COLORS FALSE
 #endif
 
+#ifndef QUANTUM_PAINTER_PALETTE_CACHE
+/**
+ * @def This controls whether the last palette loaded from a QGF image or QFF font is remembered, so that frames and
+ *      fonts sharing it don't need to convert it to the device's native format again. Requires 3 bytes of RAM per
+ *      palette entry -- 48 bytes, or 768 bytes if QUANTUM_PAINTER_SUPPORTS_256_PALETTE is enabled.
+ */
+#    define QUANTUM_PAINTER_PALETTE_CACHE FALSE
+#endif
+
+#ifndef QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+/**
+ * @def This controls whether a RAM buffer can be attached to a device with \ref qp_set_text_cache, in which glyphs
+ *      are kept already converted to the device's native pixel format, so that redrawing the same text is a matter of
+ *      streaming the cached pixels instead of decoding the font again.
+ */
+#    define QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE FALSE
+#endif
+
+#ifndef QUANTUM_PAINTER_SUPPORTS_ASYNC_PIXDATA
+/**
+ * @def This controls whether pixel data is double-buffered, so that devices whose comms can send asynchronously (such
+ *      as SPI using DMA) send one buffer while the next is being decoded into the other. Doubles the RAM used by the
+ *      pixel data buffer.
+ */
+#    define QUANTUM_PAINTER_SUPPORTS_ASYNC_PIXDATA FALSE
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter types
 
@@ -488,6 +524,22 @@ int16_t qp_drawtext(painter_device_t device, uint16_t x, uint16_t y, painter_fon
  */
 int16_t qp_drawtext_recolor(painter_device_t device, uint16_t x, uint16_t y, painter_font_handle_t font, const char *str, uint8_t hue_fg, uint8_t sat_fg, uint8_t val_fg, uint8_t hue_bg, uint8_t sat_bg, uint8_t val_bg);
 
+#if QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+/**
+ * Attaches a buffer to the device, in which \ref qp_drawtext and \ref qp_drawtext_recolor keep the glyphs they draw,
+ * already converted to the device's native pixel format. Glyphs are cached per font and colors. Once the buffer is
+ * full, it is emptied and refilled with the glyphs drawn from then on.
+ *
+ * @note Requires QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE to be set to TRUE.
+ *
+ * @param device[in] the handle of the device to control
+ * @param buffer[in] the RAM to use, which must stay valid until detached, or NULL to detach the current buffer
+ * @param buffer_size[in] the size of the buffer, in bytes
+ * @return true if the buffer was attached or detached
+ */
+bool qp_set_text_cache(painter_device_t device, void *buffer, uint32_t buffer_size);
+#endif // QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter Drivers
 
@@ -16,6 +16,10 @@ bool     qp_comms_start(painter_device_t device);
 void     qp_comms_stop(painter_device_t device);
 uint32_t qp_comms_send(painter_device_t device, const void* data, uint32_t byte_count);
 
+// Sends pixel data, which must not be modified until qp_comms_wait() has been called or another comms API is used.
+uint32_t qp_comms_send_async(painter_device_t device, const void* data, uint32_t byte_count);
+void     qp_comms_wait(painter_device_t device);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Comms APIs that use a D/C pin
 
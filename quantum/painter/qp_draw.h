@@ -10,7 +10,11 @@
 // Quantum Painter utility functions
 
 // Global variable used for native pixel data streaming.
+#if QUANTUM_PAINTER_SUPPORTS_ASYNC_PIXDATA
+extern uint8_t *qp_internal_global_pixdata_buffer;
+#else
 extern uint8_t qp_internal_global_pixdata_buffer[QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE];
+#endif
 
 // Check if the supplied bpp is capable of being rendered
 bool qp_internal_bpp_capable(uint8_t bits_per_pixel);
@@ -18,6 +22,9 @@ bool qp_internal_bpp_capable(uint8_t bits_per_pixel);
 // Returns the number of pixels that can fit in the pixdata buffer
 uint32_t qp_internal_num_pixels_in_buffer(painter_device_t device);
 
+// Sends pixels from the global pixdata buffer. The buffer is then swapped when double-buffered, as the pixels may still be being sent.
+bool qp_internal_send_pixdata_and_swap(painter_device_t device, uint32_t native_pixel_count);
+
 // Fills the supplied buffer with equivalent native pixels matching the supplied HSV
 void qp_internal_fill_pixdata(painter_device_t device, uint32_t num_pixels, uint8_t hue, uint8_t sat, uint8_t val);
 
@@ -51,8 +58,9 @@ bool qp_internal_interpolate_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888,
 // Resets the global palette so that it can be regenerated. Only needed if the colors are identical, but a different display is used with a different internal pixel format.
 void qp_internal_invalidate_palette(void);
 
-// Helper shared between image and font rendering -- sets up the global palette to match the palette block specified in the asset. Expects the stream to be positioned at the start of the block header.
-bool qp_internal_load_qgf_palette(qp_stream_t* stream, uint8_t bpp);
+// Helper shared between image and font rendering -- sets up the global palette to match the palette block specified in the asset, converted to the device's native format. Expects the stream to be positioned at the start of the block header.
+// With QUANTUM_PAINTER_PALETTE_CACHE, conversion is skipped if the palette is the same as the last one converted for the device.
+bool qp_internal_load_qgf_palette(painter_device_t device, qp_stream_t* stream, uint8_t bpp);
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter codec functions
@@ -130,38 +130,159 @@ bool qp_internal_pixel_appender(qp_pixel_t* palette, uint8_t index, void* cb_arg
     qp_internal_pixel_output_state_t* state  = (qp_internal_pixel_output_state_t*)cb_arg;
     painter_driver_t*                 driver = (painter_driver_t*)state->device;
 
-    if (!driver->driver_vtable->append_pixels(state->device, qp_internal_global_pixdata_buffer, palette, state->pixel_write_pos++, 1, &index)) {
-        return false;
-    }
-
-    // If we've hit the transmit limit, send out the entire buffer and reset the write position
+    // If we've hit the transmit limit, send out the entire buffer and reset the write position. This is done once there's
+    // another pixel to write, so that the last buffer is always left for the caller to send.
     if (state->pixel_write_pos == state->max_pixels) {
-        if (!driver->driver_vtable->pixdata(state->device, qp_internal_global_pixdata_buffer, state->pixel_write_pos)) {
+        if (!qp_internal_send_pixdata_and_swap(state->device, state->pixel_write_pos)) {
             return false;
         }
         state->pixel_write_pos = 0;
     }
 
-    return true;
+    return driver->driver_vtable->append_pixels(state->device, qp_internal_global_pixdata_buffer, palette, state->pixel_write_pos++, 1, &index);
 }
 
 bool qp_internal_byte_appender(uint8_t byteval, void* cb_arg) {
     qp_internal_byte_output_state_t* state  = (qp_internal_byte_output_state_t*)cb_arg;
     painter_driver_t*                driver = (painter_driver_t*)state->device;
 
-    if (!driver->driver_vtable->append_pixdata(state->device, qp_internal_global_pixdata_buffer, state->byte_write_pos++, byteval)) {
-        return false;
-    }
-
-    // If we've hit the transmit limit, send out the entire buffer and reset the write position
+    // If we've hit the transmit limit, send out the entire buffer and reset the write position, as above
     if (state->byte_write_pos == state->max_bytes) {
-        painter_driver_t* driver = (painter_driver_t*)state->device;
-        if (!driver->driver_vtable->pixdata(state->device, qp_internal_global_pixdata_buffer, state->byte_write_pos * 8 / driver->native_bits_per_pixel)) {
+        if (!qp_internal_send_pixdata_and_swap(state->device, state->byte_write_pos * 8 / driver->native_bits_per_pixel)) {
             return false;
         }
         state->byte_write_pos = 0;
     }
 
+    return driver->driver_vtable->append_pixdata(state->device, qp_internal_global_pixdata_buffer, state->byte_write_pos++, byteval);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Run-granular pull of bytes, push of pixels
+
+// Number of pixels decoded at a time when working with whole runs
+#define QP_INTERNAL_DECODE_BATCH_PIXELS 64
+
+// Reads up to max_bytes from the stream, stopping at the end of the current RLE run if compressed. Leaves the input
+// state as qp_drawimage_byte_rle_decoder would, so the two can be mixed. Returns the number of bytes read, or -1 on
+// failure.
+static int16_t qp_internal_read_bytes(qp_internal_byte_input_state_t* state, bool rle, uint8_t* bytes, uint8_t max_bytes) {
+    if (!rle) {
+        uint32_t count = qp_stream_read(bytes, 1, max_bytes, state->src_stream);
+        return count > 0 ? (int16_t)count : -1;
+    }
+
+    // Work out if we're parsing the initial marker byte
+    if (state->rle.mode == MARKER_BYTE) {
+        int16_t c = qp_stream_get(state->src_stream);
+        if (c < 0) {
+            return -1;
+        }
+        if (c >= 128) {
+            state->rle.mode   = NON_REPEATING_RUN; // non-repeated run
+            state->rle.remain = c - 127;
+        } else {
+            state->rle.mode   = REPEATING_RUN; // repeated run
+            state->rle.remain = c;
+        }
+
+        state->curr = qp_stream_get(state->src_stream);
+        if (state->curr < 0) {
+            return -1;
+        }
+    }
+
+    uint8_t count = state->rle.remain < max_bytes ? state->rle.remain : max_bytes;
+    if (count > 0) {
+        if (state->rle.mode == REPEATING_RUN) {
+            memset(bytes, state->curr, count);
+        } else {
+            bytes[0] = state->curr;
+            if (count > 1 && qp_stream_read(&bytes[1], 1, count - 1, state->src_stream) != count - 1) {
+                return -1;
+            }
+        }
+    }
+
+    state->rle.remain -= count;
+    if (state->rle.remain > 0) {
+        // If we're in a non-repeating run, queue up the next byte
+        if (state->rle.mode == NON_REPEATING_RUN) {
+            state->curr = qp_stream_get(state->src_stream);
+        }
+    } else {
+        // Swap back to querying the marker byte mode
+        state->rle.mode = MARKER_BYTE;
+    }
+
+    return count;
+}
+
+// Equivalent of qp_internal_decode_palette + qp_internal_pixel_appender, converting a batch of pixels at a time
+static bool qp_internal_append_palette_runs(painter_device_t device, uint32_t pixel_count, uint8_t bits_per_pixel, qp_internal_byte_input_state_t* input_state, bool rle, qp_internal_pixel_output_state_t* output_state) {
+    painter_driver_t* driver          = (painter_driver_t*)device;
+    const uint8_t     pixel_bitmask   = (1 << bits_per_pixel) - 1;
+    const uint8_t     pixels_per_byte = 8 / bits_per_pixel;
+
+    uint8_t  bytes[QP_INTERNAL_DECODE_BATCH_PIXELS];
+    uint8_t  indices[QP_INTERNAL_DECODE_BATCH_PIXELS];
+    uint32_t remaining_pixels = pixel_count;
+    while (remaining_pixels > 0) {
+        uint8_t batch_pixels = remaining_pixels < QP_INTERNAL_DECODE_BATCH_PIXELS ? remaining_pixels : QP_INTERNAL_DECODE_BATCH_PIXELS;
+        int16_t byte_count   = qp_internal_read_bytes(input_state, rle, bytes, (batch_pixels + pixels_per_byte - 1) / pixels_per_byte);
+        if (byte_count < 0) {
+            return false;
+        }
+
+        // Unpack the palette indices, ignoring any pixels in the last byte beyond the end of the image
+        if (byte_count * pixels_per_byte < batch_pixels) {
+            batch_pixels = byte_count * pixels_per_byte;
+        }
+        for (uint8_t i = 0; i < batch_pixels; ++i) {
+            indices[i] = (bytes[i / pixels_per_byte] >> ((i % pixels_per_byte) * bits_per_pixel)) & pixel_bitmask;
+        }
+
+        // Hand the pixels to the driver as a whole, unless they straddle the end of the buffer. As with
+        // qp_internal_pixel_appender, the buffer is sent only once there's another pixel to write.
+        uint8_t offset = 0;
+        while (offset < batch_pixels) {
+            if (output_state->pixel_write_pos == output_state->max_pixels) {
+                if (!qp_internal_send_pixdata_and_swap(device, output_state->pixel_write_pos)) {
+                    return false;
+                }
+                output_state->pixel_write_pos = 0;
+            }
+
+            uint32_t room  = output_state->max_pixels - output_state->pixel_write_pos;
+            uint8_t  count = (batch_pixels - offset) < room ? (batch_pixels - offset) : room;
+            if (!driver->driver_vtable->append_pixels(device, qp_internal_global_pixdata_buffer, qp_internal_global_pixel_lookup_table, output_state->pixel_write_pos, count, &indices[offset])) {
+                return false;
+            }
+            output_state->pixel_write_pos += count;
+            offset += count;
+        }
+
+        remaining_pixels -= batch_pixels;
+    }
+    return true;
+}
+
+// Equivalent of qp_internal_send_bytes + qp_internal_byte_appender, reading a run of bytes at a time
+static bool qp_internal_append_native_runs(uint32_t byte_count, qp_internal_byte_input_state_t* input_state, bool rle, qp_internal_byte_output_state_t* output_state) {
+    uint8_t  bytes[QP_INTERNAL_DECODE_BATCH_PIXELS];
+    uint32_t remaining_bytes = byte_count;
+    while (remaining_bytes > 0) {
+        int16_t count = qp_internal_read_bytes(input_state, rle, bytes, remaining_bytes < sizeof(bytes) ? remaining_bytes : sizeof(bytes));
+        if (count < 0) {
+            return false;
+        }
+        for (int16_t i = 0; i < count; ++i) {
+            if (!qp_internal_byte_appender(bytes[i], output_state)) {
+                return false;
+            }
+        }
+        remaining_bytes -= count;
+    }
     return true;
 }
 
@@ -171,13 +292,21 @@ bool qp_internal_appender(painter_device_t device, uint8_t bpp, uint32_t pixel_c
 
     bool ret = false;
 
+    // The decoders from qp_internal_prepare_input_state can be worked with a run at a time, rather than a byte at a time
+    bool is_rle  = input_callback == qp_drawimage_byte_rle_decoder;
+    bool is_bulk = is_rle || input_callback == qp_drawimage_byte_uncompressed_decoder;
+
     // Non-native pixel format
     if (bpp <= 8) {
         // Set up the output state
         qp_internal_pixel_output_state_t output_state = {.device = device, .pixel_write_pos = 0, .max_pixels = qp_internal_num_pixels_in_buffer(device)};
 
         // Decode the pixel data and stream to the display
-        ret = qp_internal_decode_palette(device, pixel_count, bpp, input_callback, input_state, qp_internal_global_pixel_lookup_table, qp_internal_pixel_appender, &output_state);
+        if (is_bulk) {
+            ret = qp_internal_append_palette_runs(device, pixel_count, bpp, (qp_internal_byte_input_state_t*)input_state, is_rle, &output_state);
+        } else {
+            ret = qp_internal_decode_palette(device, pixel_count, bpp, input_callback, input_state, qp_internal_global_pixel_lookup_table, qp_internal_pixel_appender, &output_state);
+        }
         // Any leftovers need transmission as well.
         if (ret && output_state.pixel_write_pos > 0) {
             ret &= driver->driver_vtable->pixdata(device, qp_internal_global_pixdata_buffer, output_state.pixel_write_pos);
@@ -194,7 +323,11 @@ bool qp_internal_appender(painter_device_t device, uint8_t bpp, uint32_t pixel_c
 
         // Stream the raw pixel data to the display
         uint32_t byte_count = pixel_count * bpp / 8;
-        ret                 = qp_internal_send_bytes(device, byte_count, input_callback, input_state, qp_internal_byte_appender, &output_state);
+        if (is_bulk) {
+            ret = qp_internal_append_native_runs(byte_count, (qp_internal_byte_input_state_t*)input_state, is_rle, &output_state);
+        } else {
+            ret = qp_internal_send_bytes(device, byte_count, input_callback, input_state, qp_internal_byte_appender, &output_state);
+        }
         // Any leftovers need transmission as well.
         if (ret && output_state.byte_write_pos > 0) {
             ret &= driver->driver_vtable->pixdata(device, qp_internal_global_pixdata_buffer, output_state.byte_write_pos * 8 / driver->native_bits_per_pixel);
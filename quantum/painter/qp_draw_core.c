@@ -21,7 +21,13 @@ STATIC_ASSERT((QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE > 0) && (QUANTUM_PAINTER_PIXD
 //
 
 // Buffer used for transmitting native pixel data to the downstream device.
+#if QUANTUM_PAINTER_SUPPORTS_ASYNC_PIXDATA
+// Two of them, swapped by qp_internal_send_pixdata_and_swap() so that one can be filled while the other is being sent.
+__attribute__((__aligned__(4))) static uint8_t qp_internal_pixdata_buffers[2][QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE];
+uint8_t                                       *qp_internal_global_pixdata_buffer = qp_internal_pixdata_buffers[0];
+#else  // QUANTUM_PAINTER_SUPPORTS_ASYNC_PIXDATA
 __attribute__((__aligned__(4))) uint8_t qp_internal_global_pixdata_buffer[QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE];
+#endif // QUANTUM_PAINTER_SUPPORTS_ASYNC_PIXDATA
 
 // Static buffer to contain a generated color palette
 static bool                                       generated_palette = false;
@@ -34,6 +40,17 @@ __attribute__((__aligned__(4))) qp_pixel_t qp_internal_global_pixel_lookup_table
 __attribute__((__aligned__(4))) qp_pixel_t qp_internal_global_pixel_lookup_table[16];
 #endif
 
+#if QUANTUM_PAINTER_PALETTE_CACHE
+// The QGF palette last converted into the lookup table, and the device it was converted for
+static painter_device_t converted_palette_device = NULL;
+static uint8_t          converted_palette_bpp    = 0;
+#    if QUANTUM_PAINTER_SUPPORTS_256_PALETTE
+static qgf_palette_entry_v1_t converted_palette[256];
+#    else
+static qgf_palette_entry_v1_t converted_palette[16];
+#    endif
+#endif // QUANTUM_PAINTER_PALETTE_CACHE
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Helpers
 
@@ -48,6 +65,20 @@ bool qp_internal_setpixel_impl(painter_device_t device, uint16_t x, uint16_t y)
     return driver->driver_vtable->viewport(device, x, y, x, y) && driver->driver_vtable->pixdata(device, qp_internal_global_pixdata_buffer, 1);
 }
 
+// Sends the first native_pixel_count pixels of the global native pixel buffer, for callers which are going to refill it straight away.
+bool qp_internal_send_pixdata_and_swap(painter_device_t device, uint32_t native_pixel_count) {
+    painter_driver_t *driver = (painter_driver_t *)device;
+    if (!driver->driver_vtable->pixdata(device, qp_internal_global_pixdata_buffer, native_pixel_count)) {
+        return false;
+    }
+
+#if QUANTUM_PAINTER_SUPPORTS_ASYNC_PIXDATA
+    // These pixels may still be being sent, so carry on in the other buffer -- the next send waits for this one first
+    qp_internal_global_pixdata_buffer = (qp_internal_global_pixdata_buffer == qp_internal_pixdata_buffers[0]) ? qp_internal_pixdata_buffers[1] : qp_internal_pixdata_buffers[0];
+#endif // QUANTUM_PAINTER_SUPPORTS_ASYNC_PIXDATA
+    return true;
+}
+
 // Fills the global native pixel buffer with equivalent pixels matching the supplied HSV
 void qp_internal_fill_pixdata(painter_device_t device, uint32_t num_pixels, uint8_t hue, uint8_t sat, uint8_t val) {
     painter_driver_t *driver            = (painter_driver_t *)device;
@@ -69,6 +100,9 @@ void qp_internal_fill_pixdata(painter_device_t device, uint32_t num_pixels, uint
 void qp_internal_invalidate_palette(void) {
     generated_palette = false;
     generated_steps   = -1;
+#if QUANTUM_PAINTER_PALETTE_CACHE
+    converted_palette_device = NULL;
+#endif // QUANTUM_PAINTER_PALETTE_CACHE
 }
 
 // Interpolates between two colors to generate a palette
@@ -80,6 +114,11 @@ bool qp_internal_interpolate_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888,
         return false;
     }
 
+#if QUANTUM_PAINTER_PALETTE_CACHE
+    // The lookup table no longer holds a QGF palette
+    converted_palette_device = NULL;
+#endif // QUANTUM_PAINTER_PALETTE_CACHE
+
     // Save the parameters so we know whether we can skip generation
     generated_palette      = true;
     generated_steps        = steps;
@@ -109,7 +148,9 @@ bool qp_internal_interpolate_palette(qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888,
 }
 
 // Helper shared between image and font rendering -- sets up the global palette to match the palette block specified in the asset. Expects the stream to be positioned at the start of the block header.
-bool qp_internal_load_qgf_palette(qp_stream_t *stream, uint8_t bpp) {
+bool qp_internal_load_qgf_palette(painter_device_t device, qp_stream_t *stream, uint8_t bpp) {
+    painter_driver_t *driver = (painter_driver_t *)device;
+
     qgf_palette_v1_t palette_descriptor;
     if (qp_stream_read(&palette_descriptor, sizeof(qgf_palette_v1_t), 1, stream) != 1) {
         qp_dprintf("Failed to read palette_descriptor, expected length was not %d\n", (int)sizeof(qgf_palette_v1_t));
@@ -119,6 +160,39 @@ bool qp_internal_load_qgf_palette(qp_stream_t *stream, uint8_t bpp) {
     // BPP determines the number of palette entries, each entry is a HSV888 triplet.
     const uint16_t palette_entries = 1u << bpp;
 
+#if QUANTUM_PAINTER_PALETTE_CACHE
+    // Read the palette entries, checking whether they match those already converted for this device
+    bool changed = converted_palette_device != device || converted_palette_bpp != bpp;
+    for (uint16_t i = 0; i < palette_entries; ++i) {
+        qgf_palette_entry_v1_t entry;
+        if (qp_stream_read(&entry, sizeof(qgf_palette_entry_v1_t), 1, stream) != 1) {
+            qp_internal_invalidate_palette();
+            return false;
+        }
+
+        if (memcmp(&converted_palette[i], &entry, sizeof(entry)) != 0) {
+            converted_palette[i] = entry;
+            changed              = true;
+        }
+    }
+
+    if (!changed) {
+        qp_dprintf("qp_internal_load_qgf_palette: reusing the converted palette\n");
+        return true;
+    }
+
+    // Ensure we aren't reusing any palette
+    qp_internal_invalidate_palette();
+
+    // Update the lookup table
+    for (uint16_t i = 0; i < palette_entries; ++i) {
+        qp_internal_global_pixel_lookup_table[i].hsv888.h = converted_palette[i].h;
+        qp_internal_global_pixel_lookup_table[i].hsv888.s = converted_palette[i].s;
+        qp_internal_global_pixel_lookup_table[i].hsv888.v = converted_palette[i].v;
+
+        qp_dprintf("qp_internal_load_qgf_palette: %3d of %d -- H: %3d, S: %3d, V: %3d\n", (int)(i + 1), (int)palette_entries, (int)qp_internal_global_pixel_lookup_table[i].hsv888.h, (int)qp_internal_global_pixel_lookup_table[i].hsv888.s, (int)qp_internal_global_pixel_lookup_table[i].hsv888.v);
+    }
+#else  // QUANTUM_PAINTER_PALETTE_CACHE
     // Ensure we aren't reusing any palette
     qp_internal_invalidate_palette();
 
@@ -137,7 +211,18 @@ bool qp_internal_load_qgf_palette(qp_stream_t *stream, uint8_t bpp) {
 
         qp_dprintf("qp_internal_load_qgf_palette: %3d of %d -- H: %3d, S: %3d, V: %3d\n", (int)(i + 1), (int)palette_entries, (int)qp_internal_global_pixel_lookup_table[i].hsv888.h, (int)qp_internal_global_pixel_lookup_table[i].hsv888.s, (int)qp_internal_global_pixel_lookup_table[i].hsv888.v);
     }
+#endif // QUANTUM_PAINTER_PALETTE_CACHE
+
+    // Convert the palette to native format
+    if (!driver->driver_vtable->palette_convert(device, palette_entries, qp_internal_global_pixel_lookup_table)) {
+        qp_dprintf("qp_internal_load_qgf_palette: fail (could not convert pixels to native)\n");
+        return false;
+    }
 
+#if QUANTUM_PAINTER_PALETTE_CACHE
+    converted_palette_device = device;
+    converted_palette_bpp    = bpp;
+#endif // QUANTUM_PAINTER_PALETTE_CACHE
     return true;
 }
 
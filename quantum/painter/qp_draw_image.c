@@ -148,9 +148,6 @@ static bool qp_drawimage_prepare_frame_for_stream_read(painter_device_t device,
         return false;
     }
 
-    // Ensure we aren't reusing any palette
-    qp_internal_invalidate_palette();
-
     if (!qp_internal_bpp_capable(info->bpp)) {
         qp_dprintf("qp_drawimage_recolor: fail (image bpp too high (%d), check QUANTUM_PAINTER_SUPPORTS_256_PALETTE or QUANTUM_PAINTER_SUPPORTS_NATIVE_COLORS)\n", (int)info->bpp);
         qp_comms_stop(device);
@@ -161,13 +158,14 @@ static bool qp_drawimage_prepare_frame_for_stream_read(painter_device_t device,
     const uint16_t palette_entries  = 1u << info->bpp;
     bool           needs_pixconvert = false;
     if (info->has_palette) {
-        // Load the palette from the stream
-        if (!qp_internal_load_qgf_palette((qp_stream_t *)&qgf_image->stream, info->bpp)) {
+        // Load the palette from the stream, reusing the converted palette if it's the same as the previous frame's
+        if (!qp_internal_load_qgf_palette(device, (qp_stream_t *)&qgf_image->stream, info->bpp)) {
             return false;
         }
-
-        needs_pixconvert = true;
     } else {
+        // Ensure we aren't reusing any palette
+        qp_internal_invalidate_palette();
+
         if (info->bpp <= 8) {
             // Interpolate from fg/bg
             needs_pixconvert = qp_internal_interpolate_palette(fg_hsv888, bg_hsv888, palette_entries);
@@ -12,11 +12,19 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // QFF font handles
 
+#if QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+typedef struct qff_glyph_cache_entry_t {
+    uint32_t code_point;
+    uint32_t value; // Uses QFF_GLYPH_*_(BITS|MASK), as per the unicode glyph table
+} qff_glyph_cache_entry_t;
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+
 typedef struct qff_font_handle_t {
     painter_font_desc_t   base;
     bool                  validate_ok;
     bool                  has_ascii_table;
     uint16_t              num_unicode_glyphs;
+    bool                  unicode_table_sorted;
     uint8_t               bpp;
     bool                  has_palette;
     bool                  is_panel_native;
@@ -32,10 +40,67 @@ typedef struct qff_font_handle_t {
     bool  owns_buffer;
     void *buffer;
 #endif // QUANTUM_PAINTER_LOAD_FONTS_TO_RAM
+#if QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+    uint8_t                 glyph_cache_count;
+    qff_glyph_cache_entry_t glyph_cache[QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE]; // most recently used first
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+#if QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+    uint32_t font_id; // unique to each load, so that text cached for a closed font is never used for another
+#endif // QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
 } qff_font_handle_t;
 
 static qff_font_handle_t font_descriptors[QUANTUM_PAINTER_NUM_FONTS] = {0};
 
+#if QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+static uint32_t last_font_id = 0;
+#endif // QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers: unicode glyph table
+
+static inline uint32_t qff_unicode_glyph_info_offset(qff_font_handle_t *qff_font, uint16_t index) {
+    return sizeof(qff_font_descriptor_v1_t)                                       // Skip the font descriptor
+           + (qff_font->has_ascii_table ? sizeof(qff_ascii_glyph_table_v1_t) : 0) // Skip the ascii table
+           + sizeof(qgf_block_header_v1_t)                                        // Skip the unicode block header
+           + index * sizeof(qff_unicode_glyph_v1_t);                              // Jump direct to the glyph
+}
+
+static bool qff_read_unicode_glyph_info(qff_font_handle_t *qff_font, uint16_t index, qff_unicode_glyph_v1_t *glyph_info) {
+    if (qp_stream_setpos(&qff_font->stream, qff_unicode_glyph_info_offset(qff_font, index)) < 0) {
+        qp_dprintf("Failed to set stream position while reading unicode glyph info\n");
+        return false;
+    }
+
+    if (qp_stream_read(glyph_info, sizeof(qff_unicode_glyph_v1_t), 1, &qff_font->stream) != 1) {
+        qp_dprintf("Failed to read unicode glyph info\n");
+        return false;
+    }
+
+    return true;
+}
+
+// The QFF generator writes the unicode table in code point order, allowing it to be binary searched. Fonts made by
+// other means may not be, in which case the table is searched from the start.
+static bool qff_unicode_table_is_sorted(qff_font_handle_t *qff_font) {
+    if (qp_stream_setpos(&qff_font->stream, qff_unicode_glyph_info_offset(qff_font, 0)) < 0) {
+        return false;
+    }
+
+    qff_unicode_glyph_v1_t glyph_info;
+    uint32_t               last_code_point = 0;
+    for (uint16_t i = 0; i < qff_font->num_unicode_glyphs; ++i) {
+        if (qp_stream_read(&glyph_info, sizeof(qff_unicode_glyph_v1_t), 1, &qff_font->stream) != 1) {
+            return false;
+        }
+        if (i > 0 && glyph_info.code_point <= last_code_point) {
+            return false;
+        }
+        last_code_point = glyph_info.code_point;
+    }
+
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Helper: load font from stream
 
@@ -99,6 +164,13 @@ static painter_font_handle_t qp_load_font_internal(bool (*stream_factory)(qff_fo
 
     // Read the info (parsing already successful above, no need to check return value)
     qff_read_font_descriptor(&font->stream, &font->base.line_height, &font->has_ascii_table, &font->num_unicode_glyphs, &font->bpp, &font->has_palette, &font->is_panel_native, &font->compression_scheme, NULL);
+    font->unicode_table_sorted = qff_unicode_table_is_sorted(font);
+#if QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+    font->glyph_cache_count = 0;
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+#if QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+    font->font_id = ++last_font_id;
+#endif // QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
 
     if (!qp_internal_bpp_capable(font->bpp)) {
         qp_dprintf("qp_load_font: fail (image bpp too high (%d), check QUANTUM_PAINTER_SUPPORTS_256_PALETTE or QUANTUM_PAINTER_SUPPORTS_NATIVE_COLORS)\n", (int)font->bpp);
@@ -188,13 +260,12 @@ static inline bool qp_drawtext_prepare_font_for_render(painter_device_t device,
     if (qff_font->has_palette) {
         // If this font has a palette, we need to read it out and set up the pixel lookup table
         qp_stream_setpos(&qff_font->stream, offset);
-        if (!qp_internal_load_qgf_palette(&qff_font->stream, qff_font->bpp)) {
+        if (!qp_internal_load_qgf_palette(device, &qff_font->stream, qff_font->bpp)) {
             return false;
         }
 
         // Skip this block, as far as offset calculations go
         offset += sizeof(qgf_palette_v1_t) + (palette_entries * 3);
-        needs_pixconvert = true;
     } else {
         // Interpolate from fg/bg
         int16_t palette_entries = 1 << qff_font->bpp;
@@ -214,7 +285,95 @@ static inline bool qp_drawtext_prepare_font_for_render(painter_device_t device,
     return true;
 }
 
+#if QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+static bool qff_glyph_cache_find(qff_font_handle_t *qff_font, uint32_t code_point, uint32_t *value) {
+    for (uint8_t i = 0; i < qff_font->glyph_cache_count; ++i) {
+        if (qff_font->glyph_cache[i].code_point == code_point) {
+            qff_glyph_cache_entry_t entry = qff_font->glyph_cache[i];
+
+            // Move it to the front
+            memmove(&qff_font->glyph_cache[1], &qff_font->glyph_cache[0], i * sizeof(qff_glyph_cache_entry_t));
+            qff_font->glyph_cache[0] = entry;
+
+            *value = entry.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void qff_glyph_cache_insert(qff_font_handle_t *qff_font, uint32_t code_point, uint32_t value) {
+    // Drop the least recently used entry if the cache is full
+    if (qff_font->glyph_cache_count < QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE) {
+        qff_font->glyph_cache_count++;
+    }
+
+    memmove(&qff_font->glyph_cache[1], &qff_font->glyph_cache[0], (qff_font->glyph_cache_count - 1) * sizeof(qff_glyph_cache_entry_t));
+    qff_font->glyph_cache[0] = (qff_glyph_cache_entry_t){.code_point = code_point, .value = value};
+}
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+
+// Helper that finds a glyph in the unicode table, returning its QFF_GLYPH_*_(BITS|MASK) value
+static bool qff_find_unicode_glyph(qff_font_handle_t *qff_font, uint32_t code_point, uint32_t *value) {
+#if QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+    if (qff_glyph_cache_find(qff_font, code_point, value)) {
+        return true;
+    }
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+
+    qff_unicode_glyph_v1_t glyph_info;
+    bool                   found = false;
+    if (qff_font->unicode_table_sorted) {
+        uint16_t lo = 0;
+        uint16_t hi = qff_font->num_unicode_glyphs;
+        while (lo < hi) {
+            uint16_t mid = lo + (hi - lo) / 2;
+            if (!qff_read_unicode_glyph_info(qff_font, mid, &glyph_info)) {
+                return false;
+            }
+
+            if (glyph_info.code_point == code_point) {
+                found = true;
+                break;
+            } else if (glyph_info.code_point < code_point) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+    } else {
+        if (qp_stream_setpos(&qff_font->stream, qff_unicode_glyph_info_offset(qff_font, 0)) < 0) {
+            qp_dprintf("Failed to set stream position while preparing glyph data\n");
+            return false;
+        }
+
+        for (uint16_t i = 0; i < qff_font->num_unicode_glyphs; ++i) {
+            if (qp_stream_read(&glyph_info, sizeof(qff_unicode_glyph_v1_t), 1, &qff_font->stream) != 1) {
+                qp_dprintf("Failed to set stream position while reading unicode glyph info\n");
+                return false;
+            }
+
+            if (glyph_info.code_point == code_point) {
+                found = true;
+                break;
+            }
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+
+#if QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+    qff_glyph_cache_insert(qff_font, code_point, glyph_info.value);
+#endif // QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE > 0
+
+    *value = glyph_info.value;
+    return true;
+}
+
 static inline bool qp_drawtext_prepare_glyph_for_render(qff_font_handle_t *qff_font, uint32_t code_point, uint8_t *width) {
+    uint32_t glyph_value;
     if (code_point >= 0x20 && code_point < 0x7F && qff_font->has_ascii_table) {
         // Do ascii table
         qff_ascii_glyph_v1_t glyph_info;
@@ -231,65 +390,31 @@ static inline bool qp_drawtext_prepare_glyph_for_render(qff_font_handle_t *qff_f
             return false;
         }
 
-        uint8_t  glyph_width  = (uint8_t)(glyph_info.value & QFF_GLYPH_WIDTH_MASK);
-        uint32_t glyph_offset = ((glyph_info.value & QFF_GLYPH_OFFSET_MASK) >> QFF_GLYPH_WIDTH_BITS);
-        uint32_t data_offset  = sizeof(qff_font_descriptor_v1_t)                                                                                                                   // Skip the font descriptor
-                               + (qff_font->has_ascii_table ? sizeof(qff_ascii_glyph_table_v1_t) : 0)                                                                              // Skip the ascii table
-                               + (qff_font->num_unicode_glyphs > 0 ? (sizeof(qff_unicode_glyph_table_v1_t) + (qff_font->num_unicode_glyphs * sizeof(qff_unicode_glyph_v1_t))) : 0) // Skip the unicode table
-                               + (qff_font->has_palette ? (sizeof(qgf_palette_v1_t) + ((1 << qff_font->bpp) * sizeof(qgf_palette_entry_v1_t))) : 0)                                // Skip the palette
-                               + sizeof(qgf_block_header_v1_t)                                                                                                                     // Skip the data block header
-                               + glyph_offset;                                                                                                                                     // Jump to the specified glyph offset
-
-        if (qp_stream_setpos(&qff_font->stream, data_offset) < 0) {
-            qp_dprintf("Failed to set stream position while preparing ascii glyph data\n");
-            return false;
-        }
-
-        *width = glyph_width;
-        return true;
+        glyph_value = glyph_info.value;
     } else {
         // Do unicode table, which may include singular ascii glyphs if full ascii table isn't specified
-        uint32_t glyph_info_offset = sizeof(qff_font_descriptor_v1_t)                                       // Skip the font descriptor
-                                     + (qff_font->has_ascii_table ? sizeof(qff_ascii_glyph_table_v1_t) : 0) // Skip the ascii table
-                                     + sizeof(qgf_block_header_v1_t);                                       // Skip the unicode block header
-
-        if (qp_stream_setpos(&qff_font->stream, glyph_info_offset) < 0) {
-            qp_dprintf("Failed to set stream position while preparing glyph data\n");
+        if (!qff_find_unicode_glyph(qff_font, code_point, &glyph_value)) {
+            qp_dprintf("Failed to find unicode glyph info\n");
             return false;
         }
+    }
 
-        qff_unicode_glyph_v1_t glyph_info;
-        for (uint16_t i = 0; i < qff_font->num_unicode_glyphs; ++i) {
-            if (qp_stream_read(&glyph_info, sizeof(qff_unicode_glyph_v1_t), 1, &qff_font->stream) != 1) {
-                qp_dprintf("Failed to set stream position while reading unicode glyph info\n");
-                return false;
-            }
-
-            if (glyph_info.code_point == code_point) {
-                uint8_t  glyph_width  = (uint8_t)(glyph_info.value & QFF_GLYPH_WIDTH_MASK);
-                uint32_t glyph_offset = ((glyph_info.value & QFF_GLYPH_OFFSET_MASK) >> QFF_GLYPH_WIDTH_BITS);
-                uint32_t data_offset  = sizeof(qff_font_descriptor_v1_t)                                                                                                                   // Skip the font descriptor
-                                       + (qff_font->has_ascii_table ? sizeof(qff_ascii_glyph_table_v1_t) : 0)                                                                              // Skip the ascii table
-                                       + (qff_font->num_unicode_glyphs > 0 ? (sizeof(qff_unicode_glyph_table_v1_t) + (qff_font->num_unicode_glyphs * sizeof(qff_unicode_glyph_v1_t))) : 0) // Skip the unicode table
-                                       + (qff_font->has_palette ? (sizeof(qgf_palette_v1_t) + ((1 << qff_font->bpp) * sizeof(qgf_palette_entry_v1_t))) : 0)                                // Skip the palette
-                                       + sizeof(qgf_block_header_v1_t)                                                                                                                     // Skip the data block header
-                                       + glyph_offset;                                                                                                                                     // Jump to the specified glyph offset
-
-                if (qp_stream_setpos(&qff_font->stream, data_offset) < 0) {
-                    qp_dprintf("Failed to set stream position while preparing unicode glyph data\n");
-                    return false;
-                }
-
-                *width = glyph_width;
-                return true;
-            }
-        }
-
-        // Not found
-        qp_dprintf("Failed to find unicode glyph info\n");
+    uint8_t  glyph_width  = (uint8_t)(glyph_value & QFF_GLYPH_WIDTH_MASK);
+    uint32_t glyph_offset = ((glyph_value & QFF_GLYPH_OFFSET_MASK) >> QFF_GLYPH_WIDTH_BITS);
+    uint32_t data_offset  = sizeof(qff_font_descriptor_v1_t)                                                                                                                   // Skip the font descriptor
+                           + (qff_font->has_ascii_table ? sizeof(qff_ascii_glyph_table_v1_t) : 0)                                                                              // Skip the ascii table
+                           + (qff_font->num_unicode_glyphs > 0 ? (sizeof(qff_unicode_glyph_table_v1_t) + (qff_font->num_unicode_glyphs * sizeof(qff_unicode_glyph_v1_t))) : 0) // Skip the unicode table
+                           + (qff_font->has_palette ? (sizeof(qgf_palette_v1_t) + ((1 << qff_font->bpp) * sizeof(qgf_palette_entry_v1_t))) : 0)                                // Skip the palette
+                           + sizeof(qgf_block_header_v1_t)                                                                                                                     // Skip the data block header
+                           + glyph_offset;                                                                                                                                     // Jump to the specified glyph offset
+
+    if (qp_stream_setpos(&qff_font->stream, data_offset) < 0) {
+        qp_dprintf("Failed to set stream position while preparing glyph data\n");
         return false;
     }
-    return false;
+
+    *width = glyph_width;
+    return true;
 }
 
 // Function to iterate over each UTF8 codepoint, invoking the callback for each decoded glyph
@@ -316,6 +441,63 @@ static inline bool qp_iterate_code_points(qff_font_handle_t *qff_font, const cha
     return true;
 }
 
+#if QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Text cache
+
+// Each entry is followed by the glyph's native pixel data, padded to keep the next entry aligned
+typedef struct qp_text_cache_entry_t {
+    uint32_t font_id;
+    uint32_t code_point;
+    uint16_t length;    // bytes of native pixel data
+    uint8_t  colors[6]; // foreground then background hsv888
+} qp_text_cache_entry_t;
+
+STATIC_ASSERT(sizeof(qp_text_cache_entry_t) % 4 == 0, "qp_text_cache_entry_t must keep the entries following it aligned");
+
+static inline uint32_t qp_text_cache_entry_size(uint16_t length) {
+    return sizeof(qp_text_cache_entry_t) + ((length + 3u) & ~3u);
+}
+
+static const qp_text_cache_entry_t *qp_text_cache_find(painter_driver_t *driver, qff_font_handle_t *qff_font, uint32_t code_point, const uint8_t colors[6]) {
+    uint32_t offset = 0;
+    while (offset < driver->text_cache_used) {
+        const qp_text_cache_entry_t *entry = (const qp_text_cache_entry_t *)&driver->text_cache[offset];
+        if (entry->font_id == qff_font->font_id && entry->code_point == code_point && memcmp(entry->colors, colors, sizeof(entry->colors)) == 0) {
+            return entry;
+        }
+        offset += qp_text_cache_entry_size(entry->length);
+    }
+    return NULL;
+}
+
+// Keeps the native pixels of a glyph which has just been drawn, which are still in the pixdata buffer if they fit
+static void qp_text_cache_insert(painter_driver_t *driver, qff_font_handle_t *qff_font, uint32_t code_point, const uint8_t colors[6], uint32_t pixel_count) {
+    if (pixel_count > qp_internal_num_pixels_in_buffer((painter_device_t)driver)) {
+        return;
+    }
+
+    uint16_t length = (pixel_count * driver->native_bits_per_pixel + 7) / 8;
+    uint32_t size   = qp_text_cache_entry_size(length);
+    if (size > driver->text_cache_size) {
+        return;
+    }
+
+    // Start again once full
+    if (driver->text_cache_used + size > driver->text_cache_size) {
+        driver->text_cache_used = 0;
+    }
+
+    qp_text_cache_entry_t *entry = (qp_text_cache_entry_t *)&driver->text_cache[driver->text_cache_used];
+    entry->font_id               = qff_font->font_id;
+    entry->code_point            = code_point;
+    entry->length                = length;
+    memcpy(entry->colors, colors, sizeof(entry->colors));
+    memcpy(entry + 1, qp_internal_global_pixdata_buffer, length);
+    driver->text_cache_used += size;
+}
+#endif // QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // String width calculation
 
@@ -345,6 +527,9 @@ typedef struct code_point_iter_drawglyph_state_t {
     qp_internal_byte_input_callback   input_callback;
     qp_internal_byte_input_state_t *  input_state;
     qp_internal_pixel_output_state_t *output_state;
+#if QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+    uint8_t colors[6];
+#endif // QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
 } code_point_iter_drawglyph_state_t;
 
 // Codepoint handler callback: drawing
@@ -364,9 +549,30 @@ static inline bool qp_font_code_point_handler_drawglyph(qff_font_handle_t *qff_f
     // Move the x-position for the next glyph
     state->xpos += width;
 
-    // Decode the pixel data for the glyph, and stream it
     uint32_t pixel_count = ((uint32_t)width) * height;
-    return qp_internal_appender(state->device, qff_font->bpp, pixel_count, state->input_callback, state->input_state);
+
+#if QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+    // Stream the cached pixels if this glyph has been drawn before
+    if (driver->text_cache) {
+        const qp_text_cache_entry_t *entry = qp_text_cache_find(driver, qff_font, code_point, state->colors);
+        if (entry) {
+            return driver->driver_vtable->pixdata(state->device, entry + 1, pixel_count);
+        }
+    }
+#endif // QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+
+    // Decode the pixel data for the glyph, and stream it
+    if (!qp_internal_appender(state->device, qff_font->bpp, pixel_count, state->input_callback, state->input_state)) {
+        return false;
+    }
+
+#if QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+    if (driver->text_cache) {
+        qp_text_cache_insert(driver, qff_font, code_point, state->colors, pixel_count);
+    }
+#endif // QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -438,6 +644,10 @@ int16_t qp_drawtext_recolor(painter_device_t device, uint16_t x, uint16_t y, pai
                                                .input_state    = &input_state,
                                                // Output
                                                .output_state = &output_state};
+#if QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+    const uint8_t colors[6] = {hue_fg, sat_fg, val_fg, hue_bg, sat_bg, val_bg};
+    memcpy(state.colors, colors, sizeof(state.colors));
+#endif // QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
 
     qp_pixel_t fg_hsv888 = {.hsv888 = {.h = hue_fg, .s = sat_fg, .v = val_fg}};
     qp_pixel_t bg_hsv888 = {.hsv888 = {.h = hue_bg, .s = sat_bg, .v = val_bg}};
@@ -455,3 +665,27 @@ int16_t qp_drawtext_recolor(painter_device_t device, uint16_t x, uint16_t y, pai
     qp_comms_stop(device);
     return ret ? (state.xpos - x) : 0;
 }
+
+#if QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_set_text_cache
+
+bool qp_set_text_cache(painter_device_t device, void *buffer, uint32_t buffer_size) {
+    painter_driver_t *driver = (painter_driver_t *)device;
+    if (!driver) {
+        qp_dprintf("qp_set_text_cache: fail (pointer to NULL)\n");
+        return false;
+    }
+
+    // Entries hold 32-bit values, so start on a 4-byte boundary
+    uint32_t misalignment = buffer ? (4 - ((uintptr_t)buffer & 3)) & 3 : 0;
+    if (buffer_size < misalignment) {
+        buffer_size = misalignment;
+    }
+
+    driver->text_cache      = buffer ? (uint8_t *)buffer + misalignment : NULL;
+    driver->text_cache_size = buffer ? buffer_size - misalignment : 0;
+    driver->text_cache_used = 0;
+    return true;
+}
+#endif // QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
@@ -38,12 +38,17 @@ typedef bool (*painter_driver_comms_init_func)(painter_device_t device);
 typedef bool (*painter_driver_comms_start_func)(painter_device_t device);
 typedef void (*painter_driver_comms_stop_func)(painter_device_t device);
 typedef uint32_t (*painter_driver_comms_send_func)(painter_device_t device, const void *data, uint32_t byte_count);
+typedef void (*painter_driver_comms_wait_func)(painter_device_t device);
 
 typedef struct painter_comms_vtable_t {
     painter_driver_comms_init_func  comms_init;
     painter_driver_comms_start_func comms_start;
     painter_driver_comms_stop_func  comms_stop;
     painter_driver_comms_send_func  comms_send;
+#if QUANTUM_PAINTER_SUPPORTS_ASYNC_PIXDATA
+    painter_driver_comms_send_func comms_send_async; // optional, may return while the data is still being sent
+    painter_driver_comms_wait_func comms_wait;       // optional, waits for comms_send_async to finish
+#endif // QUANTUM_PAINTER_SUPPORTS_ASYNC_PIXDATA
 } painter_comms_vtable_t;
 
 typedef void (*painter_driver_comms_send_command_func)(painter_device_t device, uint8_t cmd);
@@ -81,6 +86,13 @@ typedef struct painter_driver_t {
 
     // Comms config pointer -- needs to point to an appropriate comms config if the comms driver requires it.
     void *comms_config;
+
+#if QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
+    // Glyphs already converted to native pixels, see qp_set_text_cache()
+    uint8_t *text_cache;
+    uint32_t text_cache_size;
+    uint32_t text_cache_used;
+#endif // QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE
 } painter_driver_t;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -26,6 +26,7 @@
 #include "action_tapping.h"
 #include "action_util.h"
 #include "action.h"
+#include "debug.h"
 
 #ifdef VIAL_ENABLE
 #include "vial.h"
@@ -222,9 +223,113 @@ static inline uint16_t _get_combo_term(uint16_t combo_index, combo_t *combo) {
     return COMBO_TERM;
 }
 
+#ifdef COMBO_KEY_INDEX
+/* Inverted index from keycode to the combos containing it, sorted by keycode
+ * and then by combo index, so that a key event only has to visit the combos
+ * it is part of. Falls back to scanning every combo if the index does not fit. */
+typedef struct {
+    uint16_t keycode;
+    uint16_t combo_index;
+} combo_key_index_entry_t;
+
+static combo_key_index_entry_t combo_key_index[COMBO_KEY_INDEX_LENGTH];
+static uint16_t                combo_key_index_size  = 0;
+static bool                    combo_key_index_valid = false;
+
+/* Keycodes processed since the last clear_combos(); only their combos can
+ * have state that needs resetting. */
+static uint16_t combo_touched_keys[COMBO_KEY_BUFFER_LENGTH];
+static uint8_t  combo_touched_keys_size = 0;
+static bool     combo_touched_keys_overflow = false;
+
+/* Built at init and whenever the combos change, never on the keypress path. */
+void combo_key_index_rebuild(void) {
+    combo_key_index_size  = 0;
+    combo_key_index_valid = true;
+
+    for (uint16_t idx = 0; idx < combo_count(); ++idx) {
+        combo_t *combo = combo_get(idx);
+        uint16_t key;
+        for (uint8_t i = 0; (key = pgm_read_word(&combo->keys[i])) != COMBO_END; ++i) {
+            bool duplicate = false;
+            for (uint8_t j = 0; j < i; ++j) {
+                if (pgm_read_word(&combo->keys[j]) == key) {
+                    duplicate = true;
+                    break;
+                }
+            }
+            if (duplicate) {
+                continue;
+            }
+            if (combo_key_index_size == COMBO_KEY_INDEX_LENGTH) {
+                dprintf("combo: key index overflow, increase COMBO_KEY_INDEX_LENGTH\n");
+                combo_key_index_valid = false;
+                return;
+            }
+
+            /* Stable insertion, so entries for the same keycode stay in combo order. */
+            uint16_t pos = combo_key_index_size++;
+            while (pos > 0 && combo_key_index[pos - 1].keycode > key) {
+                combo_key_index[pos] = combo_key_index[pos - 1];
+                --pos;
+            }
+            combo_key_index[pos] = (combo_key_index_entry_t){.keycode = key, .combo_index = idx};
+        }
+    }
+}
+
+static inline bool combo_key_index_ready(void) {
+    return combo_key_index_valid;
+}
+
+/* Returns the first entry for keycode, the entries continue while the keycode matches. */
+static uint16_t combo_key_index_find(uint16_t keycode) {
+    uint16_t low = 0, high = combo_key_index_size;
+    while (low < high) {
+        uint16_t mid = low + (high - low) / 2;
+        if (combo_key_index[mid].keycode < keycode) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static void combo_touch_key(uint16_t keycode) {
+    for (uint8_t i = 0; i < combo_touched_keys_size; ++i) {
+        if (combo_touched_keys[i] == keycode) {
+            return;
+        }
+    }
+    if (combo_touched_keys_size < COMBO_KEY_BUFFER_LENGTH) {
+        combo_touched_keys[combo_touched_keys_size++] = keycode;
+    } else {
+        combo_touched_keys_overflow = true;
+    }
+}
+#endif
+
 void clear_combos(void) {
     uint16_t index = 0;
     longest_term   = 0;
+#ifdef COMBO_KEY_INDEX
+    if (combo_key_index_ready() && !combo_touched_keys_overflow) {
+        for (uint8_t i = 0; i < combo_touched_keys_size; ++i) {
+            for (index = combo_key_index_find(combo_touched_keys[i]); index < combo_key_index_size && combo_key_index[index].keycode == combo_touched_keys[i]; ++index) {
+                combo_t *combo = combo_get(combo_key_index[index].combo_index);
+                if (!COMBO_ACTIVE(combo)) {
+                    RESET_COMBO_STATE(combo);
+                }
+            }
+        }
+        /* Active combos keep their state, their keys are touched again on release. */
+        combo_touched_keys_size = 0;
+        return;
+    }
+    combo_touched_keys_size     = 0;
+    combo_touched_keys_overflow = false;
+#endif
     for (index = 0; index < combo_count(); ++index) {
         combo_t *combo = combo_get(index);
         if (!COMBO_ACTIVE(combo)) {
@@ -575,8 +680,7 @@ static combo_key_action_t process_single_combo(combo_t *combo, uint16_t keycode,
 }
 
 bool process_combo(uint16_t keycode, keyrecord_t *record) {
-    uint8_t is_combo_key          = COMBO_KEY_NOT_PRESSED;
-    bool    no_combo_keys_pressed = true;
+    uint8_t is_combo_key = COMBO_KEY_NOT_PRESSED;
 
     if (keycode == QK_COMBO_ON && record->event.pressed) {
         combo_enable();
@@ -604,10 +708,20 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     }
 #endif
 
-    for (uint16_t idx = 0; idx < combo_count(); ++idx) {
-        combo_t *combo = combo_get(idx);
-        is_combo_key |= process_single_combo(combo, keycode, record, idx);
-        no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+#ifdef COMBO_KEY_INDEX
+    if (combo_key_index_ready()) {
+        combo_touch_key(keycode);
+        for (uint16_t i = combo_key_index_find(keycode); i < combo_key_index_size && combo_key_index[i].keycode == keycode; ++i) {
+            uint16_t idx = combo_key_index[i].combo_index;
+            is_combo_key |= process_single_combo(combo_get(idx), keycode, record, idx);
+        }
+    } else
+#endif
+    {
+        for (uint16_t idx = 0; idx < combo_count(); ++idx) {
+            combo_t *combo = combo_get(idx);
+            is_combo_key |= process_single_combo(combo, keycode, record, idx);
+        }
     }
 
     if (record->event.pressed && is_combo_key) {
@@ -38,6 +38,13 @@
 #ifndef COMBO_BUFFER_LENGTH
 #    define COMBO_BUFFER_LENGTH 4
 #endif
+#if defined(COMBO_KEY_INDEX) && !defined(COMBO_KEY_INDEX_LENGTH)
+#    ifdef VIAL_COMBO_ENABLE
+#        define COMBO_KEY_INDEX_LENGTH (VIAL_COMBO_ENTRIES * 4)
+#    else
+#        define COMBO_KEY_INDEX_LENGTH 128
+#    endif
+#endif
 
 typedef struct combo_t {
     const uint16_t *keys;
@@ -77,6 +84,10 @@ bool process_combo(uint16_t keycode, keyrecord_t *record);
 void combo_task(void);
 void process_combo_event(uint16_t combo_index, bool pressed);
 
+#ifdef COMBO_KEY_INDEX
+void combo_key_index_rebuild(void);
+#endif
+
 void combo_enable(void);
 void combo_disable(void);
 void combo_toggle(void);
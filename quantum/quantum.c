@@ -89,6 +89,10 @@
 #    include "vial.h"
 #endif
 
+#ifdef EEPROM_DRIVER
+#    include "eeprom_driver.h"
+#endif
+
 #ifdef LAYER_LOCK_ENABLE
 #    include "process_layer_lock.h"
 #endif
@@ -217,6 +221,9 @@ __attribute__((weak)) void suspend_wakeup_init_modules(void) {}
 
 void shutdown_quantum(bool jump_to_bootloader) {
     clear_keyboard();
+#ifdef EEPROM_DRIVER
+    eeprom_driver_flush();
+#endif
 #if defined(MIDI_ENABLE) && defined(MIDI_BASIC)
     process_midi_all_notes_off();
 #endif
@@ -564,6 +571,9 @@ __attribute__((weak)) bool shutdown_kb(bool jump_to_bootloader) {
 void suspend_power_down_quantum(void) {
     suspend_power_down_modules();
     suspend_power_down_kb();
+#ifdef EEPROM_DRIVER
+    eeprom_driver_flush();
+#endif
 #ifndef NO_SUSPEND_POWER_DOWN
 // Turn off backlight
 #    ifdef BACKLIGHT_ENABLE
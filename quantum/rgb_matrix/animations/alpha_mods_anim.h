@@ -20,6 +20,7 @@ bool ALPHAS_MODS(effect_params_t* params) {
             rgb_matrix_set_color(i, rgb1.r, rgb1.g, rgb1.b);
         }
     }
+    rgb_matrix_effect_idle();
     return rgb_matrix_check_finished_leds(led_max);
 }
 
@@ -4,7 +4,7 @@ RGB_MATRIX_EFFECT(DUAL_BEACON)
 #    ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
 
 static hsv_t DUAL_BEACON_math(hsv_t hsv, int8_t sin, int8_t cos, uint8_t i, uint8_t time) {
-    hsv.h += ((g_led_config.point[i].y - k_rgb_matrix_center.y) * cos + (g_led_config.point[i].x - k_rgb_matrix_center.x) * sin) / 128;
+    hsv.h += (RGB_MATRIX_LED_DY(i) * cos + RGB_MATRIX_LED_DX(i) * sin) / 128;
     return hsv;
 }
 
@@ -16,6 +16,7 @@ bool GRADIENT_UP_DOWN(effect_params_t* params) {
         rgb_t rgb = rgb_matrix_hsv_to_rgb(hsv);
         rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
     }
+    rgb_matrix_effect_idle();
     return rgb_matrix_check_finished_leds(led_max);
 }
 
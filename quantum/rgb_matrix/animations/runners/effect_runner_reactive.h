@@ -4,6 +4,15 @@
 
 typedef hsv_t (*reactive_f)(hsv_t hsv, uint16_t offset);
 
+// true once every remembered hit has aged past the point where it affects any LED
+static inline bool effect_runner_reactive_settled(void) {
+    uint16_t max_tick = 65535 / qadd8(rgb_matrix_config.speed, 1);
+    for (uint8_t j = 0; j < g_last_hit_tracker.count; j++) {
+        if (g_last_hit_tracker.tick[j] < max_tick) return false;
+    }
+    return true;
+}
+
 bool effect_runner_reactive(effect_params_t* params, reactive_f effect_func) {
     RGB_MATRIX_USE_LIMITS(led_min, led_max);
 
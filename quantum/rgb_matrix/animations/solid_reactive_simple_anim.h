@@ -14,6 +14,9 @@ static hsv_t SOLID_REACTIVE_SIMPLE_math(hsv_t hsv, uint16_t offset) {
 }
 
 bool SOLID_REACTIVE_SIMPLE(effect_params_t* params) {
+#            if defined(RGB_MATRIX_IDLE_FRAME_SKIP) && !defined(RGB_MATRIX_SOLID_REACTIVE_GRADIENT_MODE)
+    if (effect_runner_reactive_settled()) rgb_matrix_effect_idle();
+#            endif
     return effect_runner_reactive(params, &SOLID_REACTIVE_SIMPLE_math);
 }
 
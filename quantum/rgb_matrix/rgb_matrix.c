@@ -22,6 +22,14 @@
 #include "keyboard.h"
 #include "sync_timer.h"
 #include "debug.h"
+#ifdef RGB_MATRIX_IDLE_FRAME_SKIP
+#    include "action_layer.h"
+#    include "action_util.h"
+#    include "host.h"
+#    ifdef CAPS_WORD_ENABLE
+#        include "caps_word.h"
+#    endif
+#endif
 #include <string.h>
 #include <math.h>
 #include <stdlib.h>
@@ -71,6 +79,9 @@ uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 last_hit_t g_last_hit_tracker;
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+led_geometry_t g_led_geometry[RGB_MATRIX_LED_COUNT];
+#endif // RGB_MATRIX_GEOMETRY_CACHE
 
 // internals
 static bool            suspend_state     = false;
@@ -79,6 +90,24 @@ static uint8_t         rgb_last_effect   = UINT8_MAX;
 static effect_params_t rgb_effect_params = {0, LED_FLAG_ALL, false};
 static rgb_task_states rgb_task_state    = SYNCING;
 
+#ifdef RGB_MATRIX_DIRTY_TRACKING
+// last colour handed to the driver for each LED, and which LEDs changed since the last flush
+static rgb_t   rgb_shadow_buffer[RGB_MATRIX_LED_COUNT];
+static uint8_t rgb_dirty_bitmap[(RGB_MATRIX_LED_COUNT + 7) / 8];
+#endif // RGB_MATRIX_DIRTY_TRACKING
+
+#ifdef RGB_MATRIX_IDLE_FRAME_SKIP
+// inputs the last idle frame was rendered from, any change wakes the task again
+static bool          rgb_effect_idle = false;
+static rgb_config_t  rgb_idle_config;
+static layer_state_t rgb_idle_layers;
+static uint8_t       rgb_idle_host_leds;
+static uint8_t       rgb_idle_mods;
+#    ifdef CAPS_WORD_ENABLE
+static bool rgb_idle_caps_word;
+#    endif
+#endif // RGB_MATRIX_IDLE_FRAME_SKIP
+
 // double buffers
 static uint32_t rgb_timer_buffer;
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
@@ -141,8 +170,25 @@ uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *l
     return led_count;
 }
 
+#ifdef RGB_MATRIX_DIRTY_TRACKING
+bool rgb_matrix_is_led_dirty(uint8_t index) {
+    if (index >= RGB_MATRIX_LED_COUNT) return false;
+    return (rgb_dirty_bitmap[index / 8] & (1 << (index % 8))) != 0;
+}
+
+bool rgb_matrix_is_dirty(void) {
+    for (uint8_t i = 0; i < sizeof(rgb_dirty_bitmap); i++) {
+        if (rgb_dirty_bitmap[i]) return true;
+    }
+    return false;
+}
+#endif // RGB_MATRIX_DIRTY_TRACKING
+
 void rgb_matrix_update_pwm_buffers(void) {
     rgb_matrix_driver.flush();
+#ifdef RGB_MATRIX_DIRTY_TRACKING
+    memset(rgb_dirty_bitmap, 0, sizeof(rgb_dirty_bitmap));
+#endif
 }
 
 __attribute__((weak)) int rgb_matrix_led_index(int index) {
@@ -155,11 +201,20 @@ __attribute__((weak)) int rgb_matrix_led_index(int index) {
 }
 
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+#ifdef RGB_MATRIX_DIRTY_TRACKING
+    if (index < 0 || index >= RGB_MATRIX_LED_COUNT) return;
+    rgb_t *shadow = &rgb_shadow_buffer[index];
+    if (shadow->r == red && shadow->g == green && shadow->b == blue) return;
+    shadow->r = red;
+    shadow->g = green;
+    shadow->b = blue;
+    rgb_dirty_bitmap[index / 8] |= (1 << (index % 8));
+#endif // RGB_MATRIX_DIRTY_TRACKING
     rgb_matrix_driver.set_color(rgb_matrix_led_index(index), red, green, blue);
 }
 
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
-#if defined(RGB_MATRIX_SPLIT)
+#if defined(RGB_MATRIX_SPLIT) || defined(RGB_MATRIX_DIRTY_TRACKING)
     for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++)
         rgb_matrix_set_color(i, red, green, blue);
 #else
@@ -203,6 +258,8 @@ void rgb_matrix_handle_key_event(uint8_t row, uint8_t col, bool pressed) {
     }
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
+    rgb_matrix_wake();
+
 #if defined(RGB_MATRIX_FRAMEBUFFER_EFFECTS) && defined(ENABLE_RGB_MATRIX_TYPING_HEATMAP)
 #    if defined(RGB_MATRIX_KEYRELEASES)
     if (!pressed)
@@ -269,8 +326,47 @@ static void rgb_task_timers(void) {
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 }
 
-static void rgb_task_sync(void) {
+#ifdef RGB_MATRIX_IDLE_FRAME_SKIP
+void rgb_matrix_effect_idle(void) {
+    rgb_effect_idle = true;
+}
+
+void rgb_matrix_wake(void) {
+    rgb_effect_idle = false;
+}
+
+static void rgb_idle_snapshot(void) {
+    rgb_idle_config    = rgb_matrix_config;
+    rgb_idle_layers    = layer_state | default_layer_state;
+    rgb_idle_host_leds = host_keyboard_leds();
+    rgb_idle_mods      = get_mods() | get_weak_mods() | get_oneshot_mods();
+#    ifdef CAPS_WORD_ENABLE
+    rgb_idle_caps_word = is_caps_word_on();
+#    endif
+}
+
+static bool rgb_task_idle(uint8_t effect) {
+    if (!rgb_effect_idle || effect != rgb_last_effect) return false;
+    if (rgb_idle_config.raw != rgb_matrix_config.raw) return false;
+    if (rgb_idle_layers != (layer_state | default_layer_state)) return false;
+    if (rgb_idle_host_leds != host_keyboard_leds()) return false;
+    if (rgb_idle_mods != (get_mods() | get_weak_mods() | get_oneshot_mods())) return false;
+#    ifdef CAPS_WORD_ENABLE
+    if (rgb_idle_caps_word != is_caps_word_on()) return false;
+#    endif
+#    if RGB_MATRIX_IDLE_REFRESH_INTERVAL > 0
+    if (sync_timer_elapsed32(g_rgb_timer) >= RGB_MATRIX_IDLE_REFRESH_INTERVAL) return false;
+#    endif
+    return true;
+}
+#endif // RGB_MATRIX_IDLE_FRAME_SKIP
+
+static void rgb_task_sync(uint8_t effect) {
     eeconfig_flush_rgb_matrix(false);
+#ifdef RGB_MATRIX_IDLE_FRAME_SKIP
+    // nothing the idle effect or indicators depend on has changed, skip the frame
+    if (rgb_task_idle(effect)) return;
+#endif
     // next task
     if (sync_timer_elapsed32(g_rgb_timer) >= RGB_MATRIX_LED_FLUSH_LIMIT) rgb_task_state = STARTING;
 }
@@ -279,6 +375,12 @@ static void rgb_task_start(void) {
     // reset iter
     rgb_effect_params.iter = 0;
 
+#ifdef RGB_MATRIX_IDLE_FRAME_SKIP
+    // effects re-declare idle on every pass
+    rgb_effect_idle = false;
+    rgb_idle_snapshot();
+#endif
+
     // update double buffers
     g_rgb_timer = rgb_timer_buffer;
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
@@ -364,7 +466,10 @@ static void rgb_task_flush(uint8_t effect) {
     rgb_last_enable = rgb_matrix_config.enable;
 
     // update pwm buffers
-    rgb_matrix_update_pwm_buffers();
+#ifdef RGB_MATRIX_DIRTY_TRACKING
+    if (rgb_matrix_is_dirty())
+#endif
+        rgb_matrix_update_pwm_buffers();
 
     // next task
     rgb_task_state = SYNCING;
@@ -400,7 +505,7 @@ void rgb_matrix_task(void) {
             rgb_task_flush(effect);
             break;
         case SYNCING:
-            rgb_task_sync();
+            rgb_task_sync(effect);
             break;
     }
 }
@@ -473,9 +578,27 @@ __attribute__((weak)) bool rgb_matrix_indicators_advanced_user(uint8_t led_min,
     return true;
 }
 
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+void rgb_matrix_update_geometry(void) {
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        int16_t dx = g_led_config.point[i].x - k_rgb_matrix_center.x;
+        int16_t dy = g_led_config.point[i].y - k_rgb_matrix_center.y;
+
+        g_led_geometry[i].dx    = dx;
+        g_led_geometry[i].dy    = dy;
+        g_led_geometry[i].dist  = sqrt16(dx * dx + dy * dy);
+        g_led_geometry[i].angle = atan2_8(dy, dx);
+    }
+}
+#endif // RGB_MATRIX_GEOMETRY_CACHE
+
 void rgb_matrix_init(void) {
     rgb_matrix_driver.init();
 
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+    rgb_matrix_update_geometry();
+#endif
+
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker.count = 0;
     for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
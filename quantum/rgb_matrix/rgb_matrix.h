@@ -90,6 +90,10 @@
 #    define RGB_MATRIX_LED_PROCESS_LIMIT ((RGB_MATRIX_LED_COUNT + 4) / 5)
 #endif
 
+#ifndef RGB_MATRIX_IDLE_REFRESH_INTERVAL
+#    define RGB_MATRIX_IDLE_REFRESH_INTERVAL 1000
+#endif
+
 struct rgb_matrix_limits_t {
     uint8_t led_min_index;
     uint8_t led_max_index;
@@ -156,6 +160,22 @@ int rgb_matrix_led_index(int index);
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue);
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue);
 
+#ifdef RGB_MATRIX_DIRTY_TRACKING
+// LEDs whose colour changed since the last flush
+bool rgb_matrix_is_led_dirty(uint8_t index);
+bool rgb_matrix_is_dirty(void);
+#endif
+
+#ifdef RGB_MATRIX_IDLE_FRAME_SKIP
+// Called by an effect while rendering when its output will not change until the config,
+// layers, host LEDs or key hits do. Frames are then skipped until rgb_matrix_wake().
+void rgb_matrix_effect_idle(void);
+void rgb_matrix_wake(void);
+#else
+#    define rgb_matrix_effect_idle()
+#    define rgb_matrix_wake()
+#endif
+
 void rgb_matrix_handle_key_event(uint8_t row, uint8_t col, bool pressed);
 
 void rgb_matrix_task(void);
@@ -286,6 +306,22 @@ extern last_hit_t g_last_hit_tracker;
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
 extern uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS];
 #endif
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+extern led_geometry_t g_led_geometry[RGB_MATRIX_LED_COUNT];
+
+// Recalculate g_led_geometry, needed if g_led_config.point is changed at runtime
+void rgb_matrix_update_geometry(void);
+
+#    define RGB_MATRIX_LED_DX(i) (g_led_geometry[i].dx)
+#    define RGB_MATRIX_LED_DY(i) (g_led_geometry[i].dy)
+#    define RGB_MATRIX_LED_DIST(i) (g_led_geometry[i].dist)
+#    define RGB_MATRIX_LED_ANGLE(i) (g_led_geometry[i].angle)
+#else
+#    define RGB_MATRIX_LED_DX(i) ((int16_t)g_led_config.point[i].x - k_rgb_matrix_center.x)
+#    define RGB_MATRIX_LED_DY(i) ((int16_t)g_led_config.point[i].y - k_rgb_matrix_center.y)
+#    define RGB_MATRIX_LED_DIST(i) sqrt16(RGB_MATRIX_LED_DX(i) * RGB_MATRIX_LED_DX(i) + RGB_MATRIX_LED_DY(i) * RGB_MATRIX_LED_DY(i))
+#    define RGB_MATRIX_LED_ANGLE(i) atan2_8(RGB_MATRIX_LED_DY(i), RGB_MATRIX_LED_DX(i))
+#endif
 
 #if !defined(RGB_MATRIX_MAXIMUM_BRIGHTNESS) || RGB_MATRIX_MAXIMUM_BRIGHTNESS > UINT8_MAX
 #    undef RGB_MATRIX_MAXIMUM_BRIGHTNESS
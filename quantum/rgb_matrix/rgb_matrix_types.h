@@ -75,6 +75,16 @@ typedef struct PACKED {
     uint8_t     flags[RGB_MATRIX_LED_COUNT];
 } led_config_t;
 
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+// Position of each LED relative to k_rgb_matrix_center, as consumed by the effect runners
+typedef struct PACKED {
+    int16_t dx;
+    int16_t dy;
+    uint8_t dist;
+    uint8_t angle;
+} led_geometry_t;
+#endif // RGB_MATRIX_GEOMETRY_CACHE
+
 typedef union rgb_config_t {
     uint64_t raw;
     struct PACKED {
@@ -209,6 +209,13 @@ void send_string_with_delay(const char *string, uint8_t interval) {
     send_string_with_delay_impl(send_string_get_next_ram, &state, interval);
 }
 
+uint8_t send_char_lookup(char ascii_code, bool *is_shifted, bool *is_altgred, bool *is_dead) {
+    *is_shifted = PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code);
+    *is_altgred = PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code);
+    *is_dead    = PGM_LOADBIT(ascii_to_dead_lut, (uint8_t)ascii_code);
+    return pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+}
+
 void send_char(char ascii_code) {
     send_char_with_delay(ascii_code, TAP_CODE_DELAY);
 }
@@ -221,10 +228,8 @@ void send_char_with_delay(char ascii_code, uint8_t interval) {
     }
 #endif
 
-    uint8_t keycode    = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
-    bool    is_shifted = PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code);
-    bool    is_altgred = PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code);
-    bool    is_dead    = PGM_LOADBIT(ascii_to_dead_lut, (uint8_t)ascii_code);
+    bool    is_shifted, is_altgred, is_dead;
+    uint8_t keycode = send_char_lookup(ascii_code, &is_shifted, &is_altgred, &is_dead);
 
     if (is_shifted) {
         register_code(KC_LEFT_SHIFT);
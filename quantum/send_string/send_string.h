@@ -24,6 +24,7 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #include "progmem.h"
 #include "send_string_keycodes.h"
@@ -82,6 +83,17 @@ void send_char(char ascii_code);
  */
 void send_char_with_delay(char ascii_code, uint8_t interval);
 
+/**
+ * \brief Look up the keystrokes `send_char()` uses to type an ASCII character.
+ *
+ * \param ascii_code The character to look up.
+ * \param is_shifted Set if Shift must be held while tapping the keycode.
+ * \param is_altgred Set if AltGr must be held while tapping the keycode.
+ * \param is_dead Set if the keycode is a dead key, which must be followed by a space.
+ * \return The basic keycode to tap.
+ */
+uint8_t send_char_lookup(char ascii_code, bool *is_shifted, bool *is_altgred, bool *is_dead);
+
 /**
  * \brief Type out an eight digit (unsigned 32-bit) hexadecimal value.
  *
@@ -23,7 +23,17 @@ enum serial_transaction_id {
     I2C_EXECUTE_CALLBACK,
 #endif // USE_I2C
 
+#ifdef SPLIT_TRANSACTION_BATCHING
+    PUT_BATCH_FRAME,
+    GET_BATCH_FRAME,
+#endif // SPLIT_TRANSACTION_BATCHING
+
+#ifdef SPLIT_MATRIX_EVENTS
+    GET_SLAVE_MATRIX_SEQUENCE,
+    GET_SLAVE_MATRIX_EVENT,
+#else
     GET_SLAVE_MATRIX_CHECKSUM,
+#endif // SPLIT_MATRIX_EVENTS
     GET_SLAVE_MATRIX_DATA,
 
 #ifdef SPLIT_TRANSPORT_MIRROR
@@ -84,9 +84,16 @@
 #define trans_initiator2target_cb(cb) \
     { 0, 0, 0, 0, cb }
 
-#define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
-#define transport_read(id, data, length) transport_execute_transaction(id, NULL, 0, data, length)
-#define transport_exec(id) transport_execute_transaction(id, NULL, 0, NULL, 0)
+#ifdef SPLIT_TRANSACTION_BATCHING
+static bool batch_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length);
+#    define transport_write(id, data, length) batch_execute_transaction(id, data, length, NULL, 0)
+#    define transport_read(id, data, length) batch_execute_transaction(id, NULL, 0, data, length)
+#    define transport_exec(id) batch_execute_transaction(id, NULL, 0, NULL, 0)
+#else // SPLIT_TRANSACTION_BATCHING
+#    define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
+#    define transport_read(id, data, length) transport_execute_transaction(id, NULL, 0, data, length)
+#    define transport_exec(id) transport_execute_transaction(id, NULL, 0, NULL, 0)
+#endif // SPLIT_TRANSACTION_BATCHING
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 // Forward-declare the RPC callback handlers
@@ -175,9 +182,350 @@ inline static bool send_if_data_mismatch(int8_t trans_id, uint32_t *last_update,
     return send_if_condition(trans_id, last_update, (memcmp(source, equiv_shmem, length) != 0), source, length);
 }
 
+////////////////////////////////////////////////////
+// Batching
+
+#ifdef SPLIT_TRANSACTION_BATCHING
+
+#    define BATCH_SLOT_NONE 0xFF
+#    define BATCH_FRAME_HEADER_SIZE offsetof(split_batch_frame_t, payload)
+#    define BATCH_GET_RETRIES 3
+
+STATIC_ASSERT(BATCH_FRAME_HEADER_SIZE + SPLIT_TRANSACTION_BATCH_SIZE <= UINT8_MAX, "SPLIT_TRANSACTION_BATCH_SIZE too large for a single transaction");
+
+// Offset of each batched transaction's data within the frame payload
+static uint8_t  batch_slot[NUM_TOTAL_TRANSACTIONS];
+static uint32_t batch_put_mask = 0;
+static uint32_t batch_get_mask = 0;
+// PUTs written by the handlers this scan, waiting for the frame to be sent
+static uint32_t batch_pending   = 0;
+static bool     batch_get_valid = false;
+// PUTs sent but not yet acknowledged by the slave
+static uint32_t batch_unacked  = 0;
+static uint8_t  batch_sequence = 0;
+static bool     batch_synced   = false;
+// Last PUT frame applied on the slave, reported back in the GET frame
+static uint8_t batch_applied_sequence = 0;
+
+static bool batch_can_include(int8_t id) {
+    switch (id) {
+#    ifdef USE_I2C
+        case I2C_EXECUTE_CALLBACK:
+#    endif // USE_I2C
+        case PUT_BATCH_FRAME:
+        case GET_BATCH_FRAME:
+#    if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
+        // Sized per call, so they can't have a fixed slot
+        case PUT_RPC_REQ_DATA:
+        case GET_RPC_RESP_DATA:
+#    endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
+            return false;
+        default:
+            return !split_transaction_table[id].slave_callback;
+    }
+}
+
+static void batch_layout_init(void) {
+    uint8_t put_length = 0;
+    uint8_t get_length = 0;
+
+    memset(batch_slot, BATCH_SLOT_NONE, sizeof(batch_slot));
+    batch_put_mask = 0;
+    batch_get_mask = 0;
+    batch_pending  = 0;
+    batch_unacked  = 0;
+    batch_sequence = 0;
+    batch_synced   = false;
+
+    // Both halves run the same table, so they come up with the same layout.
+    // Anything that doesn't fit keeps its own round trip.
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        split_transaction_desc_t *trans = &split_transaction_table[id];
+        if (!batch_can_include(id)) continue;
+
+        if (trans->initiator2target_buffer_size && !trans->target2initiator_buffer_size) {
+            if (put_length + trans->initiator2target_buffer_size > SPLIT_TRANSACTION_BATCH_SIZE) continue;
+            batch_slot[id] = put_length;
+            put_length += trans->initiator2target_buffer_size;
+            batch_put_mask |= (1UL << id);
+        } else if (trans->target2initiator_buffer_size && !trans->initiator2target_buffer_size) {
+            if (get_length + trans->target2initiator_buffer_size > SPLIT_TRANSACTION_BATCH_SIZE) continue;
+            batch_slot[id] = get_length;
+            get_length += trans->target2initiator_buffer_size;
+            batch_get_mask |= (1UL << id);
+        }
+    }
+
+    split_transaction_table[PUT_BATCH_FRAME].initiator2target_buffer_size = BATCH_FRAME_HEADER_SIZE + put_length;
+    split_transaction_table[GET_BATCH_FRAME].target2initiator_buffer_size = BATCH_FRAME_HEADER_SIZE + get_length;
+}
+
+static uint8_t batch_frame_checksum(split_batch_frame_t *frame, uint8_t length) {
+    uint8_t checksum = frame->checksum;
+    frame->checksum  = 0;
+    uint8_t result   = crc8(frame, length);
+    frame->checksum  = checksum;
+    return result;
+}
+
+static bool batch_flush(void) {
+    split_batch_frame_t frame;
+    uint8_t             length = split_transaction_table[PUT_BATCH_FRAME].initiator2target_buffer_size;
+
+    // Hold everything until the slave has told us which sequence it last applied
+    if (!batch_pending || !batch_synced) return true;
+
+    // Fill every slot so the frame is deterministic, the mask tells the slave which ones to apply
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if (batch_put_mask & (1UL << id)) {
+            split_transaction_desc_t *trans = &split_transaction_table[id];
+            memcpy(&frame.payload[batch_slot[id]], split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size);
+        }
+    }
+    // The slave loop may not get to a frame before the next one replaces it, so keep
+    // flagging earlier slots until the slave acknowledges a frame carrying them
+    frame.mask = batch_pending | batch_unacked;
+    // Zero is what a freshly booted slave has seen, never use it
+    if (++batch_sequence == 0) batch_sequence = 1;
+    frame.sequence = batch_sequence;
+    frame.ack      = 0;
+    frame.checksum = batch_frame_checksum(&frame, length);
+
+    if (!transport_execute_transaction(PUT_BATCH_FRAME, &frame, length, NULL, 0)) {
+        return false;
+    }
+    batch_unacked = frame.mask;
+    batch_pending = 0;
+    return true;
+}
+
+static bool batch_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+
+    if (batch_put_mask & (1UL << id)) {
+        size_t len = trans->initiator2target_buffer_size < initiator2target_length ? trans->initiator2target_buffer_size : initiator2target_length;
+        memcpy(split_trans_initiator2target_buffer(trans), initiator2target_buf, len);
+        batch_pending |= (1UL << id);
+        return true;
+    }
+
+    if (batch_get_valid && (batch_get_mask & (1UL << id))) {
+        size_t len = trans->target2initiator_buffer_size < target2initiator_length ? trans->target2initiator_buffer_size : target2initiator_length;
+        memcpy(target2initiator_buf, split_trans_target2initiator_buffer(trans), len);
+        return true;
+    }
+
+    // Keep ordering intact for anything that still needs its own round trip
+    if (!batch_flush()) {
+        return false;
+    }
+    return transport_execute_transaction(id, initiator2target_buf, initiator2target_length, target2initiator_buf, target2initiator_length);
+}
+
+static bool batch_get_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    split_batch_frame_t frame;
+    uint8_t             length = split_transaction_table[GET_BATCH_FRAME].target2initiator_buffer_size;
+    bool                valid  = false;
+
+    batch_get_valid = false;
+    if (!batch_get_mask && !batch_put_mask) return true;
+
+    // The slave may have been power cycled in the meantime, redo the sequence handshake
+    if (!is_transport_connected()) {
+        batch_synced = false;
+    }
+
+    for (uint8_t attempt = 0; attempt < BATCH_GET_RETRIES && !valid; attempt++) {
+        if (!transport_execute_transaction(GET_BATCH_FRAME, NULL, 0, &frame, length)) {
+            return false;
+        }
+        valid = frame.checksum == batch_frame_checksum(&frame, length);
+    }
+    if (!valid) {
+        // Leave it to the individual transactions, which do their own checksum checks
+        return true;
+    }
+
+    if (!batch_synced) {
+        // Carry on from whatever the slave last applied, so the next frame is never mistaken for a repeat
+        batch_sequence = frame.ack;
+        batch_synced   = true;
+    }
+    if (frame.ack == batch_sequence) {
+        batch_unacked = 0;
+    }
+
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if (frame.mask & batch_get_mask & (1UL << id)) {
+            split_transaction_desc_t *trans = &split_transaction_table[id];
+            memcpy(split_trans_target2initiator_buffer(trans), &frame.payload[batch_slot[id]], trans->target2initiator_buffer_size);
+        }
+    }
+    batch_get_valid = true;
+    return true;
+}
+
+static void batch_get_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    split_batch_frame_t *frame  = &split_shmem->batch_get;
+    uint8_t              length = split_transaction_table[GET_BATCH_FRAME].target2initiator_buffer_size;
+
+    // Runs after every other slave handler, so the frame carries this loop's state
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if (batch_get_mask & (1UL << id)) {
+            split_transaction_desc_t *trans = &split_transaction_table[id];
+            memcpy(&frame->payload[batch_slot[id]], split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size);
+        }
+    }
+    frame->mask = batch_get_mask;
+    frame->sequence++;
+    frame->ack      = batch_applied_sequence;
+    frame->checksum = batch_frame_checksum(frame, length);
+}
+
+static bool batch_put_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    batch_get_valid = false;
+    return batch_flush();
+}
+
+static void batch_put_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    split_batch_frame_t frame;
+    uint8_t             length = split_transaction_table[PUT_BATCH_FRAME].initiator2target_buffer_size;
+
+    // Applied from the slave loop rather than a transaction callback, as some transports
+    // run the callback before the initiator's data has been received.
+    memcpy(&frame, &split_shmem->batch_put, length);
+    if (frame.sequence == batch_applied_sequence || frame.checksum != batch_frame_checksum(&frame, length)) {
+        return;
+    }
+    batch_applied_sequence = frame.sequence;
+
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if (frame.mask & batch_put_mask & (1UL << id)) {
+            split_transaction_desc_t *trans = &split_transaction_table[id];
+            memcpy(split_trans_initiator2target_buffer(trans), &frame.payload[batch_slot[id]], trans->initiator2target_buffer_size);
+        }
+    }
+}
+
+// clang-format off
+#    define TRANSACTIONS_BATCH_GET_MASTER() TRANSACTION_HANDLER_MASTER(batch_get)
+#    define TRANSACTIONS_BATCH_GET_SLAVE() TRANSACTION_HANDLER_SLAVE_AUTOLOCK(batch_get)
+#    define TRANSACTIONS_BATCH_PUT_MASTER() TRANSACTION_HANDLER_MASTER(batch_put)
+#    define TRANSACTIONS_BATCH_PUT_SLAVE() TRANSACTION_HANDLER_SLAVE_AUTOLOCK(batch_put)
+#    define TRANSACTIONS_BATCH_REGISTRATIONS \
+    [PUT_BATCH_FRAME] = trans_initiator2target_initializer(batch_put), \
+    [GET_BATCH_FRAME] = trans_target2initiator_initializer(batch_get),
+// clang-format on
+
+#else // SPLIT_TRANSACTION_BATCHING
+
+#    define TRANSACTIONS_BATCH_GET_MASTER()
+#    define TRANSACTIONS_BATCH_GET_SLAVE()
+#    define TRANSACTIONS_BATCH_PUT_MASTER()
+#    define TRANSACTIONS_BATCH_PUT_SLAVE()
+#    define TRANSACTIONS_BATCH_REGISTRATIONS
+
+#endif // SPLIT_TRANSACTION_BATCHING
+
 ////////////////////////////////////////////////////
 // Slave matrix
 
+#ifdef SPLIT_MATRIX_EVENTS
+
+static bool         slave_matrix_synced                         = false; // whether the last sequence and matrix describe the slave
+static uint8_t      slave_matrix_last_sequence                  = 0;
+static matrix_row_t slave_matrix_last_matrix[(MATRIX_ROWS) / 2] = {0}; // last successfully-read matrix, so we can replicate if there are checksum errors
+
+static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    matrix_row_t               temp_matrix[(MATRIX_ROWS) / 2]; // holding area while we test whether or not checksum is correct
+    split_slave_matrix_event_t event;
+    uint8_t                    sequence;
+
+    // The slave restarts its sequence when it reboots
+    if (!is_transport_connected()) {
+        slave_matrix_synced = false;
+    }
+
+    // Idle scans only poll the sequence number, the event is read once it moves
+    bool okay = transport_read(GET_SLAVE_MATRIX_SEQUENCE, &sequence, sizeof(sequence));
+    if (okay && (!slave_matrix_synced || sequence != slave_matrix_last_sequence)) {
+        okay &= transport_read(GET_SLAVE_MATRIX_EVENT, &event, sizeof(event));
+    } else {
+        // Nothing changed since the last poll
+        memcpy(slave_matrix, slave_matrix_last_matrix, sizeof(slave_matrix_last_matrix));
+        return okay;
+    }
+    if (okay) {
+        bool resync = !slave_matrix_synced;
+        memcpy(temp_matrix, slave_matrix_last_matrix, sizeof(temp_matrix));
+        if (event.sequence == (uint8_t)(slave_matrix_last_sequence + 1) && event.row < (MATRIX_ROWS) / 2) {
+            // Exactly one single-row change since the last poll, replay it locally
+            temp_matrix[event.row] ^= event.delta;
+        } else if (event.sequence != slave_matrix_last_sequence) {
+            // Missed or multi-row events -- a matching checksum alone can't prove the matrix is right
+            resync = true;
+        }
+        if (resync || event.checksum != crc8(temp_matrix, sizeof(temp_matrix))) {
+            // Fall back to the full matrix, also covers a corrupted delta
+            okay &= transport_read(GET_SLAVE_MATRIX_DATA, temp_matrix, sizeof(temp_matrix));
+            okay &= event.checksum == crc8(temp_matrix, sizeof(temp_matrix));
+        }
+        if (okay) {
+            // Checksum matches the reconstructed data, save as the last matrix state
+            memcpy(slave_matrix_last_matrix, temp_matrix, sizeof(temp_matrix));
+            slave_matrix_last_sequence = event.sequence;
+            slave_matrix_synced        = true;
+        }
+    }
+    // Copy out the last-known-good matrix state to the slave matrix
+    memcpy(slave_matrix, slave_matrix_last_matrix, sizeof(slave_matrix_last_matrix));
+    return okay;
+}
+
+static void slave_matrix_events_init(void) {
+    slave_matrix_synced = false;
+    memset(slave_matrix_last_matrix, 0, sizeof(slave_matrix_last_matrix));
+
+    // Describe whatever is currently in shared memory, so the master can validate it before the first change
+    split_shmem->smatrix.event.row      = SPLIT_MATRIX_EVENT_MULTIPLE_ROWS;
+    split_shmem->smatrix.event.checksum = crc8(split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
+}
+
+static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    uint8_t      changed_row = SPLIT_MATRIX_EVENT_MULTIPLE_ROWS;
+    uint8_t      changes     = 0;
+    matrix_row_t delta       = 0;
+
+    for (uint8_t row = 0; row < (MATRIX_ROWS) / 2; ++row) {
+        matrix_row_t diff = split_shmem->smatrix.matrix[row] ^ slave_matrix[row];
+        if (diff) {
+            changed_row = row;
+            delta       = diff;
+            ++changes;
+        }
+    }
+    if (changes == 0) {
+        return;
+    }
+
+    memcpy(split_shmem->smatrix.matrix, slave_matrix, sizeof(split_shmem->smatrix.matrix));
+    split_shmem->smatrix.event.sequence++;
+    split_shmem->smatrix.event.row      = changes == 1 ? changed_row : SPLIT_MATRIX_EVENT_MULTIPLE_ROWS;
+    split_shmem->smatrix.event.delta    = changes == 1 ? delta : 0;
+    split_shmem->smatrix.event.checksum = crc8(split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
+}
+
+// clang-format off
+#define TRANSACTIONS_SLAVE_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(slave_matrix)
+#define TRANSACTIONS_SLAVE_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE_AUTOLOCK(slave_matrix)
+#define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
+    [GET_SLAVE_MATRIX_SEQUENCE] = trans_target2initiator_initializer(smatrix.event.sequence), \
+    [GET_SLAVE_MATRIX_EVENT]    = trans_target2initiator_initializer(smatrix.event), \
+    [GET_SLAVE_MATRIX_DATA]     = trans_target2initiator_initializer(smatrix.matrix),
+// clang-format on
+
+#else // SPLIT_MATRIX_EVENTS
+
 static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     static uint32_t     last_update                    = 0;
     static matrix_row_t last_matrix[(MATRIX_ROWS) / 2] = {0}; // last successfully-read matrix, so we can replicate if there are checksum errors
@@ -206,6 +554,8 @@ static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row
     [GET_SLAVE_MATRIX_DATA]     = trans_target2initiator_initializer(smatrix.matrix),
 // clang-format on
 
+#endif // SPLIT_MATRIX_EVENTS
+
 ////////////////////////////////////////////////////
 // Master matrix
 
@@ -925,6 +1275,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 #endif // USE_I2C
 
     // clang-format off
+    TRANSACTIONS_BATCH_REGISTRATIONS
     TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS
     TRANSACTIONS_MASTER_MATRIX_REGISTRATIONS
     TRANSACTIONS_ENCODERS_REGISTRATIONS
@@ -954,7 +1305,17 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 #endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 };
 
+void transactions_init(void) {
+#ifdef SPLIT_TRANSACTION_BATCHING
+    batch_layout_init();
+#endif // SPLIT_TRANSACTION_BATCHING
+#ifdef SPLIT_MATRIX_EVENTS
+    slave_matrix_events_init();
+#endif // SPLIT_MATRIX_EVENTS
+}
+
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    TRANSACTIONS_BATCH_GET_MASTER();
     TRANSACTIONS_SLAVE_MATRIX_MASTER();
     TRANSACTIONS_MASTER_MATRIX_MASTER();
     TRANSACTIONS_ENCODERS_MASTER();
@@ -974,10 +1335,12 @@ bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix
     TRANSACTIONS_HAPTIC_MASTER();
     TRANSACTIONS_ACTIVITY_MASTER();
     TRANSACTIONS_DETECTED_OS_MASTER();
+    TRANSACTIONS_BATCH_PUT_MASTER();
     return true;
 }
 
 void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    TRANSACTIONS_BATCH_PUT_SLAVE();
     TRANSACTIONS_SLAVE_MATRIX_SLAVE();
     TRANSACTIONS_MASTER_MATRIX_SLAVE();
     TRANSACTIONS_ENCODERS_SLAVE();
@@ -997,6 +1360,7 @@ void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[
     TRANSACTIONS_HAPTIC_SLAVE();
     TRANSACTIONS_ACTIVITY_SLAVE();
     TRANSACTIONS_DETECTED_OS_SLAVE();
+    TRANSACTIONS_BATCH_GET_SLAVE();
 }
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
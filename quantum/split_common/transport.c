@@ -42,9 +42,11 @@ STATIC_ASSERT(sizeof(split_shared_memory_t) <= I2C_SLAVE_REG_COUNT, "split_share
 split_shared_memory_t *const split_shmem = (split_shared_memory_t *)i2c_slave_reg;
 
 void transport_master_init(void) {
+    transactions_init();
     i2c_init();
 }
 void transport_slave_init(void) {
+    transactions_init();
     i2c_slave_init(SLAVE_I2C_ADDRESS);
 }
 
@@ -95,9 +97,11 @@ static split_shared_memory_t shared_memory;
 split_shared_memory_t *const split_shmem = &shared_memory;
 
 void transport_master_init(void) {
+    transactions_init();
     soft_serial_initiator_init();
 }
 void transport_slave_init(void) {
+    transactions_init();
     soft_serial_target_init();
 }
 
@@ -31,6 +31,10 @@
 #    define RPC_S2M_BUFFER_SIZE 32
 #endif // RPC_S2M_BUFFER_SIZE
 
+#ifndef SPLIT_TRANSACTION_BATCH_SIZE
+#    define SPLIT_TRANSACTION_BATCH_SIZE 64
+#endif // SPLIT_TRANSACTION_BATCH_SIZE
+
 void transport_master_init(void);
 void transport_slave_init(void);
 
@@ -52,9 +56,33 @@ bool transport_execute_transaction(int8_t id, const void *initiator2target_buf,
 #    include "rgblight.h"
 #endif // RGBLIGHT_ENABLE
 
+#ifdef SPLIT_TRANSACTION_BATCHING
+typedef struct _split_batch_frame_t {
+    uint32_t mask; // transaction IDs whose slot carries new data
+    uint8_t  sequence;
+    uint8_t  ack; // last PUT frame sequence the slave has applied
+    uint8_t  checksum;
+    uint8_t  payload[SPLIT_TRANSACTION_BATCH_SIZE];
+} split_batch_frame_t;
+#endif // SPLIT_TRANSACTION_BATCHING
+
+#ifdef SPLIT_MATRIX_EVENTS
+#    define SPLIT_MATRIX_EVENT_MULTIPLE_ROWS 0xFF
+
+typedef struct _split_slave_matrix_event_t {
+    uint8_t      sequence; // incremented each time the slave matrix changes
+    uint8_t      row;      // row touched by the latest change, or SPLIT_MATRIX_EVENT_MULTIPLE_ROWS
+    uint8_t      checksum; // of the whole slave matrix after the change
+    matrix_row_t delta;    // columns of `row` which toggled
+} split_slave_matrix_event_t;
+#endif // SPLIT_MATRIX_EVENTS
+
 typedef struct _split_slave_matrix_sync_t {
     uint8_t      checksum;
     matrix_row_t matrix[(MATRIX_ROWS) / 2];
+#ifdef SPLIT_MATRIX_EVENTS
+    split_slave_matrix_event_t event;
+#endif // SPLIT_MATRIX_EVENTS
 } split_slave_matrix_sync_t;
 
 #ifdef SPLIT_TRANSPORT_MIRROR
@@ -152,6 +180,11 @@ typedef struct _split_shared_memory_t {
     int8_t transaction_id;
 #endif // USE_I2C
 
+#ifdef SPLIT_TRANSACTION_BATCHING
+    split_batch_frame_t batch_put;
+    split_batch_frame_t batch_get;
+#endif // SPLIT_TRANSACTION_BATCHING
+
     split_slave_matrix_sync_t smatrix;
 
 #ifdef SPLIT_TRANSPORT_MIRROR
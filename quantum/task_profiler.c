@@ -0,0 +1,249 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "task_profiler.h"
+#include "timer.h"
+#include "print.h"
+#include "util.h"
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+#endif
+
+#ifndef TASK_PROFILER_PRINT_INTERVAL
+#    define TASK_PROFILER_PRINT_INTERVAL 0
+#endif
+
+typedef struct task_profiler_slot_data_t {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint16_t buckets[TASK_PROFILER_BUCKETS];
+} task_profiler_slot_data_t;
+
+static task_profiler_slot_data_t task_profiler_slots[TASK_PROFILER_SLOT_COUNT];
+
+static const char *const task_profiler_slot_names[TASK_PROFILER_SLOT_COUNT] = {
+    [TASK_PROFILER_SLOT_LOOP] = "loop",
+    [TASK_PROFILER_SLOT_KEYBOARD_TASK] = "keyboard_task",
+    [TASK_PROFILER_SLOT_MATRIX] = "matrix",
+    [TASK_PROFILER_SLOT_TRANSACTIONS] = "transactions",
+    [TASK_PROFILER_SLOT_QUANTUM] = "quantum",
+    [TASK_PROFILER_SLOT_RGBLIGHT] = "rgblight",
+    [TASK_PROFILER_SLOT_LED_MATRIX] = "led_matrix",
+    [TASK_PROFILER_SLOT_RGB_MATRIX] = "rgb_matrix",
+    [TASK_PROFILER_SLOT_BACKLIGHT] = "backlight",
+    [TASK_PROFILER_SLOT_ENCODER] = "encoder",
+    [TASK_PROFILER_SLOT_POINTING] = "pointing",
+    [TASK_PROFILER_SLOT_OLED] = "oled",
+    [TASK_PROFILER_SLOT_ST7565] = "st7565",
+    [TASK_PROFILER_SLOT_MOUSEKEY] = "mousekey",
+    [TASK_PROFILER_SLOT_OTHER] = "other",
+    [TASK_PROFILER_SLOT_HOUSEKEEPING] = "housekeeping",
+    [TASK_PROFILER_SLOT_KEY_LATENCY] = "key_latency",
+};
+
+static bool     key_edge_pending = false;
+static uint32_t key_edge_time    = 0;
+static bool     loop_started     = false;
+static uint32_t loop_start       = 0;
+
+/**
+ * \brief Current time in profiler ticks.
+ *
+ * Defaults to the ChibiOS realtime counter (core clock cycles on Cortex-M), falling back to milliseconds
+ * on platforms without a free-running counter wide enough to time a whole loop.
+ */
+__attribute__((weak)) uint32_t task_profiler_timestamp(void) {
+#if defined(PROTOCOL_CHIBIOS)
+    return chSysGetRealtimeCounterX();
+#else
+    return timer_read32();
+#endif
+}
+
+static uint8_t task_profiler_bucket(uint32_t duration) {
+    uint8_t bucket = 0;
+    while (duration) {
+        duration >>= 1;
+        bucket++;
+    }
+    return bucket < TASK_PROFILER_BUCKETS ? bucket : TASK_PROFILER_BUCKETS - 1;
+}
+
+void task_profiler_record(task_profiler_slot_t slot, uint32_t duration) {
+    if (slot >= TASK_PROFILER_SLOT_COUNT) {
+        return;
+    }
+
+    task_profiler_slot_data_t *data = &task_profiler_slots[slot];
+    if (data->count == 0 || duration < data->min) {
+        data->min = duration;
+    }
+    if (duration > data->max) {
+        data->max = duration;
+    }
+    if (data->count < UINT32_MAX) {
+        data->count++;
+    }
+
+    // Halve the histogram rather than saturate it, so the percentiles keep tracking recent behaviour
+    uint8_t bucket = task_profiler_bucket(duration);
+    if (data->buckets[bucket] == UINT16_MAX) {
+        for (uint8_t i = 0; i < TASK_PROFILER_BUCKETS; i++) {
+            data->buckets[i] >>= 1;
+        }
+    }
+    data->buckets[bucket]++;
+}
+
+uint32_t task_profiler_lap(task_profiler_slot_t slot, uint32_t start) {
+    uint32_t now = task_profiler_timestamp();
+    task_profiler_record(slot, now - start);
+    return now;
+}
+
+/**
+ * \brief Upper bound of the bucket holding the given percentile, clamped to the observed range.
+ */
+static uint32_t task_profiler_percentile(const task_profiler_slot_data_t *data, uint8_t percent) {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < TASK_PROFILER_BUCKETS; i++) {
+        total += data->buckets[i];
+    }
+
+    uint32_t target     = (total * percent + 99) / 100;
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < TASK_PROFILER_BUCKETS; i++) {
+        cumulative += data->buckets[i];
+        if (cumulative >= target) {
+            uint32_t upper = i == 0 ? 0 : (i >= 32 ? UINT32_MAX : (((uint32_t)1 << i) - 1));
+            return MIN(MAX(upper, data->min), data->max);
+        }
+    }
+    return data->max;
+}
+
+bool task_profiler_get_stats(task_profiler_slot_t slot, task_profiler_stats_t *stats) {
+    if (slot >= TASK_PROFILER_SLOT_COUNT) {
+        return false;
+    }
+
+    const task_profiler_slot_data_t *data = &task_profiler_slots[slot];
+    memset(stats, 0, sizeof(task_profiler_stats_t));
+    if (data->count == 0) {
+        return true;
+    }
+
+    stats->count = data->count;
+    stats->min   = data->min;
+    stats->p50   = task_profiler_percentile(data, 50);
+    stats->p99   = task_profiler_percentile(data, 99);
+    stats->max   = data->max;
+    return true;
+}
+
+const char *task_profiler_slot_name(task_profiler_slot_t slot) {
+    return slot < TASK_PROFILER_SLOT_COUNT ? task_profiler_slot_names[slot] : "";
+}
+
+void task_profiler_reset(void) {
+    memset(task_profiler_slots, 0, sizeof(task_profiler_slots));
+    key_edge_pending = false;
+    loop_started     = false;
+}
+
+/**
+ * \brief Marks a matrix change; the next keyboard report completes the key latency measurement.
+ */
+void task_profiler_key_edge(void) {
+    if (!key_edge_pending) {
+        key_edge_pending = true;
+        key_edge_time    = task_profiler_timestamp();
+    }
+}
+
+void task_profiler_report_sent(void) {
+    if (key_edge_pending) {
+        key_edge_pending = false;
+        task_profiler_record(TASK_PROFILER_SLOT_KEY_LATENCY, task_profiler_timestamp() - key_edge_time);
+    }
+}
+
+/**
+ * \brief Records the loop period, and prints the statistics every TASK_PROFILER_PRINT_INTERVAL milliseconds.
+ */
+void task_profiler_task(void) {
+    uint32_t now = task_profiler_timestamp();
+    if (loop_started) {
+        task_profiler_record(TASK_PROFILER_SLOT_LOOP, now - loop_start);
+    }
+    loop_started = true;
+    loop_start   = now;
+
+#if TASK_PROFILER_PRINT_INTERVAL > 0
+    static uint32_t last_print = 0;
+    if (timer_elapsed32(last_print) >= TASK_PROFILER_PRINT_INTERVAL) {
+        last_print = timer_read32();
+        task_profiler_print();
+    }
+#endif
+}
+
+void task_profiler_print(void) {
+    task_profiler_stats_t stats;
+    for (uint8_t slot = 0; slot < TASK_PROFILER_SLOT_COUNT; slot++) {
+        task_profiler_get_stats(slot, &stats);
+        if (stats.count == 0) {
+            continue;
+        }
+        uprintf("%-14s n=%lu min=%lu p50=%lu p99=%lu max=%lu\n", task_profiler_slot_name(slot), (unsigned long)stats.count, (unsigned long)stats.min, (unsigned long)stats.p50, (unsigned long)stats.p99, (unsigned long)stats.max);
+    }
+}
+
+static void task_profiler_put_u32(uint8_t *dest, uint32_t value) {
+    dest[0] = (value >> 24) & 0xFF;
+    dest[1] = (value >> 16) & 0xFF;
+    dest[2] = (value >> 8) & 0xFF;
+    dest[3] = value & 0xFF;
+}
+
+/**
+ * \brief Raw HID handler; data[0] is TASK_PROFILER_COMMAND_ID and data[1] the command.
+ *
+ * Responses are written in place, big-endian, starting at data[2].
+ */
+void task_profiler_handle_cmd(uint8_t *data, uint8_t length) {
+    uint8_t *command_id   = &(data[1]);
+    uint8_t *command_data = &(data[2]);
+
+    switch (*command_id) {
+        case id_task_profiler_get_slot_count: {
+            command_data[0] = TASK_PROFILER_SLOT_COUNT;
+            break;
+        }
+        case id_task_profiler_get_stats: {
+            // [slot] -> [slot, count, min, p50, p99, max]
+            task_profiler_stats_t stats;
+            if (length < 23 || !task_profiler_get_stats(command_data[0], &stats)) {
+                *command_id = 0xFF;
+                break;
+            }
+            task_profiler_put_u32(&command_data[1], stats.count);
+            task_profiler_put_u32(&command_data[5], stats.min);
+            task_profiler_put_u32(&command_data[9], stats.p50);
+            task_profiler_put_u32(&command_data[13], stats.p99);
+            task_profiler_put_u32(&command_data[17], stats.max);
+            break;
+        }
+        case id_task_profiler_reset: {
+            task_profiler_reset();
+            break;
+        }
+        default: {
+            *command_id = 0xFF;
+            break;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * \file
+ *
+ * Per-task timing histograms for the main loop.
+ *
+ * Each slot keeps a log2 histogram of the durations recorded against it, along with the exact minimum and
+ * maximum. Durations are in ticks of task_profiler_timestamp(): the realtime counter on ChibiOS, milliseconds
+ * elsewhere.
+ */
+
+#ifndef TASK_PROFILER_BUCKETS
+#    define TASK_PROFILER_BUCKETS 33
+#endif
+
+// Raw HID command prefix, alongside VIA's 0xFC (rpi) and 0xFE (vial)
+#define TASK_PROFILER_COMMAND_ID 0xFD
+
+typedef enum task_profiler_slot_t {
+    TASK_PROFILER_SLOT_LOOP,          // keyboard_task() start to the next keyboard_task() start
+    TASK_PROFILER_SLOT_KEYBOARD_TASK, // the whole of keyboard_task()
+    TASK_PROFILER_SLOT_MATRIX,
+    TASK_PROFILER_SLOT_TRANSACTIONS,
+    TASK_PROFILER_SLOT_QUANTUM,
+    TASK_PROFILER_SLOT_RGBLIGHT,
+    TASK_PROFILER_SLOT_LED_MATRIX,
+    TASK_PROFILER_SLOT_RGB_MATRIX,
+    TASK_PROFILER_SLOT_BACKLIGHT,
+    TASK_PROFILER_SLOT_ENCODER,
+    TASK_PROFILER_SLOT_POINTING,
+    TASK_PROFILER_SLOT_OLED,
+    TASK_PROFILER_SLOT_ST7565,
+    TASK_PROFILER_SLOT_MOUSEKEY,
+    TASK_PROFILER_SLOT_OTHER,       // the remaining, smaller tasks in keyboard_task()
+    TASK_PROFILER_SLOT_HOUSEKEEPING,
+    TASK_PROFILER_SLOT_KEY_LATENCY, // matrix change to the next keyboard report
+    TASK_PROFILER_SLOT_COUNT,
+} task_profiler_slot_t;
+
+typedef struct task_profiler_stats_t {
+    uint32_t count;
+    uint32_t min;
+    uint32_t p50;
+    uint32_t p99;
+    uint32_t max;
+} task_profiler_stats_t;
+
+enum task_profiler_command_id {
+    id_task_profiler_get_slot_count = 0x01,
+    id_task_profiler_get_stats      = 0x02,
+    id_task_profiler_reset          = 0x03,
+};
+
+#ifdef TASK_PROFILER_ENABLE
+
+uint32_t task_profiler_timestamp(void);
+
+void     task_profiler_record(task_profiler_slot_t slot, uint32_t duration);
+uint32_t task_profiler_lap(task_profiler_slot_t slot, uint32_t start);
+
+bool        task_profiler_get_stats(task_profiler_slot_t slot, task_profiler_stats_t *stats);
+const char *task_profiler_slot_name(task_profiler_slot_t slot);
+void        task_profiler_reset(void);
+
+void task_profiler_key_edge(void);
+void task_profiler_report_sent(void);
+
+void task_profiler_task(void);
+void task_profiler_print(void);
+void task_profiler_handle_cmd(uint8_t *data, uint8_t length);
+
+/**
+ * Records the time between consecutive TASK_PROFILER_LAP()s, starting from TASK_PROFILER_START(), so that a
+ * run of tasks can be instrumented with a single line after each. TASK_PROFILER_TOTAL() records the time from
+ * TASK_PROFILER_START() to the last lap.
+ */
+#    define TASK_PROFILER_START()                                                                   \
+        __attribute__((unused)) const uint32_t task_profiler_start     = task_profiler_timestamp(); \
+        uint32_t                               task_profiler_lap_start = task_profiler_start
+#    define TASK_PROFILER_LAP(slot) task_profiler_lap_start = task_profiler_lap(slot, task_profiler_lap_start)
+#    define TASK_PROFILER_TOTAL(slot) task_profiler_record(slot, task_profiler_lap_start - task_profiler_start)
+// Moves the lap start to now, for work that was timed separately
+#    define TASK_PROFILER_SKIP() task_profiler_lap_start = task_profiler_timestamp()
+
+#else
+
+#    define TASK_PROFILER_START()
+#    define TASK_PROFILER_LAP(slot)
+#    define TASK_PROFILER_TOTAL(slot)
+#    define TASK_PROFILER_SKIP()
+#    define task_profiler_key_edge()
+#    define task_profiler_report_sent()
+#    define task_profiler_task()
+
+#endif
@@ -0,0 +1,144 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "task_scheduler.h"
+#include "timer.h"
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+#elif defined(__AVR__)
+#    include <avr/io.h>
+#    include "timer_avr.h"
+#endif
+
+typedef struct task_scheduler_entry_t {
+    task_scheduler_task_t  task;
+    int8_t                 id;
+    bool                   has_run;
+    uint8_t                deferred; // consecutive passes the task has been put off
+    uint32_t               last_run; // milliseconds
+    task_scheduler_stats_t stats;
+} task_scheduler_entry_t;
+
+// Kept in priority order, tasks of equal priority in the order they were added
+static task_scheduler_entry_t entries[TASK_SCHEDULER_MAX_TASKS];
+static uint8_t                entry_count = 0;
+static uint32_t               pass_start  = 0;
+
+/**
+ * \brief Current time in microseconds.
+ *
+ * Follows the system timer on ChibiOS, so it advances in steps of 1/CH_CFG_ST_FREQUENCY seconds. On AVR the
+ * position of timer 0 within the current millisecond is added to the millisecond count. Elsewhere it only
+ * has millisecond resolution.
+ */
+__attribute__((weak)) uint32_t task_scheduler_timestamp(void) {
+#if defined(PROTOCOL_CHIBIOS)
+    // Accumulated from tick deltas, so that it wraps cleanly at 2^32 whatever the width of the system timer
+    static systime_t last_ticks = 0;
+    static uint32_t  elapsed    = 0;
+
+    systime_t ticks = chVTGetSystemTimeX();
+    elapsed += TIME_I2US(chTimeDiffX(last_ticks, ticks));
+    last_ticks = ticks;
+    return elapsed;
+#elif defined(__AVR__)
+    uint32_t ms;
+    uint8_t  raw;
+    // Read again if the millisecond interrupt fired in between
+    do {
+        ms  = timer_read32();
+        raw = TIMER_RAW;
+    } while (ms != timer_read32());
+    return ms * 1000 + (uint32_t)raw * 1000 / (TIMER_RAW_TOP + 1);
+#else
+    return timer_read32() * 1000;
+#endif
+}
+
+void task_scheduler_init(void) {
+    entry_count = 0;
+}
+
+int8_t task_scheduler_add(const task_scheduler_task_t *task) {
+    if (entry_count == TASK_SCHEDULER_MAX_TASKS) {
+        return -1;
+    }
+
+    uint8_t index = entry_count;
+    while (index > 0 && entries[index - 1].task.priority < task->priority) {
+        entries[index] = entries[index - 1];
+        index--;
+    }
+
+    memset(&entries[index], 0, sizeof(task_scheduler_entry_t));
+    entries[index].task = *task;
+    entries[index].id   = entry_count++;
+    return entries[index].id;
+}
+
+void task_scheduler_begin(void) {
+    pass_start = task_scheduler_timestamp();
+}
+
+static void run_entry(task_scheduler_entry_t *entry, uint32_t now) {
+#ifdef TASK_PROFILER_ENABLE
+    uint32_t profiler_start = task_profiler_timestamp();
+#endif
+    uint32_t start = task_scheduler_timestamp();
+
+    entry->task.task();
+
+    uint32_t duration = task_scheduler_timestamp() - start;
+#ifdef TASK_PROFILER_ENABLE
+    task_profiler_lap(entry->task.profiler_slot, profiler_start);
+#endif
+
+    entry->has_run  = true;
+    entry->deferred = 0;
+    entry->last_run = now;
+    entry->stats.runs++;
+    if (duration > entry->task.budget) {
+        entry->stats.overruns++;
+    }
+    if (duration > entry->stats.max_duration) {
+        entry->stats.max_duration = duration;
+    }
+}
+
+void task_scheduler_task(void) {
+    for (uint8_t i = 0; i < entry_count; i++) {
+        task_scheduler_entry_t *entry = &entries[i];
+        uint32_t                now   = timer_read32();
+
+        if (entry->has_run && TIMER_DIFF_32(now, entry->last_run) < entry->task.period) {
+            continue;
+        }
+
+        // Put the task off if it would keep the next matrix scan waiting, unless it has been waiting too long itself
+        if (task_scheduler_timestamp() - pass_start + entry->task.budget > TASK_SCHEDULER_SCAN_INTERVAL && entry->deferred < TASK_SCHEDULER_MAX_DEFERRALS) {
+            entry->deferred++;
+            entry->stats.deferrals++;
+            continue;
+        }
+
+        run_entry(entry, now);
+    }
+}
+
+bool task_scheduler_get_stats(int8_t id, task_scheduler_stats_t *stats) {
+    for (uint8_t i = 0; i < entry_count; i++) {
+        if (entries[i].id == id) {
+            *stats = entries[i].stats;
+            return true;
+        }
+    }
+    return false;
+}
+
+void task_scheduler_reset_stats(void) {
+    for (uint8_t i = 0; i < entry_count; i++) {
+        memset(&entries[i].stats, 0, sizeof(task_scheduler_stats_t));
+    }
+}
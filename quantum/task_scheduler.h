@@ -0,0 +1,99 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "task_profiler.h"
+
+/**
+ * \file
+ *
+ * Cooperative scheduling for the deferrable tasks of the main loop, such as lighting and displays.
+ *
+ * The matrix scan and the input tasks run on every pass. The deferrable tasks run after them, highest priority
+ * first, and only while the pass can still finish within TASK_SCHEDULER_SCAN_INTERVAL: a task whose budget would
+ * take the pass past it waits for a later pass. A task is never put off more than TASK_SCHEDULER_MAX_DEFERRALS
+ * times in a row. Budgets, durations and the scan interval are in microseconds, as measured by
+ * task_scheduler_timestamp(); periods are in milliseconds.
+ */
+
+#ifndef TASK_SCHEDULER_MAX_TASKS
+#    define TASK_SCHEDULER_MAX_TASKS 8
+#endif
+
+#ifndef TASK_SCHEDULER_SCAN_INTERVAL
+#    define TASK_SCHEDULER_SCAN_INTERVAL 2000
+#endif
+
+#ifndef TASK_SCHEDULER_MAX_DEFERRALS
+#    define TASK_SCHEDULER_MAX_DEFERRALS 16
+#endif
+
+// The built in lighting tasks: rgblight, LED matrix, RGB matrix and backlight
+#ifndef TASK_SCHEDULER_LIGHTING_PERIOD
+#    define TASK_SCHEDULER_LIGHTING_PERIOD 0
+#endif
+#ifndef TASK_SCHEDULER_LIGHTING_PRIORITY
+#    define TASK_SCHEDULER_LIGHTING_PRIORITY 1
+#endif
+#ifndef TASK_SCHEDULER_LIGHTING_BUDGET
+#    define TASK_SCHEDULER_LIGHTING_BUDGET 1000
+#endif
+
+// The built in display tasks: OLED and ST7565
+#ifndef TASK_SCHEDULER_DISPLAY_PERIOD
+#    define TASK_SCHEDULER_DISPLAY_PERIOD 0
+#endif
+#ifndef TASK_SCHEDULER_DISPLAY_PRIORITY
+#    define TASK_SCHEDULER_DISPLAY_PRIORITY 0
+#endif
+#ifndef TASK_SCHEDULER_DISPLAY_BUDGET
+#    define TASK_SCHEDULER_DISPLAY_BUDGET 2000
+#endif
+
+typedef struct task_scheduler_task_t {
+    void (*task)(void);
+    uint16_t             period;        // minimum milliseconds between runs, 0 to run on every pass
+    uint8_t              priority;      // higher priority tasks run first
+    uint16_t             budget;        // microseconds a run is expected to take
+    task_profiler_slot_t profiler_slot; // TASK_PROFILER_SLOT_COUNT for none
+} task_scheduler_task_t;
+
+typedef struct task_scheduler_stats_t {
+    uint32_t runs;
+    uint32_t deferrals;    // passes on which the task was due, but put off to protect the scan interval
+    uint32_t overruns;     // runs which took longer than the budget
+    uint32_t max_duration; // microseconds
+} task_scheduler_stats_t;
+
+/**
+ * \brief Current time in microseconds, wrapping at 2^32.
+ */
+uint32_t task_scheduler_timestamp(void);
+
+/**
+ * \brief Removes all tasks.
+ */
+void task_scheduler_init(void);
+
+/**
+ * \brief Adds a deferrable task, which is copied.
+ *
+ * \return The task's id, or -1 if TASK_SCHEDULER_MAX_TASKS tasks have already been added.
+ */
+int8_t task_scheduler_add(const task_scheduler_task_t *task);
+
+/**
+ * \brief Marks the start of a pass through the main loop, before the matrix scan.
+ */
+void task_scheduler_begin(void);
+
+/**
+ * \brief Runs the deferrable tasks which are due, as the time left in the pass allows.
+ */
+void task_scheduler_task(void);
+
+bool task_scheduler_get_stats(int8_t id, task_scheduler_stats_t *stats);
+void task_scheduler_reset_stats(void);
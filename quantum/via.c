@@ -53,6 +53,9 @@
 #include "raw_hid.h"
 #include "dynamic_keymap.h"
 #include "eeprom.h"
+#ifdef EEPROM_DRIVER
+#    include "eeprom_driver.h"
+#endif
 #include "version.h" // for QMK_BUILDDATE used in EEPROM magic
 #include "quantum/nvm/eeprom/nvm_eeprom_eeconfig_internal.h"
 #include "quantum/nvm/eeprom/nvm_eeprom_via_internal.h"
@@ -64,6 +67,9 @@
 #ifdef RPI_ENABLE
 #include "rpi.h"
 #endif
+#ifdef TASK_PROFILER_ENABLE
+#include "task_profiler.h"
+#endif
 
 #ifdef VIALRGB_ENABLE
 #include "vialrgb.h"
@@ -446,6 +452,9 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             raw_hid_send(data, length);
             // Give host time to read it
             wait_ms(100);
+#ifdef EEPROM_DRIVER
+            eeprom_driver_flush();
+#endif
             bootloader_jump();
             break;
         }
@@ -461,6 +470,12 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             rpi_handle_cmd(data, length);
             break;
         }
+#endif
+#ifdef TASK_PROFILER_ENABLE
+        case id_task_profiler_prefix: {
+            task_profiler_handle_cmd(data, length);
+            break;
+        }
 #endif
         default: {
             // The command ID is not known let the keyboard implement it
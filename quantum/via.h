@@ -75,6 +75,7 @@ enum via_command_id {
     id_dynamic_keymap_get_buffer            = 0x12,
     id_dynamic_keymap_set_buffer            = 0x13,
     id_rpi_prefix                           = 0xFC,
+    id_task_profiler_prefix                 = 0xFD,
     id_vial_prefix                          = 0xFE,
     id_unhandled                            = 0xFF,
 };
@@ -572,6 +572,10 @@ static void reload_combo(void) {
             key_combos[i].keycode = entry.output;
         }
     }
+
+#ifdef COMBO_KEY_INDEX
+    combo_key_index_rebuild();
+#endif
 }
 #endif
 
@@ -64,3 +64,17 @@ wear_leveling_8byte_SRC := \
 	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_8byte.cpp
 wear_leveling_8byte_INC := \
 	$(wear_leveling_common_INC)
+
+wear_leveling_2byte_coalescing_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=8192 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=1024 \
+	-DWEAR_LEVELING_WRITE_COALESCING \
+	-DWEAR_LEVELING_WRITE_BATCHING \
+	-DWEAR_LEVELING_BOOT_CONSOLIDATE_THRESHOLD=2048
+wear_leveling_2byte_coalescing_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_2byte_coalescing.cpp
+wear_leveling_2byte_coalescing_INC := \
+	$(wear_leveling_common_INC)
@@ -0,0 +1,176 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <numeric>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+class WearLeveling2ByteCoalescing : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        MockBackingStore::Instance().reset_instance();
+        std::fill(verify_data.begin(), verify_data.end(), 0);
+        wear_leveling_init();
+    }
+
+    static std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> verify_data;
+
+    static wear_leveling_status_t test_write(const uint32_t address, const void* value, size_t length) {
+        memcpy(&verify_data[address], value, length);
+        return wear_leveling_write(address, value, length);
+    }
+
+    /* Writes and flushes, returning the number of backing store writes it took. */
+    static std::uint64_t logged_writes(const uint32_t address, const void* value, size_t length) {
+        auto&         inst   = MockBackingStore::Instance();
+        std::uint64_t before = inst.total_write_count();
+        EXPECT_NE(test_write(address, value, length), WEAR_LEVELING_FAILED) << "Write failed";
+        EXPECT_NE(wear_leveling_flush(), WEAR_LEVELING_FAILED) << "Flush failed";
+        return inst.total_write_count() - before;
+    }
+
+    static void verify_reload() {
+        EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Reload failed";
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+        wear_leveling_read(0, readback.data(), readback.size());
+        EXPECT_THAT(readback, testing::ElementsAreArray(verify_data)) << "Reloaded data mismatch";
+    }
+};
+
+std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> WearLeveling2ByteCoalescing::verify_data;
+
+/**
+ * This test verifies that only the changed bytes of a rewritten block are logged.
+ */
+TEST_F(WearLeveling2ByteCoalescing, RewriteOnlyLogsChangedBytes) {
+    std::vector<std::uint8_t> block(64, 0x55);
+    logged_writes(256, block.data(), block.size());
+
+    block[3]  = 0x66;
+    block[50] = 0x77;
+    // Two single-byte multibyte entries, instead of 13 entries covering the whole block
+    EXPECT_EQ(logged_writes(256, block.data(), block.size()), 4);
+
+    verify_reload();
+}
+
+/**
+ * This test verifies that changes separated by a short gap share a log entry when that is no more expensive.
+ */
+TEST_F(WearLeveling2ByteCoalescing, NearbyChangesShareAnEntry) {
+    std::vector<std::uint8_t> block(16, 0x55);
+    logged_writes(512, block.data(), block.size());
+
+    block[10] = 0x01;
+    block[12] = 0x02;
+    // One 3-byte entry (3 writes) beats two 1-byte entries (2 writes each)
+    EXPECT_EQ(logged_writes(512, block.data(), block.size()), 3);
+
+    verify_reload();
+}
+
+/**
+ * This test verifies that batched writes are held back until flushed, with overlapping writes merged.
+ */
+TEST_F(WearLeveling2ByteCoalescing, BatchedWritesAreDeferred) {
+    auto& inst = MockBackingStore::Instance();
+
+    for (std::uint8_t i = 1; i <= 20; ++i) {
+        std::uint8_t value[2] = {i, (std::uint8_t)(i + 0x40)};
+        EXPECT_EQ(test_write(300 + (i % 3), value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write failed";
+    }
+    EXPECT_EQ(inst.total_write_count(), 0) << "Nothing should have been logged before flushing";
+    EXPECT_TRUE(wear_leveling_has_pending());
+
+    std::uint8_t readback[4];
+    wear_leveling_read(300, readback, sizeof(readback));
+    EXPECT_THAT(readback, testing::ElementsAreArray(&verify_data[300], sizeof(readback))) << "Reads should be served from the cache";
+
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_SUCCESS) << "Flush failed";
+    EXPECT_FALSE(wear_leveling_has_pending());
+    // All writes landed within 300..303, so a single 4-byte entry covers them
+    EXPECT_EQ(inst.total_write_count(), 4);
+
+    verify_reload();
+}
+
+/**
+ * This test verifies that running out of pending ranges forces a flush.
+ */
+TEST_F(WearLeveling2ByteCoalescing, BatchOverflowFlushes) {
+    auto& inst = MockBackingStore::Instance();
+
+    for (std::uint32_t i = 0; i < WEAR_LEVELING_WRITE_BATCH_RANGES; ++i) {
+        std::uint8_t value = 0x80 + i;
+        EXPECT_EQ(test_write(100 + (i * 16), &value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write failed";
+    }
+    EXPECT_EQ(inst.total_write_count(), 0) << "Nothing should have been logged before the table filled";
+
+    std::uint8_t value = 0xEE;
+    EXPECT_EQ(test_write(900, &value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write failed";
+    EXPECT_EQ(inst.total_write_count(), WEAR_LEVELING_WRITE_BATCH_RANGES * 2) << "Pending ranges should have been flushed";
+
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_SUCCESS) << "Flush failed";
+    verify_reload();
+}
+
+/**
+ * A Vial-style keymap upload, rewriting every keycode in 28-byte chunks with one in eight keycodes changed.
+ */
+TEST_F(WearLeveling2ByteCoalescing, KeymapUploadLogsOnlyChangedKeycodes) {
+    constexpr std::size_t keymap_bytes = 4 * 4 * 10 * 2; // layers * rows * cols * sizeof(uint16_t)
+    constexpr std::size_t chunk        = 28;
+
+    std::vector<std::uint8_t> keymap(keymap_bytes);
+    for (std::size_t i = 0; i < keymap.size(); i += 2) {
+        keymap[i]     = (std::uint8_t)(0x04 + (i / 2) % 0x20);
+        keymap[i + 1] = 0;
+    }
+    for (std::size_t offset = 0; offset < keymap.size(); offset += chunk) {
+        logged_writes(64 + offset, &keymap[offset], std::min(chunk, keymap.size() - offset));
+    }
+
+    std::size_t changed = 0;
+    for (std::size_t i = 0; i < keymap.size(); i += 16) {
+        keymap[i] = 0x29;
+        ++changed;
+    }
+    std::uint64_t before = MockBackingStore::Instance().total_write_count();
+    for (std::size_t offset = 0; offset < keymap.size(); offset += chunk) {
+        EXPECT_EQ(test_write(64 + offset, &keymap[offset], std::min(chunk, keymap.size() - offset)), WEAR_LEVELING_SUCCESS) << "Write failed";
+    }
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_SUCCESS) << "Flush failed";
+    std::uint64_t entries = MockBackingStore::Instance().total_write_count() - before;
+
+    EXPECT_LE(entries, changed * 3) << "Each changed keycode should cost at most one multibyte entry";
+
+    verify_reload();
+}
+
+/**
+ * Boot with a long write log, then boot again after the snapshot was taken.
+ */
+TEST_F(WearLeveling2ByteCoalescing, ConsolidatedBootPlaybackReadsLess) {
+    auto& inst = MockBackingStore::Instance();
+
+    for (std::uint32_t i = 0; i < 1200; ++i) {
+        std::uint8_t value = (std::uint8_t)(2 + (i % 250));
+        logged_writes(100 + (i % 800), &value, sizeof(value));
+    }
+    ASSERT_EQ(inst.erasure_count(), 0) << "The log should not have filled up";
+
+    std::uint64_t before = inst.read_invoke_count();
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_CONSOLIDATED) << "Long playback should consolidate";
+    std::uint64_t long_playback = inst.read_invoke_count() - before;
+    EXPECT_EQ(inst.erasure_count(), 1);
+
+    before = inst.read_invoke_count();
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Second playback should not consolidate";
+    std::uint64_t short_playback = inst.read_invoke_count() - before;
+    EXPECT_EQ(inst.erasure_count(), 1);
+
+    // The snapshot is read in both cases, only the first one also walks the 1200 logged writes
+    EXPECT_GE(long_playback - short_playback, 1200u) << "Playback after consolidation should not replay the old log";
+
+    verify_reload();
+}
@@ -62,6 +62,20 @@
             to other subsystems performing reads/writes. This must be a multiple
             of the write size.
 
+        - WEAR_LEVELING_WRITE_COALESCING: Optional. Logs only the bytes which
+            changed within each write, rather than the entire written block.
+
+        - WEAR_LEVELING_WRITE_BATCHING: Optional. Defers logging of written
+            ranges until wear_leveling_flush() is invoked, merging overlapping
+            and touching ranges in the meantime. Up to
+            WEAR_LEVELING_WRITE_BATCH_RANGES ranges are held before a flush is
+            forced.
+
+        - WEAR_LEVELING_BOOT_CONSOLIDATE_THRESHOLD: Optional. If the write log
+            played back during initialization is at least this many bytes,
+            the cache is consolidated straight away so that subsequent boots
+            have no long replay.
+
     General algorithm:
 
         During initialization:
@@ -156,6 +170,16 @@
         ╚════════════════╝
         0 <= Address <= 0x3FFE (16382) */
 
+#ifdef WEAR_LEVELING_WRITE_BATCHING
+/**
+ * Range of logical data which has been updated in the cache but not yet appended to the write log.
+ */
+typedef struct wear_leveling_range_t {
+    uint32_t address;
+    uint32_t length;
+} wear_leveling_range_t;
+#endif // WEAR_LEVELING_WRITE_BATCHING
+
 /**
  * Storage area for the wear-leveling cache.
  */
@@ -163,6 +187,10 @@ static struct __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) {
     __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) uint8_t cache[(WEAR_LEVELING_LOGICAL_SIZE)];
     uint32_t                                                       write_address;
     bool                                                           unlocked;
+#ifdef WEAR_LEVELING_WRITE_BATCHING
+    wear_leveling_range_t pending[(WEAR_LEVELING_WRITE_BATCH_RANGES)];
+    uint8_t               pending_count;
+#endif // WEAR_LEVELING_WRITE_BATCHING
 } wear_leveling;
 
 /**
@@ -204,6 +232,9 @@ static inline backing_store_lock_status_t wear_leveling_lock(void) {
 static void wear_leveling_clear_cache(void) {
     memset(wear_leveling.cache, 0, (WEAR_LEVELING_LOGICAL_SIZE));
     wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 is due to the FNV1a_64 of the consolidated buffer
+#ifdef WEAR_LEVELING_WRITE_BATCHING
+    wear_leveling.pending_count = 0;
+#endif // WEAR_LEVELING_WRITE_BATCHING
 }
 
 /**
@@ -470,6 +501,134 @@ static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const vo
     return status;
 }
 
+#ifdef WEAR_LEVELING_WRITE_COALESCING
+/**
+ * Determines the number of backing store writes wear_leveling_write_raw() would perform for the supplied data.
+ */
+static size_t wear_leveling_write_raw_cost(uint32_t address, const uint8_t *p, size_t remaining) {
+    size_t cost = 0;
+    while (remaining > 0) {
+#    if BACKING_STORE_WRITE_SIZE == 2
+        if (remaining >= 2 && address % 2 == 0 && address < 16384) {
+            const uint16_t v = ((uint16_t)p[1]) << 8 | p[0];
+            if (v == 0 || v == 1) {
+                cost += 1;
+                remaining -= 2;
+                address += 2;
+                p += 2;
+                continue;
+            }
+        }
+
+        if (address < 64) {
+            cost += 1;
+            remaining--;
+            address++;
+            p++;
+            continue;
+        }
+#    endif // BACKING_STORE_WRITE_SIZE == 2
+        const size_t this_length = remaining >= LOG_ENTRY_MULTIBYTE_MAX_BYTES ? LOG_ENTRY_MULTIBYTE_MAX_BYTES : remaining;
+#    if BACKING_STORE_WRITE_SIZE == 2
+        cost += 2 + (this_length > 1 ? 1 : 0) + (this_length > 3 ? 1 : 0);
+#    elif BACKING_STORE_WRITE_SIZE == 4
+        cost += 1 + (this_length > 1 ? 1 : 0);
+#    elif BACKING_STORE_WRITE_SIZE == 8
+        cost += 1;
+#    endif
+        remaining -= this_length;
+        address += (uint32_t)this_length;
+        p += this_length;
+    }
+    return cost;
+}
+#endif // WEAR_LEVELING_WRITE_COALESCING
+
+/**
+ * Appends the cached logical data for the supplied range to the write log, consolidating if required.
+ * The backing store must already be unlocked.
+ */
+static wear_leveling_status_t wear_leveling_append_cached(uint32_t address, size_t length) {
+    wear_leveling_status_t status = wear_leveling_write_raw(address, &wear_leveling.cache[address], length);
+    switch (status) {
+        case WEAR_LEVELING_CONSOLIDATED:
+        case WEAR_LEVELING_FAILED:
+            // If the write triggered consolidation, or the write failed, then nothing else needs to occur.
+            break;
+
+        case WEAR_LEVELING_SUCCESS:
+            // Consolidate the cache + write log if required
+            status = wear_leveling_consolidate_if_needed();
+            break;
+
+        default:
+            // Unsure how we'd get here...
+            status = WEAR_LEVELING_FAILED;
+            break;
+    }
+    return status;
+}
+
+#ifdef WEAR_LEVELING_WRITE_BATCHING
+/**
+ * Appends all pending ranges to the write log. The backing store must already be unlocked.
+ */
+static wear_leveling_status_t wear_leveling_flush_pending(void) {
+    wear_leveling_status_t status = WEAR_LEVELING_SUCCESS;
+    for (uint8_t i = 0; i < wear_leveling.pending_count; ++i) {
+        status = wear_leveling_append_cached(wear_leveling.pending[i].address, wear_leveling.pending[i].length);
+        if (status != WEAR_LEVELING_SUCCESS) {
+            // If consolidation occurred, the cache already holds every pending range, so they're all persisted.
+            // If a failure occurred, pass it on.
+            break;
+        }
+    }
+    wear_leveling.pending_count = 0;
+    return status;
+}
+
+/**
+ * Records a range of the cache as needing to be written, merging it with any touching or overlapping pending range.
+ * Flushes everything pending if no free slot remains. The backing store must already be unlocked.
+ */
+static wear_leveling_status_t wear_leveling_defer(uint32_t address, size_t length) {
+    uint32_t end = address + (uint32_t)length;
+    for (uint8_t i = 0; i < wear_leveling.pending_count; ++i) {
+        wear_leveling_range_t *range     = &wear_leveling.pending[i];
+        uint32_t               range_end = range->address + range->length;
+        if (address <= range_end && range->address <= end) {
+            range->address = address < range->address ? address : range->address;
+            range->length  = (end > range_end ? end : range_end) - range->address;
+            return WEAR_LEVELING_SUCCESS;
+        }
+    }
+
+    wear_leveling_status_t status = WEAR_LEVELING_SUCCESS;
+    if (wear_leveling.pending_count == (WEAR_LEVELING_WRITE_BATCH_RANGES)) {
+        status = wear_leveling_flush_pending();
+        if (status == WEAR_LEVELING_FAILED) {
+            return status;
+        }
+    }
+
+    wear_leveling.pending[wear_leveling.pending_count++] = (wear_leveling_range_t){.address = address, .length = (uint32_t)length};
+    return status;
+}
+#endif // WEAR_LEVELING_WRITE_BATCHING
+
+/**
+ * Updates the cache with the supplied range, then either logs it or defers it for a later flush.
+ * The backing store must already be unlocked.
+ */
+static wear_leveling_status_t wear_leveling_commit(uint32_t address, const uint8_t *value, size_t length) {
+    memcpy(&wear_leveling.cache[address], value, length);
+#ifdef WEAR_LEVELING_WRITE_BATCHING
+    return wear_leveling_defer(address, length);
+#else
+    return wear_leveling_append_cached(address, length);
+#endif // WEAR_LEVELING_WRITE_BATCHING
+}
+
 /**
  * "Replays" the write log from the backing store, updating the local cache with updated values.
  */
@@ -604,6 +763,12 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
     if (status == WEAR_LEVELING_FAILED) {
         // If we had a failure during readback, assume we're corrupted -- force a consolidation with the data we already have
         status = wear_leveling_consolidate_force();
+#ifdef WEAR_LEVELING_BOOT_CONSOLIDATE_THRESHOLD
+    } else if (address - ((WEAR_LEVELING_LOGICAL_SIZE) + 8) >= (WEAR_LEVELING_BOOT_CONSOLIDATE_THRESHOLD)) {
+        // Long replay -- snapshot the cache into the consolidated area so the next boot can skip it
+        wl_dprintf("Write log exceeds boot threshold, consolidating\n");
+        status = wear_leveling_consolidate_force();
+#endif // WEAR_LEVELING_BOOT_CONSOLIDATE_THRESHOLD
     } else {
         // Consolidate the cache + write log if required
         status = wear_leveling_consolidate_if_needed();
@@ -689,35 +854,87 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
         return true;
     }
 
-    // Update the cache before writing to the backing store -- if we hit the end of the backing store during writes to the log then we'll force a consolidation in-line
-    memcpy(&wear_leveling.cache[address], value, length);
-
     // Unlock the backing store
     backing_store_lock_status_t lock_status = wear_leveling_unlock();
     if (lock_status == STATUS_FAILURE) {
+        memcpy(&wear_leveling.cache[address], value, length);
         wear_leveling_lock();
         return WEAR_LEVELING_FAILED;
     }
 
-    // Perform the actual write
-    wear_leveling_status_t status = wear_leveling_write_raw(address, value, length);
-    switch (status) {
-        case WEAR_LEVELING_CONSOLIDATED:
-        case WEAR_LEVELING_FAILED:
-            // If the write triggered consolidation, or the write failed, then nothing else needs to occur.
-            break;
+    // Each range is copied into the cache before writing to the backing store -- if we hit the end of the backing store during writes to the log then we'll force a consolidation in-line
+    wear_leveling_status_t status = WEAR_LEVELING_SUCCESS;
+#ifdef WEAR_LEVELING_WRITE_COALESCING
+    // Only log the changed bytes, joining neighbouring changes whenever a single entry is no more expensive than two
+    const uint8_t *p          = value;
+    size_t         span_start = 0;
+    size_t         span_end   = 0;
+    size_t         i          = 0;
+    while (i < length && status != WEAR_LEVELING_FAILED) {
+        if (p[i] == wear_leveling.cache[address + i]) {
+            ++i;
+            continue;
+        }
+        const size_t run_start = i;
+        while (i < length && p[i] != wear_leveling.cache[address + i]) {
+            ++i;
+        }
 
-        case WEAR_LEVELING_SUCCESS:
-            // Consolidate the cache + write log if required
-            status = wear_leveling_consolidate_if_needed();
-            break;
+        if (span_end > span_start) {
+            size_t joined   = wear_leveling_write_raw_cost(address + span_start, &p[span_start], i - span_start);
+            size_t separate = wear_leveling_write_raw_cost(address + span_start, &p[span_start], span_end - span_start) + wear_leveling_write_raw_cost(address + run_start, &p[run_start], i - run_start);
+            if (joined <= separate) {
+                span_end = i;
+                continue;
+            }
 
-        default:
-            // Unsure how we'd get here...
+            wear_leveling_status_t span_status = wear_leveling_commit(address + span_start, &p[span_start], span_end - span_start);
+            status                             = (span_status == WEAR_LEVELING_SUCCESS) ? status : span_status;
+        }
+        span_start = run_start;
+        span_end   = i;
+    }
+    if (status != WEAR_LEVELING_FAILED && span_end > span_start) {
+        wear_leveling_status_t span_status = wear_leveling_commit(address + span_start, &p[span_start], span_end - span_start);
+        status                             = (span_status == WEAR_LEVELING_SUCCESS) ? status : span_status;
+    }
+    if (status == WEAR_LEVELING_FAILED) {
+        // Keep the cache consistent with what the caller asked for, even if logging failed part-way through
+        memcpy(&wear_leveling.cache[address], value, length);
+    }
+#else
+    status = wear_leveling_commit(address, value, length);
+#endif // WEAR_LEVELING_WRITE_COALESCING
+
+    if (lock_status == STATUS_SUCCESS) {
+        if (wear_leveling_lock() == STATUS_FAILURE) {
             status = WEAR_LEVELING_FAILED;
-            break;
+        }
+    }
+
+    return status;
+}
+
+#ifdef WEAR_LEVELING_WRITE_BATCHING
+/**
+ * Writes any deferred data into the backing store.
+ */
+wear_leveling_status_t wear_leveling_flush(void) {
+    if (wear_leveling.pending_count == 0) {
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    wl_dprintf("Flush\n");
+
+    // Unlock the backing store
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    if (lock_status == STATUS_FAILURE) {
+        wear_leveling_lock();
+        return WEAR_LEVELING_FAILED;
     }
 
+    wear_leveling_status_t status = wear_leveling_flush_pending();
+
     if (lock_status == STATUS_SUCCESS) {
         if (wear_leveling_lock() == STATUS_FAILURE) {
             status = WEAR_LEVELING_FAILED;
@@ -727,6 +944,14 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
     return status;
 }
 
+/**
+ * Checks whether any written data is still waiting for a flush.
+ */
+bool wear_leveling_has_pending(void) {
+    return wear_leveling.pending_count > 0;
+}
+#endif // WEAR_LEVELING_WRITE_BATCHING
+
 /**
  * Reads logical data from the cache.
  */
@@ -1,6 +1,7 @@
 // Copyright 2022 Nick Brassel (@tzarc)
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -34,7 +35,11 @@ wear_leveling_status_t wear_leveling_erase(void);
  *
  * Skips writes if there are no changes to written values. The entire written block is considered when attempting to
  * determine if an overwrite should occur -- if there is any data mismatch the entire block will be written to the log,
- * not just the changed bytes.
+ * not just the changed bytes. With WEAR_LEVELING_WRITE_COALESCING defined, only the changed bytes are logged, with
+ * nearby changes merged into a single entry when that needs no extra backing store writes.
+ *
+ * With WEAR_LEVELING_WRITE_BATCHING defined, the cache is updated immediately but logging is deferred until
+ * wear_leveling_flush() is invoked, or until the pending range table is full.
  *
  * @param address[in] the logical address to write data
  * @param value[in] pointer to the source buffer
@@ -52,3 +57,19 @@ wear_leveling_status_t wear_leveling_write(uint32_t address, const void* value,
  * @return Status of the request
  */
 wear_leveling_status_t wear_leveling_read(uint32_t address, void* value, size_t length);
+
+#ifdef WEAR_LEVELING_WRITE_BATCHING
+/**
+ * Writes any deferred data into the backing store.
+ *
+ * @return Status of the request
+ */
+wear_leveling_status_t wear_leveling_flush(void);
+
+/**
+ * Checks whether any written data has yet to be flushed to the backing store.
+ *
+ * @return true if a flush is required
+ */
+bool wear_leveling_has_pending(void);
+#endif // WEAR_LEVELING_WRITE_BATCHING
@@ -25,6 +25,12 @@ typedef uint64_t backing_store_int_t;
 #    error WEAR_LEVELING_LOGICAL_SIZE was not set.
 #endif
 
+#ifdef WEAR_LEVELING_WRITE_BATCHING
+#    ifndef WEAR_LEVELING_WRITE_BATCH_RANGES
+#        define WEAR_LEVELING_WRITE_BATCH_RANGES 8
+#    endif
+#endif // WEAR_LEVELING_WRITE_BATCHING
+
 #ifdef WEAR_LEVELING_DEBUG_OUTPUT
 #    include <debug.h>
 #    define bs_dprintf(...) dprintf("Backing store: " __VA_ARGS__)
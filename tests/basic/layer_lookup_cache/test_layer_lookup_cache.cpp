@@ -0,0 +1,134 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+
+class LayerLookupCache : public TestFixture {
+   protected:
+    /* Reference implementation: the uncached top-down walk over the active layers. */
+    uint8_t expected_layer(layer_state_t layers, keypos_t position) const {
+        for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
+            if (layers & ((layer_state_t)1 << i)) {
+                const KeymapKey* key = find_key(i, position);
+                if (key != nullptr && key->code != KC_TRANSPARENT) {
+                    return i;
+                }
+            }
+        }
+        return 0;
+    }
+
+    void expect_lookup_matches_walk(const std::vector<keypos_t>& positions) {
+        for (layer_state_t default_layers : {(layer_state_t)0b0001, (layer_state_t)0b0010}) {
+            default_layer_set(default_layers);
+            for (layer_state_t layers = 0; layers < 0b10000; layers++) {
+                layer_state_set(layers);
+                for (keypos_t position : positions) {
+                    EXPECT_EQ(layer_switch_get_layer(position), expected_layer(layers | default_layers, position)) << "layer state " << +layers << ", default layer state " << +default_layers << ", (column,row) (" << +position.col << "," << +position.row << ")";
+                }
+            }
+        }
+        default_layer_set(1);
+        layer_clear();
+    }
+};
+
+TEST_F(LayerLookupCache, LookupMatchesLayerWalk) {
+    TestDriver driver;
+
+    /* Each column exercises a different pattern of transparent keys across layers 0-3. */
+    set_keymap({
+        KeymapKey{0, 0, 0, KC_A},    KeymapKey{1, 0, 0, KC_B},    KeymapKey{2, 0, 0, KC_C},    KeymapKey{3, 0, 0, KC_D},
+        KeymapKey{0, 1, 0, KC_A},    KeymapKey{1, 1, 0, KC_TRNS}, KeymapKey{2, 1, 0, KC_TRNS}, KeymapKey{3, 1, 0, KC_TRNS},
+        KeymapKey{0, 2, 0, KC_A},    KeymapKey{1, 2, 0, KC_B},    KeymapKey{2, 2, 0, KC_TRNS}, KeymapKey{3, 2, 0, KC_D},
+        KeymapKey{0, 3, 0, KC_TRNS}, KeymapKey{1, 3, 0, KC_TRNS}, KeymapKey{2, 3, 0, KC_C},    KeymapKey{3, 3, 0, KC_TRNS},
+        KeymapKey{0, 4, 0, KC_TRNS}, KeymapKey{1, 4, 0, KC_TRNS}, KeymapKey{2, 4, 0, KC_TRNS}, KeymapKey{3, 4, 0, KC_TRNS},
+    });
+
+    expect_lookup_matches_walk({{0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}});
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(LayerLookupCache, LookupFollowsKeymapChange) {
+    TestDriver driver;
+
+    set_keymap({KeymapKey{0, 0, 0, KC_A}, KeymapKey{1, 0, 0, KC_TRNS}});
+
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer({0, 0}), 0);
+
+    /* Replacing the keymap has to drop the resolved layer of the key. */
+    set_keymap({KeymapKey{0, 0, 0, KC_A}, KeymapKey{1, 0, 0, KC_B}});
+    EXPECT_EQ(layer_switch_get_layer({0, 0}), 1);
+
+    /* So does an explicit invalidation of a single key. */
+    keymap.pop_back();
+    keymap.push_back(KeymapKey{1, 0, 0, KC_TRNS});
+    layer_lookup_cache_invalidate_key({0, 0});
+    EXPECT_EQ(layer_switch_get_layer({0, 0}), 0);
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(LayerLookupCache, LookupFollowsDirectLayerStateWrite) {
+    TestDriver driver;
+
+    set_keymap({KeymapKey{0, 0, 0, KC_A}, KeymapKey{1, 0, 0, KC_B}});
+
+    EXPECT_EQ(layer_switch_get_layer({0, 0}), 0);
+
+    /* Split halves overwrite the layer state without going through layer_state_set(). */
+    layer_state = 0b10;
+    EXPECT_EQ(layer_switch_get_layer({0, 0}), 1);
+    layer_state = 0;
+    EXPECT_EQ(layer_switch_get_layer({0, 0}), 0);
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(LayerLookupCache, MomentaryLayerWithTransparentKey) {
+    TestDriver driver;
+    KeymapKey  layer_key   = KeymapKey{0, 0, 0, MO(1)};
+    KeymapKey  regular_key = KeymapKey{0, 1, 0, KC_A};
+    KeymapKey  other_key   = KeymapKey{0, 2, 0, KC_C};
+
+    set_keymap({layer_key, regular_key, other_key, KeymapKey{1, 0, 0, KC_TRNS}, KeymapKey{1, 1, 0, KC_B}, KeymapKey{1, 2, 0, KC_TRNS}});
+
+    /* Resolve both keys on the base layer first. */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(regular_key);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    layer_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    /* Layer 1 maps the key, the cached base layer result must not be used. */
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(regular_key);
+    VERIFY_AND_CLEAR(driver);
+
+    /* Layer 1 is transparent here, so the base layer key is sent. */
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(other_key);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    layer_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(regular_key);
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,124 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.h"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "keymap_introspection.h"
+#include "process_combo.h"
+
+void init_filler_combos(void);
+}
+
+static uint16_t active_combo_count = 0;
+static uint32_t combo_get_calls    = 0;
+
+/* Limit the visible combos, so the per-event cost can be compared as the count scales. */
+extern "C" uint16_t combo_count(void) {
+    return active_combo_count;
+}
+
+/* Every combo visited by process_combo goes through here. */
+extern "C" combo_t* combo_get(uint16_t combo_idx) {
+    combo_get_calls++;
+    return combo_get_raw(combo_idx);
+}
+
+class ComboKeyIndex : public TestFixture {
+   public:
+    ComboKeyIndex() {
+        init_filler_combos();
+        set_combo_count(combo_count_raw());
+    }
+
+    void set_combo_count(uint16_t count) {
+        active_combo_count = count;
+        combo_key_index_rebuild();
+    }
+};
+
+TEST_F(ComboKeyIndex, first_combo_tapped) {
+    TestDriver driver;
+    KeymapKey  key_y(0, 0, 1, KC_Y);
+    KeymapKey  key_u(0, 0, 2, KC_U);
+    set_keymap({key_y, key_u});
+
+    EXPECT_REPORT(driver, (KC_SPACE));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_y, key_u});
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboKeyIndex, last_combo_tapped) {
+    TestDriver driver;
+    uint16_t   last = combo_count_raw() - 2;
+    KeymapKey  key_1(0, 0, 1, QK_USER + (last * 2));
+    KeymapKey  key_2(0, 0, 2, QK_USER + (last * 2) + 1);
+    set_keymap({key_1, key_2});
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_1, key_2});
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboKeyIndex, non_combo_key_passes_through) {
+    TestDriver driver;
+    KeymapKey  key_y(0, 0, 1, KC_Y);
+    KeymapKey  key_i(0, 0, 2, KC_I);
+    set_keymap({key_y, key_i});
+
+    EXPECT_REPORT(driver, (KC_I));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_i);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_Y));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_y, COMBO_TERM + 1);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboKeyIndex, per_event_cost_is_independent_of_combo_count) {
+    TestDriver driver;
+    KeymapKey  key_y(0, 0, 1, KC_Y);
+    KeymapKey  key_u(0, 0, 2, KC_U);
+    KeymapKey  key_i(0, 0, 3, KC_I);
+    set_keymap({key_y, key_u, key_i});
+
+    std::vector<uint32_t> calls;
+    for (uint16_t count : {2, 16, 128}) {
+        set_combo_count(count);
+
+        /* The index is already built, so the first key event costs the same as any other. */
+        combo_get_calls = 0;
+
+        EXPECT_REPORT(driver, (KC_I));
+        EXPECT_EMPTY_REPORT(driver);
+        tap_key(key_i);
+        VERIFY_AND_CLEAR(driver);
+
+        EXPECT_REPORT(driver, (KC_SPACE));
+        EXPECT_EMPTY_REPORT(driver);
+        tap_combo({key_y, key_u});
+        VERIFY_AND_CLEAR(driver);
+
+        EXPECT_REPORT(driver, (KC_I));
+        EXPECT_EMPTY_REPORT(driver);
+        tap_key(key_i);
+        VERIFY_AND_CLEAR(driver);
+
+        RecordProperty("combo_get_calls_" + std::to_string(count), combo_get_calls);
+        calls.push_back(combo_get_calls);
+    }
+
+    EXPECT_EQ(calls.front(), calls.back());
+    for (uint32_t call_count : calls) {
+        EXPECT_LE(call_count, 16U);
+    }
+}
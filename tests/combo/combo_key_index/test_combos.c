@@ -0,0 +1,24 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "quantum.h"
+
+#define FILLER_COMBO_COUNT 127
+
+uint16_t const space_combo[] = {KC_Y, KC_U, COMBO_END};
+
+/* Two unique keys per filler combo, populated by the test so the combo count can be scaled. */
+uint16_t filler_combo_keys[FILLER_COMBO_COUNT][3];
+
+combo_t key_combos[1 + FILLER_COMBO_COUNT] = {
+    [0] = COMBO(space_combo, KC_SPACE),
+};
+
+void init_filler_combos(void) {
+    for (uint16_t i = 0; i < FILLER_COMBO_COUNT; i++) {
+        filler_combo_keys[i][0]   = QK_USER + (i * 2);
+        filler_combo_keys[i][1]   = QK_USER + (i * 2) + 1;
+        filler_combo_keys[i][2]   = COMBO_END;
+        key_combos[1 + i].keys    = filler_combo_keys[i];
+        key_combos[1 + i].keycode = KC_B;
+    }
+}
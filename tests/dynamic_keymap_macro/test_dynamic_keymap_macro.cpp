@@ -0,0 +1,139 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <utility>
+#include <vector>
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+extern "C" {
+#include "dynamic_keymap.h"
+#include "send_string_keycodes.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+namespace {
+
+std::vector<std::pair<bool, uint16_t>> vial_events;
+
+extern "C" void vial_keycode_down(uint16_t keycode) {
+    vial_events.emplace_back(true, keycode);
+}
+
+extern "C" void vial_keycode_up(uint16_t keycode) {
+    vial_events.emplace_back(false, keycode);
+}
+
+} // namespace
+
+class DynamicKeymapMacro : public TestFixture {
+   protected:
+    void SetUp() override {
+        vial_events.clear();
+    }
+
+    /* Writes the macros as one whole-buffer write, as VIA and Vial do. */
+    void load(const std::vector<uint8_t> &macros) {
+        std::vector<uint8_t> buffer(dynamic_keymap_macro_get_buffer_size(), 0);
+        std::copy(macros.begin(), macros.end(), buffer.begin());
+        dynamic_keymap_macro_set_buffer(0, buffer.size(), buffer.data());
+    }
+};
+
+TEST_F(DynamicKeymapMacro, PlainCharactersAreTyped) {
+    TestDriver driver;
+    InSequence s;
+
+    load({'a', 'B', 0});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_B));
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    dynamic_keymap_macro_send(0);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicKeymapMacro, TapDownAndUpEscapes) {
+    TestDriver driver;
+    InSequence s;
+
+    load({SS_QMK_PREFIX, SS_DOWN_CODE, KC_LCTL, SS_QMK_PREFIX, SS_TAP_CODE, KC_C, SS_QMK_PREFIX, SS_UP_CODE, KC_LCTL, 0});
+
+    EXPECT_REPORT(driver, (KC_LCTL));
+    EXPECT_REPORT(driver, (KC_LCTL, KC_C));
+    EXPECT_REPORT(driver, (KC_LCTL));
+    EXPECT_EMPTY_REPORT(driver);
+    dynamic_keymap_macro_send(0);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicKeymapMacro, DelayEscapeWaits) {
+    TestDriver driver;
+    InSequence s;
+    uint32_t   a_released = 0;
+    uint32_t   b_pressed  = 0;
+
+    // Both bytes are offset by one to avoid the terminator: (46 - 1) + (2 - 1) * 255 = 300ms
+    load({'a', SS_QMK_PREFIX, SS_DELAY_CODE, 46, 2, 'b', 0});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver).WillOnce([&](report_keyboard_t &) { a_released = timer_read32(); });
+    EXPECT_REPORT(driver, (KC_B)).WillOnce([&](report_keyboard_t &) { b_pressed = timer_read32(); });
+    EXPECT_EMPTY_REPORT(driver);
+    dynamic_keymap_macro_send(0);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(b_pressed - a_released, 300u);
+}
+
+TEST_F(DynamicKeymapMacro, TruncatedDelayEscapeEndsTheMacro) {
+    TestDriver driver;
+
+    // The terminator cuts the delay short, what follows belongs to the next macro
+    load({SS_QMK_PREFIX, SS_DELAY_CODE, 11, 0, 'z', 0});
+
+    EXPECT_NO_REPORT(driver);
+    dynamic_keymap_macro_send(0);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_Z));
+    EXPECT_EMPTY_REPORT(driver);
+    dynamic_keymap_macro_send(1);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicKeymapMacro, VialExtendedEscapes) {
+    TestDriver driver;
+
+    // Little endian keycodes, with 0xFFnn standing in for a zero low byte
+    load({SS_QMK_PREFIX, VIAL_MACRO_EXT_DOWN, 0x20, 0x52, SS_QMK_PREFIX, VIAL_MACRO_EXT_TAP, 0x07, 0xFF, SS_QMK_PREFIX, VIAL_MACRO_EXT_UP, 0x20, 0x52, 0});
+
+    EXPECT_NO_REPORT(driver);
+    dynamic_keymap_macro_send(0);
+    VERIFY_AND_CLEAR(driver);
+
+    std::vector<std::pair<bool, uint16_t>> expected = {{true, 0x5220}, {true, 0x0700}, {false, 0x0700}, {false, 0x5220}};
+    EXPECT_EQ(vial_events, expected);
+}
+
+TEST_F(DynamicKeymapMacro, MacrosAreFoundByIndex) {
+    TestDriver driver;
+    InSequence s;
+
+    load({'a', 0, 'b', 0, 'c', 0});
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    dynamic_keymap_macro_send(2);
+    dynamic_keymap_macro_send(1);
+    // Past the last macro in the buffer
+    dynamic_keymap_macro_send(DYNAMIC_KEYMAP_MACRO_COUNT);
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,226 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <vector>
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+extern "C" {
+#include "dynamic_keymap.h"
+#include "send_string_keycodes.h"
+
+void set_time(uint32_t t);
+}
+
+using testing::_;
+using testing::InSequence;
+
+static std::vector<uint16_t> vial_keys_down;
+
+extern "C" void vial_keycode_down(uint16_t keycode) {
+    vial_keys_down.push_back(keycode);
+}
+
+extern "C" void vial_keycode_up(uint16_t keycode) {
+    vial_keys_down.erase(std::remove(vial_keys_down.begin(), vial_keys_down.end(), keycode), vial_keys_down.end());
+}
+
+class DynamicKeymapMacroAsync : public TestFixture {
+   protected:
+    void SetUp() override {
+        // The player's executor only runs once the clock has passed its previous run, so keep the clock moving forward between tests
+        static uint32_t start_time = 0;
+        start_time += 0x100000;
+        set_time(start_time);
+        vial_keys_down.clear();
+    }
+
+    void TearDown() override {
+        dynamic_keymap_macro_cancel();
+    }
+
+    /* Writes the macros as one whole-buffer write, as VIA and Vial do. */
+    void load(const std::vector<uint8_t> &macros) {
+        std::vector<uint8_t> buffer(dynamic_keymap_macro_get_buffer_size(), 0);
+        std::copy(macros.begin(), macros.end(), buffer.begin());
+        dynamic_keymap_macro_set_buffer(0, buffer.size(), buffer.data());
+    }
+
+    void run_scans(int count) {
+        for (int i = 0; i < count; i++) {
+            run_one_scan_loop();
+        }
+    }
+};
+
+TEST_F(DynamicKeymapMacroAsync, PlaybackIsSpreadOverScans) {
+    TestDriver driver;
+    InSequence s;
+
+    load({'a', 'B', 0});
+
+    // Only the first step goes out straight away
+    EXPECT_REPORT(driver, (KC_A));
+    dynamic_keymap_macro_send(0);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_TRUE(dynamic_keymap_macro_is_playing());
+
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_B));
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    run_scans(6);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_TRUE(dynamic_keymap_macro_is_playing());
+
+    EXPECT_NO_REPORT(driver);
+    run_scans(2);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_FALSE(dynamic_keymap_macro_is_playing());
+}
+
+TEST_F(DynamicKeymapMacroAsync, DelayEscapeKeepsScanning) {
+    TestDriver driver;
+    InSequence s;
+
+    // (11 - 1) + (1 - 1) * 255 = 10ms
+    load({SS_QMK_PREFIX, SS_TAP_CODE, KC_A, SS_QMK_PREFIX, SS_DELAY_CODE, 11, 1, 'c', 0});
+
+    EXPECT_REPORT(driver, (KC_A));
+    dynamic_keymap_macro_send(0);
+    EXPECT_EMPTY_REPORT(driver);
+    run_scans(2);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    run_scans(9);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    run_scans(3);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicKeymapMacroAsync, MacrosTriggeredWhilePlayingAreQueued) {
+    TestDriver driver;
+    InSequence s;
+
+    load({'a', 0, 'b', 0, 'c', 0, 'd', 0});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    dynamic_keymap_macro_send(0);
+    dynamic_keymap_macro_send(2);
+    dynamic_keymap_macro_send(1);
+    // The queue holds two, so this one is dropped
+    dynamic_keymap_macro_send(3);
+    run_scans(10);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_FALSE(dynamic_keymap_macro_is_playing());
+}
+
+TEST_F(DynamicKeymapMacroAsync, CancelReleasesHeldKeysAndDropsQueue) {
+    TestDriver driver;
+    InSequence s;
+
+    load({'B', 'B', 0, 'z', 0});
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_REPORT(driver, (KC_LSFT, KC_B));
+    dynamic_keymap_macro_send(0);
+    dynamic_keymap_macro_send(1);
+    run_scans(2);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    EXPECT_EMPTY_REPORT(driver);
+    dynamic_keymap_macro_cancel();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_FALSE(dynamic_keymap_macro_is_playing());
+
+    EXPECT_NO_REPORT(driver);
+    run_scans(20);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicKeymapMacroAsync, CancelReleasesKeysHeldByEarlierItems) {
+    TestDriver driver;
+    InSequence s;
+
+    // {down LCTL} {vial down LSFT(KC_F13)} "abc" {vial up LSFT(KC_F13)} {up LCTL}
+    load({SS_QMK_PREFIX, SS_DOWN_CODE, KC_LEFT_CTRL, SS_QMK_PREFIX, VIAL_MACRO_EXT_DOWN, KC_F13, 0x02, 'a', 'b', 'c', SS_QMK_PREFIX, VIAL_MACRO_EXT_UP, KC_F13, 0x02, SS_QMK_PREFIX, SS_UP_CODE, KC_LEFT_CTRL, 0});
+
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL));
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL, KC_A));
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL));
+    dynamic_keymap_macro_send(0);
+    run_scans(4);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_TRUE(dynamic_keymap_macro_is_playing());
+    EXPECT_EQ(vial_keys_down, std::vector<uint16_t>{LSFT(KC_F13)});
+
+    // Ctrl and Shift+F13 were pressed by earlier items, but cancelling mid "abc" still lets go of them
+    EXPECT_EMPTY_REPORT(driver);
+    dynamic_keymap_macro_cancel();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_TRUE(vial_keys_down.empty());
+
+    EXPECT_NO_REPORT(driver);
+    run_scans(20);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicKeymapMacroAsync, KeysPressedDuringPlaybackRegister) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_x = KeymapKey(0, 0, 0, KC_X);
+
+    set_keymap({key_x});
+    load({'a', 'b', 0});
+
+    EXPECT_REPORT(driver, (KC_A));
+    dynamic_keymap_macro_send(0);
+    VERIFY_AND_CLEAR(driver);
+
+    // The key press goes out alongside the macro, which carries on
+    EXPECT_REPORT(driver, (KC_A, KC_X));
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_REPORT(driver, (KC_X, KC_B));
+    EXPECT_REPORT(driver, (KC_X));
+    key_x.press();
+    run_scans(4);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_x.release();
+    run_scans(10);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_FALSE(dynamic_keymap_macro_is_playing());
+}
+
+TEST_F(DynamicKeymapMacroAsync, MacroKeyPressDoesNotCancelPlayback) {
+    TestDriver driver;
+    auto       macro_key = KeymapKey(0, 0, 0, QK_MACRO_1);
+
+    set_keymap({macro_key});
+    load({'a', 'b', 'c', 0});
+
+    EXPECT_REPORT(driver, (KC_A));
+    dynamic_keymap_macro_send(0);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_ANY_REPORT(driver).Times(testing::AnyNumber());
+    macro_key.press();
+    run_one_scan_loop();
+    EXPECT_TRUE(dynamic_keymap_macro_is_playing());
+    macro_key.release();
+    run_scans(10);
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,102 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <vector>
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+extern "C" {
+#include "dynamic_keymap.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+extern "C" void vial_keycode_down(uint16_t keycode) {}
+extern "C" void vial_keycode_up(uint16_t keycode) {}
+
+class DynamicKeymapMacroRamCache : public TestFixture {
+   protected:
+    /* Writes the whole buffer in chunks, as VIA and Vial do, so only the last write reaches the end. */
+    void load(const std::vector<uint8_t> &macros, uint16_t chunk = 28) {
+        std::vector<uint8_t> buffer(dynamic_keymap_macro_get_buffer_size(), 0);
+        std::copy(macros.begin(), macros.end(), buffer.begin());
+        for (uint16_t offset = 0; offset < buffer.size(); offset += chunk) {
+            dynamic_keymap_macro_set_buffer(offset, std::min<size_t>(chunk, buffer.size() - offset), &buffer[offset]);
+        }
+    }
+
+    std::vector<uint8_t> read(uint16_t size) {
+        std::vector<uint8_t> buffer(size);
+        dynamic_keymap_macro_get_buffer(0, size, buffer.data());
+        return buffer;
+    }
+};
+
+TEST_F(DynamicKeymapMacroRamCache, RewriteMovesMacroOffsets) {
+    TestDriver driver;
+    InSequence s;
+
+    load({'a', 0, 'b', 0, 'c', 0});
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    dynamic_keymap_macro_send(1);
+    VERIFY_AND_CLEAR(driver);
+
+    // Every macro after the first one moves
+    load({'x', 'y', 0, 'z', 0});
+    EXPECT_EQ(read(5), (std::vector<uint8_t>{'x', 'y', 0, 'z', 0}));
+
+    EXPECT_REPORT(driver, (KC_Z));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_Y));
+    EXPECT_EMPTY_REPORT(driver);
+    dynamic_keymap_macro_send(1);
+    dynamic_keymap_macro_send(0);
+    // Only two macros are left
+    dynamic_keymap_macro_send(2);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicKeymapMacroRamCache, PartialWriteReindexesOnNextSend) {
+    TestDriver driver;
+    InSequence s;
+
+    load({'a', 0, 'b', 0, 'c', 0});
+
+    // Overwriting the first terminator merges the first two macros
+    uint8_t q = 'q';
+    dynamic_keymap_macro_set_buffer(1, 1, &q);
+    EXPECT_EQ(read(6), (std::vector<uint8_t>{'a', 'q', 'b', 0, 'c', 0}));
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    dynamic_keymap_macro_send(1);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicKeymapMacroRamCache, NothingIsSentWhileTheBufferIsBeingWritten) {
+    TestDriver driver;
+    InSequence s;
+    uint16_t   last = dynamic_keymap_macro_get_buffer_size() - 1;
+
+    load({'a', 0, 'b', 0});
+
+    // A write in progress leaves the last byte set until it completes
+    uint8_t pending = 0xFF;
+    dynamic_keymap_macro_set_buffer(last, 1, &pending);
+    EXPECT_NO_REPORT(driver);
+    dynamic_keymap_macro_send(0);
+    dynamic_keymap_macro_send(1);
+    VERIFY_AND_CLEAR(driver);
+
+    uint8_t done = 0;
+    dynamic_keymap_macro_set_buffer(last, 1, &done);
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    dynamic_keymap_macro_send(1);
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,31 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define DYNAMIC_KEYMAP_LAYER_COUNT 2
+#define TRANSIENT_EEPROM_SIZE 2048
+
+// A fixed address, so that the tests can change EEPROM behind the cache's back
+#define DYNAMIC_KEYMAP_EEPROM_ADDR 1024
+
+#define DYNAMIC_KEYMAP_RAM_CACHE
+
+// dynamic_keymap.c plays Vial's extended keycode escapes, the test stands in for Vial
+#define VIAL_MACRO_EXT_TAP 5
+#define VIAL_MACRO_EXT_DOWN 6
+#define VIAL_MACRO_EXT_UP 7
+
+#ifndef __ASSEMBLER__
+#    include <stdint.h>
+#    ifdef __cplusplus
+extern "C" {
+#    endif
+void vial_keycode_down(uint16_t keycode);
+void vial_keycode_up(uint16_t keycode);
+#    ifdef __cplusplus
+}
+#    endif
+#endif
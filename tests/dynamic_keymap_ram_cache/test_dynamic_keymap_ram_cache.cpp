@@ -0,0 +1,106 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "test_common.hpp"
+
+extern "C" {
+#include "dynamic_keymap.h"
+#include "eeprom.h"
+#include "nvm_dynamic_keymap.h"
+}
+
+extern "C" void vial_keycode_down(uint16_t keycode) {}
+extern "C" void vial_keycode_up(uint16_t keycode) {}
+
+namespace {
+
+constexpr uint16_t keymap_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
+
+// Changes EEPROM without going through the cache
+void write_eeprom_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
+    uint8_t *address = (uint8_t *)(uintptr_t)(DYNAMIC_KEYMAP_EEPROM_ADDR + ((layer * MATRIX_ROWS + row) * MATRIX_COLS + column) * 2);
+    eeprom_update_byte(address, keycode >> 8);
+    eeprom_update_byte(address + 1, keycode & 0xFF);
+}
+
+} // namespace
+
+class DynamicKeymapRamCache : public TestFixture {
+   protected:
+    std::vector<uint8_t> expected = std::vector<uint8_t>(keymap_size, 0);
+
+    void SetUp() override {
+        dynamic_keymap_set_buffer(0, keymap_size, expected.data());
+        // Start every test from a freshly loaded cache
+        nvm_dynamic_keymap_erase();
+        dynamic_keymap_get_keycode(0, 0, 0);
+    }
+
+    void write(uint16_t offset, std::vector<uint8_t> data) {
+        dynamic_keymap_set_buffer(offset, data.size(), data.data());
+        for (size_t i = 0; i < data.size() && offset + i < keymap_size; i++) {
+            expected[offset + i] = data[i];
+        }
+    }
+
+    void expect_keymap(const char *when) {
+        for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t column = 0; column < MATRIX_COLS; column++) {
+                    uint16_t index = ((layer * MATRIX_ROWS + row) * MATRIX_COLS + column) * 2;
+                    EXPECT_EQ(dynamic_keymap_get_keycode(layer, row, column), expected[index] << 8 | expected[index + 1]) << when << ": key " << index / 2;
+                }
+            }
+        }
+        std::vector<uint8_t> buffer(keymap_size);
+        dynamic_keymap_get_buffer(0, keymap_size, buffer.data());
+        EXPECT_EQ(buffer, expected) << when;
+    }
+
+    void expect_cache_and_eeprom() {
+        expect_keymap("cached");
+        nvm_dynamic_keymap_erase();
+        expect_keymap("reloaded");
+    }
+};
+
+TEST_F(DynamicKeymapRamCache, ReadsAreServedFromRam) {
+    TestDriver driver;
+
+    dynamic_keymap_set_keycode(1, 2, 3, KC_A);
+    write_eeprom_keycode(1, 2, 3, KC_B);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 2, 3), KC_A);
+
+    nvm_dynamic_keymap_erase();
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 2, 3), KC_B);
+}
+
+TEST_F(DynamicKeymapRamCache, UnalignedBufferWritesUpdateBothHalves) {
+    TestDriver driver;
+
+    // Low byte of one key, then a whole key
+    write(1, {0x12, 0x34, 0x56});
+    // High byte only
+    write(6, {0x04});
+    // Low byte of the last key of layer 0 and the high byte of the first key of layer 1
+    write(MATRIX_ROWS * MATRIX_COLS * 2 - 1, {0x07, 0x08});
+    // Runs off the end of the keymap
+    write(keymap_size - 1, {0x09, 0x0A, 0x0B});
+
+    expect_cache_and_eeprom();
+}
+
+TEST_F(DynamicKeymapRamCache, ChunkedUploadFromOddOffset) {
+    TestDriver driver;
+
+    std::vector<uint8_t> keymap(keymap_size - 3);
+    for (size_t i = 0; i < keymap.size(); i++) {
+        keymap[i] = i % 7;
+    }
+    for (size_t offset = 0; offset < keymap.size(); offset += 27) {
+        write(3 + offset, std::vector<uint8_t>(keymap.begin() + offset, keymap.begin() + std::min(offset + 27, keymap.size())));
+    }
+
+    expect_cache_and_eeprom();
+}
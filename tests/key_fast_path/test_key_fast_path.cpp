@@ -0,0 +1,208 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+
+using testing::_;
+using testing::InSequence;
+
+namespace {
+
+int      process_record_user_calls = 0;
+keypos_t slow_position             = {.col = 0xFF, .row = 0xFF};
+
+extern "C" bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    process_record_user_calls++;
+    return true;
+}
+
+extern "C" bool is_fast_path_key_user(keypos_t key) {
+    return !KEYEQ(key, slow_position);
+}
+
+} // namespace
+
+class KeyFastPath : public TestFixture {
+   protected:
+    void SetUp() override {
+        process_record_user_calls = 0;
+        slow_position             = {.col = 0xFF, .row = 0xFF};
+        key_fast_path_invalidate();
+    }
+};
+
+TEST_F(KeyFastPath, PlainKeySkipsProcessRecord) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(process_record_user_calls, 0);
+}
+
+TEST_F(KeyFastPath, TapHoldPositionUsesFullPipeline) {
+    TestDriver driver;
+    auto       mod_tap = KeymapKey(0, 1, 0, LSFT_T(KC_B));
+
+    set_keymap({mod_tap});
+
+    EXPECT_NO_REPORT(driver);
+    mod_tap.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    mod_tap.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(process_record_user_calls, 2);
+}
+
+TEST_F(KeyFastPath, KeyWhileTapHoldIsUndecidedIsQueued) {
+    TestDriver driver;
+    auto       key_a   = KeymapKey(0, 0, 0, KC_A);
+    auto       mod_tap = KeymapKey(0, 1, 0, LSFT_T(KC_B));
+
+    set_keymap({key_a, mod_tap});
+
+    // A is held back behind the mod-tap, as it would be without the fast path
+    EXPECT_NO_REPORT(driver);
+    mod_tap.press();
+    run_one_scan_loop();
+    key_a.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_REPORT(driver, (KC_B, KC_A));
+    EXPECT_REPORT(driver, (KC_A));
+    mod_tap.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(process_record_user_calls, 4);
+}
+
+TEST_F(KeyFastPath, OneShotModIsAppliedToPlainKey) {
+    TestDriver driver;
+    auto       osm_key = KeymapKey(0, 2, 0, OSM(MOD_LSFT), KC_LSFT);
+    auto       key_a   = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({osm_key, key_a});
+
+    EXPECT_NO_REPORT(driver);
+    tap_key(osm_key);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT, KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeyFastPath, PlainKeyCancelsSpaceCadetTap) {
+    TestDriver driver;
+    auto       space_cadet = KeymapKey(0, 4, 0, SC_LSPO);
+    auto       key_a       = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({space_cadet, key_a});
+
+    EXPECT_REPORT(driver, (KC_LSFT));
+    space_cadet.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_LSFT, KC_A));
+    EXPECT_REPORT(driver, (KC_LSFT));
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+
+    // Released as a plain shift, without typing a parenthesis
+    EXPECT_EMPTY_REPORT(driver);
+    space_cadet.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(KeyFastPath, UserCanKeepKeysOnFullPipeline) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_c = KeymapKey(0, 3, 0, KC_C);
+
+    slow_position = key_c.position;
+    set_keymap({key_a, key_c});
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_c);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(process_record_user_calls, 2);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(process_record_user_calls, 2);
+}
+
+TEST_F(KeyFastPath, FastKeyIsReportedWithoutEnteringProcessRecord) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_c = KeymapKey(0, 3, 0, KC_C);
+    int        calls_when_reported;
+
+    slow_position = key_c.position;
+    set_keymap({key_a, key_c});
+
+    // The full pipeline reaches process_record_user() before its report goes out
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C))).WillOnce([&](report_keyboard_t &) { calls_when_reported = process_record_user_calls; });
+    key_c.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(calls_when_reported, 1);
+
+    // The fast path reports straight away, and process_record_user() never sees the key
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C, KC_A))).WillOnce([&](report_keyboard_t &) { calls_when_reported = process_record_user_calls; });
+    EXPECT_REPORT(driver, (KC_C));
+    key_a.press();
+    run_one_scan_loop();
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(calls_when_reported, 1);
+    EXPECT_EQ(process_record_user_calls, 1);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_c.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(process_record_user_calls, 2);
+}
@@ -0,0 +1,14 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+// A wide matrix, so that changes far from column 0 are covered
+#undef MATRIX_ROWS
+#undef MATRIX_COLS
+#define MATRIX_ROWS 8
+#define MATRIX_COLS 24
+
+#define MATRIX_HAS_GHOST
@@ -0,0 +1,208 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+static uint32_t ghost_lookups = 0;
+
+/* Ghost detection reads the base layer through the keymap introspection API, route it to the test keymap.
+The test fixture resolves keymap_key_to_keycode() itself, so only ghost detection is counted here. */
+extern "C" uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
+    ghost_lookups++;
+    return keymap_key_to_keycode(layer_num, keypos_t{.col = column, .row = row});
+}
+
+class MatrixTask : public TestFixture {};
+
+TEST_F(MatrixTask, ChangedKeysAreDispatchedInColumnOrder) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 20, 0, KC_A);
+    auto       key_b = KeymapKey(0, 3, 0, KC_B);
+    auto       key_c = KeymapKey(0, 11, 0, KC_C);
+
+    set_keymap({key_a, key_b, key_c});
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_REPORT(driver, (KC_B, KC_C));
+    EXPECT_REPORT(driver, (KC_B, KC_C, KC_A));
+    key_a.press();
+    key_b.press();
+    key_c.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C, KC_A));
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    key_b.release();
+    key_c.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(MatrixTask, GhostingRowIsIgnored) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(0, 0, 1, KC_C);
+    auto       key_d = KeymapKey(0, 1, 1, KC_D);
+
+    set_keymap({key_a, key_b, key_c, key_d});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C));
+    key_a.press();
+    key_b.press();
+    key_c.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // The fourth corner of the rectangle is indistinguishable from a ghost
+    EXPECT_NO_REPORT(driver);
+    key_d.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // Releasing a key on the other row clears the ghost, and the held key is picked up
+    EXPECT_REPORT(driver, (KC_B, KC_C));
+    EXPECT_REPORT(driver, (KC_B, KC_C, KC_D));
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C, KC_D));
+    EXPECT_REPORT(driver, (KC_D));
+    EXPECT_EMPTY_REPORT(driver);
+    key_b.release();
+    key_c.release();
+    key_d.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(MatrixTask, BlankPositionsDoNotGhost) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(0, 0, 1, KC_C);
+    auto       blank = KeymapKey(0, 1, 1, KC_NO);
+
+    set_keymap({key_a, key_b, key_c, blank});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C));
+    key_a.press();
+    key_b.press();
+    key_c.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // (1, 1) has no keycode, so row 1 still has only one real key and the release of C gets through
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    blank.press();
+    key_c.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    blank.release();
+    key_a.release();
+    key_b.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(MatrixTask, KeymapChangeRefreshesGhostDetection) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(0, 0, 1, KC_C);
+    auto       blank = KeymapKey(0, 1, 1, KC_NO);
+
+    set_keymap({key_a, key_b, key_c, blank});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_C));
+    key_a.press();
+    key_c.press();
+    blank.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    // (1, 1) is now a real key, so pressing (1, 0) makes row 0 a ghost even though row 1 didn't change
+    auto key_d = KeymapKey(0, 1, 1, KC_D);
+    set_keymap({key_a, key_b, key_c, key_d});
+    matrix_ghost_invalidate();
+
+    EXPECT_NO_REPORT(driver);
+    key_b.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    key_b.release();
+    key_c.release();
+    key_d.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(MatrixTask, GhostDetectionOnlyLooksUpPressedKeysOnChangedRows) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 5, 2, KC_B);
+    auto       key_c = KeymapKey(0, 20, 5, KC_C);
+    auto       key_d = KeymapKey(0, 1, 0, KC_D);
+
+    set_keymap({key_a, key_b, key_c, key_d});
+    run_one_scan_loop();
+
+    // Without the cache, every changed row looked up all MATRIX_COLS columns of itself and of every other row
+    const uint32_t uncached_lookups_per_changed_row = MATRIX_ROWS * MATRIX_COLS;
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_B));
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C));
+    ghost_lookups = 0;
+    key_a.press();
+    key_b.press();
+    key_c.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(ghost_lookups, 3) << "Only the three pressed keys, instead of " << 3 * uncached_lookups_per_changed_row;
+
+    EXPECT_NO_REPORT(driver);
+    ghost_lookups = 0;
+    idle_for(10);
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(ghost_lookups, 0) << "Idle scans never consult the keymap";
+
+    EXPECT_REPORT(driver, (KC_A, KC_B, KC_C, KC_D));
+    ghost_lookups = 0;
+    key_d.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+    EXPECT_EQ(ghost_lookups, 2) << "Only the pressed keys of row 0, instead of " << uncached_lookups_per_changed_row;
+
+    EXPECT_REPORT(driver, (KC_B, KC_C, KC_D));
+    EXPECT_REPORT(driver, (KC_B, KC_C));
+    EXPECT_REPORT(driver, (KC_C));
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    key_b.release();
+    key_c.release();
+    key_d.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
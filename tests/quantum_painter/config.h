@@ -0,0 +1,13 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define QUANTUM_PAINTER_FONT_GLYPH_CACHE_SIZE 4
+#define QUANTUM_PAINTER_SUPPORTS_TEXT_CACHE 1
+#define QUANTUM_PAINTER_SUPPORTS_ASYNC_PIXDATA 1
+#define QUANTUM_PAINTER_SUPPORTS_NATIVE_COLORS 1
+#define QUANTUM_PAINTER_PALETTE_CACHE 1
+#define SURFACE_NUM_DEVICES 3
@@ -0,0 +1,336 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <set>
+#include <vector>
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "qp.h"
+#include "qp_internal.h"
+#include "qp_comms.h"
+#include "qp_surface.h"
+#include "qp_comms_dummy.h"
+}
+
+namespace {
+
+constexpr uint16_t SURFACE_SIZE = 64;
+
+// The dummy comms, but with asynchronous sends which stay in flight until waited for
+struct async_comms_t {
+    painter_comms_vtable_t    vtable;
+    bool                      in_flight;
+    const uint8_t *           data;
+    std::vector<uint8_t>      contents;
+    std::vector<uint8_t>      received;
+    std::set<const uint8_t *> buffers;
+    uint32_t                  transfers;
+} comms;
+
+uint32_t async_send(painter_device_t device, const void *data, uint32_t byte_count) {
+    EXPECT_FALSE(comms.in_flight) << "The previous transfer should have been waited for";
+    comms.in_flight = true;
+    comms.data      = (const uint8_t *)data;
+    comms.contents.assign(comms.data, comms.data + byte_count);
+    comms.buffers.insert(comms.data);
+    comms.transfers++;
+    return byte_count;
+}
+
+void async_wait(painter_device_t device) {
+    if (!comms.in_flight) {
+        return;
+    }
+    EXPECT_EQ(memcmp(comms.data, comms.contents.data(), comms.contents.size()), 0) << "Pixel data was modified while it was being sent";
+    comms.received.insert(comms.received.end(), comms.contents.begin(), comms.contents.end());
+    comms.in_flight = false;
+}
+
+// A target device which sends its viewport synchronously and its pixel data asynchronously, like the TFT panels
+painter_driver_t target;
+
+bool target_ok(painter_device_t device) {
+    return true;
+}
+
+bool target_init(painter_device_t device, painter_rotation_t rotation) {
+    return true;
+}
+
+bool target_power(painter_device_t device, bool power_on) {
+    return true;
+}
+
+bool target_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom) {
+    uint16_t window[4] = {left, top, right, bottom};
+    qp_comms_send(device, window, sizeof(window));
+    return true;
+}
+
+bool target_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count) {
+    qp_comms_send_async(device, pixel_data, native_pixel_count * sizeof(uint16_t));
+    return true;
+}
+
+// Each palette entry is converted to its hue and value, so that the sent pixels show which entry was used
+uint16_t convert(uint8_t h, uint8_t v) {
+    return (h << 8) | v;
+}
+
+bool target_palette_convert(painter_device_t device, int16_t palette_size, qp_pixel_t *palette) {
+    for (int16_t i = 0; i < palette_size; i++) {
+        palette[i].rgb565 = convert(palette[i].hsv888.h, palette[i].hsv888.v);
+    }
+    return true;
+}
+
+bool target_append_pixels(painter_device_t device, uint8_t *target_buffer, qp_pixel_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices) {
+    uint16_t *buf = (uint16_t *)target_buffer;
+    for (uint32_t i = 0; i < pixel_count; i++) {
+        buf[pixel_offset + i] = palette[palette_indices[i]].rgb565;
+    }
+    return true;
+}
+
+bool target_append_pixdata(painter_device_t device, uint8_t *target_buffer, uint32_t pixdata_offset, uint8_t pixdata_byte) {
+    return true;
+}
+
+const painter_driver_vtable_t target_vtable = {
+    .init            = target_init,
+    .power           = target_power,
+    .clear           = target_ok,
+    .flush           = target_ok,
+    .viewport        = target_viewport,
+    .pixdata         = target_pixdata,
+    .palette_convert = target_palette_convert,
+    .append_pixels   = target_append_pixels,
+    .append_pixdata  = target_append_pixdata,
+};
+
+void put(std::vector<uint8_t> &out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out.push_back((value >> (8 * i)) & 0xFF);
+    }
+}
+
+void put_block_header(std::vector<uint8_t> &out, uint8_t type_id, uint32_t length) {
+    put(out, type_id, 1);
+    put(out, (uint8_t)~type_id, 1);
+    put(out, length, 3);
+}
+
+// Pixels of the test image run in horizontal stripes of 8, so each row compresses to a few repeated runs
+uint8_t image_index(uint16_t x, uint16_t y) {
+    return (x / 8 + y) % 16;
+}
+
+// Builds a single frame, RLE compressed, 4bpp palette QGF covering the whole target
+std::vector<uint8_t> make_rle_image(void) {
+    std::vector<uint8_t> packed;
+    for (uint16_t y = 0; y < SURFACE_SIZE; y++) {
+        for (uint16_t x = 0; x < SURFACE_SIZE; x += 2) {
+            packed.push_back(image_index(x, y) | (image_index(x + 1, y) << 4));
+        }
+    }
+
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < packed.size();) {
+        size_t run = 1;
+        while (i + run < packed.size() && packed[i + run] == packed[i] && run < 127) {
+            run++;
+        }
+        data.push_back(run);
+        data.push_back(packed[i]);
+        i += run;
+    }
+
+    std::vector<uint8_t> body;
+    put_block_header(body, 0x02, 6);
+    put(body, 0x06, 1); // PALETTE_4BPP
+    put(body, 0x00, 1); // not a delta frame
+    put(body, IMAGE_COMPRESSED_RLE, 1);
+    put(body, 0xFF, 1); // transparency index
+    put(body, 0, 2);    // delay
+    put_block_header(body, 0x03, 16 * 3);
+    for (uint8_t i = 0; i < 16; i++) {
+        put(body, i * 16, 1);
+        put(body, 255, 1);
+        put(body, 255 - i, 1);
+    }
+    put_block_header(body, 0x05, data.size());
+    body.insert(body.end(), data.begin(), data.end());
+
+    std::vector<uint8_t> image;
+    uint32_t             header_size = 23 + 5 + 4;
+    uint32_t             total_size  = header_size + body.size();
+    put_block_header(image, 0x00, 18);
+    put(image, 0x464751, 3); // magic
+    put(image, 0x01, 1);     // version
+    put(image, total_size, 4);
+    put(image, ~total_size, 4);
+    put(image, SURFACE_SIZE, 2);
+    put(image, SURFACE_SIZE, 2);
+    put(image, 1, 2); // frame count
+    put_block_header(image, 0x01, 4);
+    put(image, header_size, 4);
+    image.insert(image.end(), body.begin(), body.end());
+    return image;
+}
+
+constexpr uint8_t  GLYPH_WIDTH  = 63;
+constexpr uint8_t  GLYPH_HEIGHT = 32;
+constexpr uint32_t GLYPH        = 0x4E00;
+
+bool glyph_lit(uint16_t x, uint16_t y) {
+    return (x + y) % 3 == 0;
+}
+
+// Builds a 1bpp QFF holding a single large unicode glyph, which takes several buffers to send
+std::vector<uint8_t> make_font(void) {
+    std::vector<uint8_t> data((GLYPH_WIDTH * GLYPH_HEIGHT + 7) / 8, 0);
+    for (uint32_t bit = 0; bit < GLYPH_WIDTH * GLYPH_HEIGHT; bit++) {
+        if (glyph_lit(bit % GLYPH_WIDTH, bit / GLYPH_WIDTH)) {
+            data[bit / 8] |= 1 << (bit % 8);
+        }
+    }
+
+    std::vector<uint8_t> font;
+    uint32_t             total_size = 25 + 5 + 6 + 5 + data.size();
+    put_block_header(font, 0x00, 20);
+    put(font, 0x464651, 3); // magic
+    put(font, 0x01, 1);     // version
+    put(font, total_size, 4);
+    put(font, ~total_size, 4);
+    put(font, GLYPH_HEIGHT, 1);
+    put(font, 0, 1);    // no ascii table
+    put(font, 1, 2);    // unicode glyph count
+    put(font, 0x00, 1); // GRAYSCALE_1BPP
+    put(font, 0, 1);    // flags
+    put(font, 0, 1);    // uncompressed
+    put(font, 0xFF, 1); // transparency index
+    put_block_header(font, 0x02, 6);
+    put(font, GLYPH, 3);
+    put(font, GLYPH_WIDTH, 3); // width, data at offset 0
+    put_block_header(font, 0x04, data.size());
+    font.insert(font.end(), data.begin(), data.end());
+    return font;
+}
+
+} // namespace
+
+class QuantumPainterAsyncPixdata : public TestFixture {
+   protected:
+    // Surfaces can't be released, so all tests share the one
+    static uint16_t         buffer[SURFACE_SIZE * SURFACE_SIZE];
+    static painter_device_t surface;
+
+    static void SetUpTestCase() {
+        TestFixture::SetUpTestCase();
+        surface = qp_make_rgb565_surface(SURFACE_SIZE, SURFACE_SIZE, buffer);
+        ASSERT_TRUE(qp_init(surface, QP_ROTATION_0));
+
+        comms.vtable                  = dummy_comms_vtable;
+        comms.vtable.comms_send_async = async_send;
+        comms.vtable.comms_wait       = async_wait;
+
+        target.driver_vtable         = &target_vtable;
+        target.comms_vtable          = &comms.vtable;
+        target.panel_width           = SURFACE_SIZE;
+        target.panel_height          = SURFACE_SIZE;
+        target.native_bits_per_pixel = 16;
+        target.validate_ok           = true;
+    }
+
+    void SetUp() override {
+        // Marks the whole surface as dirty
+        ASSERT_TRUE(qp_clear(surface));
+        for (uint32_t i = 0; i < SURFACE_SIZE * SURFACE_SIZE; i++) {
+            buffer[i] = i;
+        }
+        comms.received.clear();
+        comms.buffers.clear();
+        comms.transfers = 0;
+    }
+};
+
+uint16_t         QuantumPainterAsyncPixdata::buffer[SURFACE_SIZE * SURFACE_SIZE];
+painter_device_t QuantumPainterAsyncPixdata::surface;
+
+TEST_F(QuantumPainterAsyncPixdata, PixdataIsSentFromAlternatingBuffers) {
+    TestDriver driver;
+
+    ASSERT_TRUE(qp_surface_draw(surface, &target, 0, 0, true));
+
+    EXPECT_EQ(comms.transfers, sizeof(buffer) / QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE);
+    EXPECT_EQ(comms.buffers.size(), 2) << "Each buffer should be filled while the other is being sent";
+    ASSERT_EQ(comms.received.size(), sizeof(buffer));
+    EXPECT_EQ(memcmp(comms.received.data(), buffer, sizeof(buffer)), 0);
+}
+
+TEST_F(QuantumPainterAsyncPixdata, DrawingWaitsForTheLastTransfer) {
+    TestDriver driver;
+
+    ASSERT_TRUE(qp_surface_draw(surface, &target, 0, 0, true));
+    EXPECT_FALSE(comms.in_flight) << "Everything should have been sent once the draw has returned";
+
+    qp_setpixel(surface, 1, 1, 0, 0, 255);
+    qp_setpixel(surface, 60, 60, 0, 0, 255);
+    comms.received.clear();
+    ASSERT_TRUE(qp_surface_draw(surface, &target, 0, 0, false));
+    EXPECT_FALSE(comms.in_flight);
+    ASSERT_EQ(comms.received.size(), 2 * sizeof(uint16_t));
+    EXPECT_EQ(memcmp(&comms.received[0], &buffer[1 * SURFACE_SIZE + 1], sizeof(uint16_t)), 0);
+    EXPECT_EQ(memcmp(&comms.received[2], &buffer[60 * SURFACE_SIZE + 60], sizeof(uint16_t)), 0);
+}
+
+TEST_F(QuantumPainterAsyncPixdata, CompressedImageIsSentFromAlternatingBuffers) {
+    TestDriver driver;
+
+    std::vector<uint8_t>   qgf   = make_rle_image();
+    painter_image_handle_t image = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+
+    ASSERT_TRUE(qp_drawimage(&target, 0, 0, image));
+    EXPECT_FALSE(comms.in_flight) << "Everything should have been sent once the draw has returned";
+
+    const uint32_t image_bytes = SURFACE_SIZE * SURFACE_SIZE * sizeof(uint16_t);
+    EXPECT_EQ(comms.transfers, image_bytes / QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE);
+    EXPECT_EQ(comms.buffers.size(), 2) << "Each buffer should be decoded into while the other is being sent";
+
+    ASSERT_EQ(comms.received.size(), image_bytes);
+    const uint16_t *received = (const uint16_t *)comms.received.data();
+    for (uint16_t y = 0; y < SURFACE_SIZE; y++) {
+        for (uint16_t x = 0; x < SURFACE_SIZE; x++) {
+            uint8_t index = image_index(x, y);
+            ASSERT_EQ(received[y * SURFACE_SIZE + x], convert(index * 16, 255 - index)) << "pixel " << x << "," << y;
+        }
+    }
+
+    qp_close_image(image);
+}
+
+TEST_F(QuantumPainterAsyncPixdata, TextIsSentFromAlternatingBuffers) {
+    TestDriver driver;
+
+    std::vector<uint8_t>  qff  = make_font();
+    painter_font_handle_t font = qp_load_font_mem(qff.data());
+    ASSERT_NE(font, nullptr);
+
+    // U+4E00 twice
+    EXPECT_EQ(qp_drawtext_recolor(&target, 0, 0, font, "\xE4\xB8\x80\xE4\xB8\x80", 0, 0, 255, 0, 0, 0), 2 * GLYPH_WIDTH);
+    EXPECT_FALSE(comms.in_flight) << "Everything should have been sent once the draw has returned";
+    EXPECT_EQ(comms.buffers.size(), 2) << "Each buffer should be rendered into while the other is being sent";
+
+    const uint32_t glyph_pixels = GLYPH_WIDTH * GLYPH_HEIGHT;
+    ASSERT_EQ(comms.received.size(), 2 * glyph_pixels * sizeof(uint16_t));
+    const uint16_t *received = (const uint16_t *)comms.received.data();
+    for (uint32_t i = 0; i < 2 * glyph_pixels; i++) {
+        uint32_t pixel = i % glyph_pixels;
+        ASSERT_EQ(received[i], glyph_lit(pixel % GLYPH_WIDTH, pixel / GLYPH_WIDTH) ? convert(0, 255) : convert(0, 0)) << "pixel " << i;
+    }
+
+    qp_close_font(font);
+}
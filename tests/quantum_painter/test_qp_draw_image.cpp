@@ -0,0 +1,444 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "qp.h"
+#include "qp_internal.h"
+#include "qp_draw.h"
+#include "qp_comms_dummy.h"
+
+void advance_time(uint32_t ms);
+void qp_internal_animation_tick(void);
+}
+
+namespace {
+
+constexpr uint16_t IMAGE_SIZE  = 32;
+constexpr uint16_t FRAME_DELAY = 10;
+
+constexpr uint8_t FORMAT_PALETTE_4BPP = 0x06;
+constexpr uint8_t FORMAT_RGB565       = 0x08;
+
+struct rect_t {
+    uint16_t l, t, r, b;
+};
+
+struct frame_t {
+    uint8_t               format;
+    painter_compression_t compression;
+    uint8_t               palette; // PALETTE_4BPP only
+    bool                  is_delta;
+    rect_t                rect;
+    std::vector<uint16_t> pixels; // palette indices or RGB565, covering rect
+};
+
+// Each palette entry is converted to its hue and value, so that the drawn pixels show which palette was used
+uint16_t convert(uint8_t h, uint8_t v) {
+    return (h << 8) | v;
+}
+
+uint8_t palette_hue(uint8_t palette, uint8_t index) {
+    return index * 16 + palette;
+}
+
+uint8_t palette_value(uint8_t palette, uint8_t index) {
+    return 255 - index - palette * 16;
+}
+
+uint16_t palette_color(uint8_t palette, uint8_t index) {
+    return convert(palette_hue(palette, index), palette_value(palette, index));
+}
+
+// A target device which records what it's sent, and how
+struct recorder_t {
+    painter_driver_t base;
+    uint32_t         palette_converts;
+    uint32_t         append_pixels_calls;
+    uint32_t         pixels_sent;
+    uint16_t         framebuffer[IMAGE_SIZE * IMAGE_SIZE];
+    rect_t           viewport;
+    uint16_t         x, y;
+} recorders[2];
+
+bool recorder_ok(painter_device_t device) {
+    return true;
+}
+
+bool recorder_init(painter_device_t device, painter_rotation_t rotation) {
+    return true;
+}
+
+bool recorder_power(painter_device_t device, bool power_on) {
+    return true;
+}
+
+bool recorder_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom) {
+    recorder_t *recorder = (recorder_t *)device;
+    recorder->viewport   = {left, top, right, bottom};
+    recorder->x          = left;
+    recorder->y          = top;
+    return true;
+}
+
+bool recorder_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count) {
+    recorder_t     *recorder = (recorder_t *)device;
+    const uint16_t *pixels   = (const uint16_t *)pixel_data;
+    for (uint32_t i = 0; i < native_pixel_count; i++) {
+        recorder->framebuffer[recorder->y * IMAGE_SIZE + recorder->x] = pixels[i];
+        if (++recorder->x > recorder->viewport.r) {
+            recorder->x = recorder->viewport.l;
+            recorder->y++;
+        }
+    }
+    recorder->pixels_sent += native_pixel_count;
+    return true;
+}
+
+bool recorder_palette_convert(painter_device_t device, int16_t palette_size, qp_pixel_t *palette) {
+    recorder_t *recorder = (recorder_t *)device;
+    for (int16_t i = 0; i < palette_size; i++) {
+        palette[i].rgb565 = convert(palette[i].hsv888.h, palette[i].hsv888.v);
+    }
+    recorder->palette_converts++;
+    return true;
+}
+
+bool recorder_append_pixels(painter_device_t device, uint8_t *target_buffer, qp_pixel_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices) {
+    recorder_t *recorder = (recorder_t *)device;
+    uint16_t   *buf      = (uint16_t *)target_buffer;
+    for (uint32_t i = 0; i < pixel_count; i++) {
+        buf[pixel_offset + i] = palette[palette_indices[i]].rgb565;
+    }
+    recorder->append_pixels_calls++;
+    return true;
+}
+
+bool recorder_append_pixdata(painter_device_t device, uint8_t *target_buffer, uint32_t pixdata_offset, uint8_t pixdata_byte) {
+    target_buffer[pixdata_offset] = pixdata_byte;
+    return true;
+}
+
+const painter_driver_vtable_t recorder_vtable = {
+    .init            = recorder_init,
+    .power           = recorder_power,
+    .clear           = recorder_ok,
+    .flush           = recorder_ok,
+    .viewport        = recorder_viewport,
+    .pixdata         = recorder_pixdata,
+    .palette_convert = recorder_palette_convert,
+    .append_pixels   = recorder_append_pixels,
+    .append_pixdata  = recorder_append_pixdata,
+};
+
+void put(std::vector<uint8_t> &out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out.push_back((value >> (8 * i)) & 0xFF);
+    }
+}
+
+void put_block_header(std::vector<uint8_t> &out, uint8_t type_id, uint32_t length) {
+    put(out, type_id, 1);
+    put(out, (uint8_t)~type_id, 1);
+    put(out, length, 3);
+}
+
+// Compresses the same way as qmk painter-convert-graphics
+std::vector<uint8_t> rle_encode(const std::vector<uint8_t> &in) {
+    std::vector<uint8_t> out;
+    size_t               i = 0;
+    while (i < in.size()) {
+        size_t run = 1;
+        while (i + run < in.size() && in[i + run] == in[i] && run < 127) {
+            run++;
+        }
+        if (run >= 2) {
+            out.push_back(run);
+            out.push_back(in[i]);
+            i += run;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < in.size() && i - start < 128 && !(i + 1 < in.size() && in[i + 1] == in[i])) {
+            i++;
+        }
+        out.push_back(127 + (i - start));
+        out.insert(out.end(), in.begin() + start, in.begin() + i);
+    }
+    return out;
+}
+
+std::vector<uint8_t> pack(const frame_t &frame) {
+    std::vector<uint8_t> data;
+    if (frame.format == FORMAT_RGB565) {
+        for (uint16_t pixel : frame.pixels) {
+            put(data, pixel, 2);
+        }
+    } else {
+        for (size_t i = 0; i < frame.pixels.size(); i++) {
+            if (i % 2 == 0) {
+                data.push_back(0);
+            }
+            data.back() |= frame.pixels[i] << ((i % 2) * 4);
+        }
+    }
+    return frame.compression == IMAGE_COMPRESSED_RLE ? rle_encode(data) : data;
+}
+
+std::vector<uint8_t> make_image(const std::vector<frame_t> &frames) {
+    std::vector<uint8_t>  body;
+    std::vector<uint32_t> offsets;
+    uint32_t              header_size = 23 + 5 + frames.size() * 4;
+    for (const frame_t &frame : frames) {
+        offsets.push_back(header_size + body.size());
+
+        put_block_header(body, 0x02, 6);
+        put(body, frame.format, 1);
+        put(body, frame.is_delta ? 0x02 : 0x00, 1);
+        put(body, frame.compression, 1);
+        put(body, 0xFF, 1); // transparency index
+        put(body, FRAME_DELAY, 2);
+
+        if (frame.format == FORMAT_PALETTE_4BPP) {
+            put_block_header(body, 0x03, 16 * 3);
+            for (uint8_t i = 0; i < 16; i++) {
+                put(body, palette_hue(frame.palette, i), 1);
+                put(body, 255, 1);
+                put(body, palette_value(frame.palette, i), 1);
+            }
+        }
+
+        if (frame.is_delta) {
+            put_block_header(body, 0x04, 8);
+            put(body, frame.rect.l, 2);
+            put(body, frame.rect.t, 2);
+            put(body, frame.rect.r, 2);
+            put(body, frame.rect.b, 2);
+        }
+
+        std::vector<uint8_t> data = pack(frame);
+        put_block_header(body, 0x05, data.size());
+        body.insert(body.end(), data.begin(), data.end());
+    }
+
+    std::vector<uint8_t> image;
+    uint32_t             total_size = header_size + body.size();
+    put_block_header(image, 0x00, 18);
+    put(image, 0x464751, 3); // magic
+    put(image, 0x01, 1);     // version
+    put(image, total_size, 4);
+    put(image, ~total_size, 4);
+    put(image, IMAGE_SIZE, 2);
+    put(image, IMAGE_SIZE, 2);
+    put(image, frames.size(), 2);
+
+    put_block_header(image, 0x01, frames.size() * 4);
+    for (uint32_t offset : offsets) {
+        put(image, offset, 4);
+    }
+
+    image.insert(image.end(), body.begin(), body.end());
+    return image;
+}
+
+// Palette frames are drawn in horizontal runs of 8 pixels, which compress well
+frame_t palette_frame(uint8_t palette, uint8_t seed, painter_compression_t compression) {
+    frame_t frame = {FORMAT_PALETTE_4BPP, compression, palette, false, {0, 0, IMAGE_SIZE - 1, IMAGE_SIZE - 1}, {}};
+    for (uint16_t y = 0; y < IMAGE_SIZE; y++) {
+        for (uint16_t x = 0; x < IMAGE_SIZE; x++) {
+            frame.pixels.push_back((x / 8 + y / 4 + seed) % 16);
+        }
+    }
+    return frame;
+}
+
+frame_t delta_frame(uint8_t palette, rect_t rect) {
+    frame_t frame = {FORMAT_PALETTE_4BPP, IMAGE_COMPRESSED_RLE, palette, true, rect, {}};
+    for (uint16_t y = rect.t; y <= rect.b; y++) {
+        for (uint16_t x = rect.l; x <= rect.r; x++) {
+            frame.pixels.push_back((x + y) % 16);
+        }
+    }
+    return frame;
+}
+
+frame_t native_frame(void) {
+    frame_t frame = {FORMAT_RGB565, IMAGE_COMPRESSED_RLE, 0, false, {0, 0, IMAGE_SIZE - 1, IMAGE_SIZE - 1}, {}};
+    for (uint16_t y = 0; y < IMAGE_SIZE; y++) {
+        for (uint16_t x = 0; x < IMAGE_SIZE; x++) {
+            frame.pixels.push_back(y < IMAGE_SIZE / 2 ? 0x5A5A : (x << 11) | y);
+        }
+    }
+    return frame;
+}
+
+// Applies a frame to the expected contents of the display
+void apply(std::vector<uint16_t> &expected, const frame_t &frame) {
+    size_t i = 0;
+    for (uint16_t y = frame.rect.t; y <= frame.rect.b; y++) {
+        for (uint16_t x = frame.rect.l; x <= frame.rect.r; x++, i++) {
+            expected[y * IMAGE_SIZE + x] = frame.format == FORMAT_RGB565 ? frame.pixels[i] : palette_color(frame.palette, frame.pixels[i]);
+        }
+    }
+}
+
+} // namespace
+
+class QuantumPainterDrawImage : public TestFixture {
+   protected:
+    static void SetUpTestCase() {
+        TestFixture::SetUpTestCase();
+        for (recorder_t &recorder : recorders) {
+            recorder.base.driver_vtable         = &recorder_vtable;
+            recorder.base.comms_vtable          = &dummy_comms_vtable;
+            recorder.base.panel_width           = IMAGE_SIZE;
+            recorder.base.panel_height          = IMAGE_SIZE;
+            recorder.base.native_bits_per_pixel = 16;
+            recorder.base.validate_ok           = true;
+        }
+    }
+
+    void SetUp() override {
+        // The timer starts again from zero for each test, but the animation task remembers when it last ran
+        advance_time(animation_time);
+
+        // Don't reuse a palette converted by an earlier test
+        qp_internal_invalidate_palette();
+
+        for (recorder_t &recorder : recorders) {
+            memset(recorder.framebuffer, 0, sizeof(recorder.framebuffer));
+            reset_counts(recorder);
+        }
+    }
+
+    void reset_counts(recorder_t &recorder) {
+        recorder.palette_converts    = 0;
+        recorder.append_pixels_calls = 0;
+        recorder.pixels_sent         = 0;
+    }
+
+    void expect_displayed(const recorder_t &recorder, const std::vector<uint16_t> &expected) {
+        for (uint16_t i = 0; i < IMAGE_SIZE * IMAGE_SIZE; i++) {
+            ASSERT_EQ(recorder.framebuffer[i], expected[i]) << "pixel " << i % IMAGE_SIZE << "," << i / IMAGE_SIZE;
+        }
+    }
+
+    void next_frame(void) {
+        advance_time(FRAME_DELAY);
+        animation_time += FRAME_DELAY;
+        qp_internal_animation_tick();
+    }
+
+    static uint32_t animation_time;
+};
+
+uint32_t QuantumPainterDrawImage::animation_time = 0;
+
+TEST_F(QuantumPainterDrawImage, FramesAreDrawnARunAtATime) {
+    TestDriver driver;
+
+    std::vector<frame_t> frames = {
+        palette_frame(0, 0, IMAGE_COMPRESSED_RLE),
+        palette_frame(0, 5, IMAGE_UNCOMPRESSED),
+        delta_frame(0, {3, 5, 20, 9}),
+        native_frame(),
+    };
+    std::vector<uint8_t>   qgf   = make_image(frames);
+    painter_image_handle_t image = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+
+    recorder_t           &recorder = recorders[0];
+    std::vector<uint16_t> expected(IMAGE_SIZE * IMAGE_SIZE, 0);
+    deferred_token        token = qp_animate(&recorder, 0, 0, image);
+    ASSERT_NE(token, INVALID_DEFERRED_TOKEN);
+
+    for (size_t i = 0; i < frames.size(); i++) {
+        if (i > 0) {
+            reset_counts(recorder);
+            next_frame();
+        }
+
+        uint32_t pixel_count = (frames[i].rect.r - frames[i].rect.l + 1) * (frames[i].rect.b - frames[i].rect.t + 1);
+        EXPECT_EQ(recorder.pixels_sent, pixel_count) << "frame " << i;
+        if (frames[i].format != FORMAT_RGB565) {
+            EXPECT_LE(recorder.append_pixels_calls, pixel_count / 8) << "frame " << i << " should have been converted in batches";
+        }
+
+        apply(expected, frames[i]);
+        expect_displayed(recorder, expected);
+    }
+
+    qp_stop_animation(token);
+    qp_close_image(image);
+}
+
+TEST_F(QuantumPainterDrawImage, UnchangedPaletteIsConvertedOnce) {
+    TestDriver driver;
+
+    std::vector<frame_t> frames = {
+        palette_frame(0, 0, IMAGE_COMPRESSED_RLE),
+        palette_frame(0, 1, IMAGE_COMPRESSED_RLE),
+        palette_frame(1, 2, IMAGE_COMPRESSED_RLE),
+        delta_frame(1, {0, 0, 7, 7}),
+    };
+    std::vector<uint8_t>   qgf   = make_image(frames);
+    painter_image_handle_t image = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+
+    recorder_t           &recorder = recorders[0];
+    std::vector<uint16_t> expected(IMAGE_SIZE * IMAGE_SIZE, 0);
+    deferred_token        token = qp_animate(&recorder, 0, 0, image);
+    ASSERT_NE(token, INVALID_DEFERRED_TOKEN);
+
+    // The first frame's palette is converted, the second frame shares it
+    apply(expected, frames[0]);
+    expect_displayed(recorder, expected);
+    next_frame();
+    apply(expected, frames[1]);
+    expect_displayed(recorder, expected);
+    EXPECT_EQ(recorder.palette_converts, 1);
+
+    // The third frame changes palette, the delta frame after it shares it
+    next_frame();
+    apply(expected, frames[2]);
+    expect_displayed(recorder, expected);
+    next_frame();
+    apply(expected, frames[3]);
+    expect_displayed(recorder, expected);
+    EXPECT_EQ(recorder.palette_converts, 2);
+
+    // Looping back around changes palette again
+    next_frame();
+    apply(expected, frames[0]);
+    expect_displayed(recorder, expected);
+    EXPECT_EQ(recorder.palette_converts, 3);
+
+    qp_stop_animation(token);
+    qp_close_image(image);
+}
+
+TEST_F(QuantumPainterDrawImage, PaletteIsConvertedForEachDevice) {
+    TestDriver driver;
+
+    std::vector<frame_t>   frames = {palette_frame(0, 0, IMAGE_COMPRESSED_RLE)};
+    std::vector<uint8_t>   qgf    = make_image(frames);
+    painter_image_handle_t image  = qp_load_image_mem(qgf.data());
+    ASSERT_NE(image, nullptr);
+
+    std::vector<uint16_t> expected(IMAGE_SIZE * IMAGE_SIZE, 0);
+    apply(expected, frames[0]);
+
+    ASSERT_TRUE(qp_drawimage(&recorders[0], 0, 0, image));
+    ASSERT_TRUE(qp_drawimage(&recorders[1], 0, 0, image));
+    ASSERT_TRUE(qp_drawimage(&recorders[0], 0, 0, image));
+    EXPECT_EQ(recorders[0].palette_converts, 2);
+    EXPECT_EQ(recorders[1].palette_converts, 1);
+    expect_displayed(recorders[0], expected);
+    expect_displayed(recorders[1], expected);
+
+    qp_close_image(image);
+}
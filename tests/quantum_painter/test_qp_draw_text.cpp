@@ -0,0 +1,379 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "qp.h"
+#include "qp_stream.h"
+#include "qp_surface.h"
+}
+
+namespace {
+
+constexpr uint16_t SURFACE_WIDTH  = 128;
+constexpr uint16_t SURFACE_HEIGHT = 8;
+constexpr uint8_t  LINE_HEIGHT    = 8;
+constexpr uint32_t FIRST_GLYPH    = 0x4E00;
+constexpr uint16_t NUM_GLYPHS     = 300;
+
+uint32_t code_point_of(uint16_t index) {
+    return FIRST_GLYPH + index * 3;
+}
+
+// Glyphs are 1 to 8 pixels wide, so that each glyph starts on a byte boundary
+uint8_t width_of(uint16_t index) {
+    return 1 + index % 8;
+}
+
+// Each row of a glyph is either fully lit or not, following the bits of its index
+bool row_lit(uint16_t index, uint8_t row) {
+    return ((index % 255 + 1) >> row) & 1;
+}
+
+void put(std::vector<uint8_t> &out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out.push_back((value >> (8 * i)) & 0xFF);
+    }
+}
+
+void put_block_header(std::vector<uint8_t> &out, uint8_t type_id, uint32_t length) {
+    put(out, type_id, 1);
+    put(out, (uint8_t)~type_id, 1);
+    put(out, length, 3);
+}
+
+// Builds a 1bpp grayscale QFF with only a unicode table, in the given glyph order
+std::vector<uint8_t> make_font(const std::vector<uint16_t> &order) {
+    std::vector<uint8_t>  data;
+    std::vector<uint32_t> offsets(NUM_GLYPHS);
+    for (uint16_t index = 0; index < NUM_GLYPHS; index++) {
+        offsets[index] = data.size();
+
+        // 1bpp pixel data, a row at a time, least significant bit first
+        uint32_t bit = 0;
+        for (uint8_t row = 0; row < LINE_HEIGHT; row++) {
+            for (uint8_t column = 0; column < width_of(index); column++, bit++) {
+                if (bit % 8 == 0) {
+                    data.push_back(0);
+                }
+                if (row_lit(index, row)) {
+                    data.back() |= 1 << (bit % 8);
+                }
+            }
+        }
+    }
+
+    std::vector<uint8_t> font;
+    uint32_t             total_size = 25 + 5 + order.size() * 6 + 5 + data.size();
+    put_block_header(font, 0x00, 20);
+    put(font, 0x464651, 3); // magic
+    put(font, 0x01, 1);     // version
+    put(font, total_size, 4);
+    put(font, ~total_size, 4);
+    put(font, LINE_HEIGHT, 1);
+    put(font, 0, 1); // no ascii table
+    put(font, order.size(), 2);
+    put(font, 0x00, 1); // GRAYSCALE_1BPP
+    put(font, 0, 1);    // flags
+    put(font, 0, 1);    // uncompressed
+    put(font, 0xFF, 1); // transparency index
+
+    put_block_header(font, 0x02, order.size() * 6);
+    for (uint16_t index : order) {
+        put(font, code_point_of(index), 3);
+        put(font, width_of(index) | (offsets[index] << 6), 3);
+    }
+
+    put_block_header(font, 0x04, data.size());
+    font.insert(font.end(), data.begin(), data.end());
+    return font;
+}
+
+std::vector<uint16_t> all_glyphs(void) {
+    std::vector<uint16_t> order;
+    for (uint16_t index = 0; index < NUM_GLYPHS; index++) {
+        order.push_back(index);
+    }
+    return order;
+}
+
+// Blanks the pixel data of every glyph, so that only glyphs drawn from the text cache remain visible
+void wipe_glyphs(std::vector<uint8_t> &font) {
+    uint32_t num_glyphs = font[19] | (font[20] << 8);
+    std::fill(font.begin() + 25 + 5 + num_glyphs * 6 + 5, font.end(), 0);
+}
+
+// Text cache space taken by a glyph drawn to an RGB565 surface
+uint32_t cache_entry_size(uint16_t index) {
+    return 16 + width_of(index) * LINE_HEIGHT * 2;
+}
+
+std::string utf8(uint32_t code_point) {
+    std::string out;
+    if (code_point < 0x80) {
+        out += (char)code_point;
+    } else if (code_point < 0x800) {
+        out += (char)(0xC0 | (code_point >> 6));
+        out += (char)(0x80 | (code_point & 0x3F));
+    } else {
+        out += (char)(0xE0 | (code_point >> 12));
+        out += (char)(0x80 | ((code_point >> 6) & 0x3F));
+        out += (char)(0x80 | (code_point & 0x3F));
+    }
+    return out;
+}
+
+std::string text_of(const std::vector<uint16_t> &indices) {
+    std::string out;
+    for (uint16_t index : indices) {
+        out += utf8(code_point_of(index));
+    }
+    return out;
+}
+
+// Counts the stream accesses a loaded font makes, by wrapping the memory stream its handle reads the QFF through
+class CountingStream {
+   public:
+    static uint32_t bytes_read;
+    static uint32_t seeks;
+
+    // The stream lives inside the font handle, find it by the buffer and length it was made for
+    static bool wrap(painter_font_handle_t font, std::vector<uint8_t> &qff) {
+        uint8_t *handle = (uint8_t *)font;
+        for (size_t offset = 0; offset <= 32; offset += alignof(qp_memory_stream_t)) {
+            qp_memory_stream_t *stream = (qp_memory_stream_t *)(handle + offset);
+            if (stream->buffer == qff.data() && stream->length == (int32_t)qff.size()) {
+                real_get          = stream->base.get;
+                real_seek         = stream->base.seek;
+                stream->base.get  = get;
+                stream->base.seek = seek;
+                reset();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void reset(void) {
+        bytes_read = 0;
+        seeks      = 0;
+    }
+
+   private:
+    static int16_t (*real_get)(qp_stream_t *stream);
+    static int (*real_seek)(qp_stream_t *stream, int32_t offset, int origin);
+
+    static int16_t get(qp_stream_t *stream) {
+        bytes_read++;
+        return real_get(stream);
+    }
+
+    static int seek(qp_stream_t *stream, int32_t offset, int origin) {
+        seeks++;
+        return real_seek(stream, offset, origin);
+    }
+};
+
+uint32_t CountingStream::bytes_read;
+uint32_t CountingStream::seeks;
+int16_t (*CountingStream::real_get)(qp_stream_t *stream);
+int (*CountingStream::real_seek)(qp_stream_t *stream, int32_t offset, int origin);
+
+} // namespace
+
+class QuantumPainterText : public TestFixture {
+   protected:
+    // Surfaces can't be released, so all tests share the one
+    static uint16_t         buffer[SURFACE_WIDTH * SURFACE_HEIGHT];
+    static painter_device_t surface;
+
+    static void SetUpTestCase() {
+        TestFixture::SetUpTestCase();
+        surface = qp_make_rgb565_surface(SURFACE_WIDTH, SURFACE_HEIGHT, buffer);
+        ASSERT_TRUE(qp_init(surface, QP_ROTATION_0));
+    }
+
+    void TearDown() override {
+        qp_set_text_cache(surface, NULL, 0);
+        TestFixture::TearDown();
+    }
+
+    bool lit(uint16_t x, uint16_t y) {
+        return buffer[y * SURFACE_WIDTH + x] != 0;
+    }
+
+    // Draws the glyphs, checking each ended up where expected
+    void expect_drawn(painter_font_handle_t font, const std::vector<uint16_t> &indices, bool blank = false) {
+        memset(buffer, 0, sizeof(buffer));
+
+        int16_t expected_width = 0;
+        for (uint16_t index : indices) {
+            expected_width += width_of(index);
+        }
+        std::string text = text_of(indices);
+        EXPECT_EQ(qp_textwidth(font, text.c_str()), expected_width);
+        EXPECT_EQ(qp_drawtext(surface, 0, 0, font, text.c_str()), expected_width);
+
+        uint16_t x = 0;
+        for (uint16_t index : indices) {
+            for (uint8_t row = 0; row < LINE_HEIGHT; row++) {
+                EXPECT_EQ(lit(x, row), !blank && row_lit(index, row)) << "glyph " << index << " row " << (int)row;
+            }
+            x += width_of(index);
+        }
+    }
+};
+
+uint16_t         QuantumPainterText::buffer[SURFACE_WIDTH * SURFACE_HEIGHT];
+painter_device_t QuantumPainterText::surface;
+
+TEST_F(QuantumPainterText, SortedTableIsSearched) {
+    TestDriver driver;
+
+    std::vector<uint8_t>  qff  = make_font(all_glyphs());
+    painter_font_handle_t font = qp_load_font_mem(qff.data());
+    ASSERT_NE(font, nullptr);
+
+    expect_drawn(font, {0, NUM_GLYPHS - 1, 150, 1, 77});
+    EXPECT_EQ(qp_textwidth(font, utf8(code_point_of(1) + 1).c_str()), 0) << "Missing glyphs should not be found";
+
+    qp_close_font(font);
+}
+
+TEST_F(QuantumPainterText, UnsortedTableIsSearched) {
+    TestDriver driver;
+
+    std::vector<uint16_t> order = all_glyphs();
+    std::reverse(order.begin(), order.end());
+    std::vector<uint8_t>  qff  = make_font(order);
+    painter_font_handle_t font = qp_load_font_mem(qff.data());
+    ASSERT_NE(font, nullptr);
+
+    expect_drawn(font, {0, NUM_GLYPHS - 1, 150, 1, 77});
+    EXPECT_EQ(qp_textwidth(font, utf8(code_point_of(1) + 1).c_str()), 0) << "Missing glyphs should not be found";
+
+    qp_close_font(font);
+}
+
+TEST_F(QuantumPainterText, CachedGlyphsStayCorrect) {
+    TestDriver driver;
+
+    std::vector<uint8_t>  qff  = make_font(all_glyphs());
+    painter_font_handle_t font = qp_load_font_mem(qff.data());
+    ASSERT_NE(font, nullptr);
+
+    // Repeats hit the cache, and more distinct glyphs than it holds evict from it
+    expect_drawn(font, {10, 11, 10, 12, 10});
+    expect_drawn(font, {20, 21, 22, 23, 24, 10, 11, 12});
+    expect_drawn(font, {24, 12, 23, 11, 22, 10, 21});
+
+    qp_close_font(font);
+
+    // Reloading into the same slot must not see the old font's glyphs
+    std::vector<uint16_t> order = all_glyphs();
+    std::reverse(order.begin(), order.end());
+    order.pop_back(); // drop glyph 0
+    std::vector<uint8_t> other = make_font(order);
+    font                       = qp_load_font_mem(other.data());
+    ASSERT_NE(font, nullptr);
+
+    expect_drawn(font, {10, 11, 12});
+    EXPECT_EQ(qp_textwidth(font, text_of({0}).c_str()), 0);
+
+    qp_close_font(font);
+}
+
+TEST_F(QuantumPainterText, TextCacheIsUsedForRepeatedText) {
+    TestDriver driver;
+
+    static uint8_t cache[1024];
+    ASSERT_TRUE(qp_set_text_cache(surface, cache, sizeof(cache)));
+
+    std::vector<uint8_t>  qff  = make_font(all_glyphs());
+    painter_font_handle_t font = qp_load_font_mem(qff.data());
+    ASSERT_NE(font, nullptr);
+
+    expect_drawn(font, {10, 11, 12});
+    wipe_glyphs(qff);
+    expect_drawn(font, {12, 10, 11});
+    expect_drawn(font, {13}, true);
+
+    // Other colors are cached separately
+    memset(buffer, 0, sizeof(buffer));
+    qp_drawtext_recolor(surface, 0, 0, font, text_of({10}).c_str(), 0, 0, 200, 0, 0, 0);
+    EXPECT_FALSE(lit(0, 0));
+
+    qp_close_font(font);
+}
+
+TEST_F(QuantumPainterText, TextCacheStartsAgainWhenFull) {
+    TestDriver driver;
+
+    static uint8_t cache[1024];
+    ASSERT_TRUE(qp_set_text_cache(surface, cache, cache_entry_size(10) + cache_entry_size(11)));
+
+    std::vector<uint8_t>  qff  = make_font(all_glyphs());
+    painter_font_handle_t font = qp_load_font_mem(qff.data());
+    ASSERT_NE(font, nullptr);
+
+    expect_drawn(font, {10, 11, 12});
+    wipe_glyphs(qff);
+    expect_drawn(font, {12});
+    expect_drawn(font, {10}, true);
+
+    qp_close_font(font);
+}
+
+TEST_F(QuantumPainterText, TextCacheIsNotSharedBetweenFontLoads) {
+    TestDriver driver;
+
+    static uint8_t cache[1024];
+    ASSERT_TRUE(qp_set_text_cache(surface, cache, sizeof(cache)));
+
+    std::vector<uint8_t>  qff  = make_font(all_glyphs());
+    painter_font_handle_t font = qp_load_font_mem(qff.data());
+    ASSERT_NE(font, nullptr);
+    expect_drawn(font, {10});
+    qp_close_font(font);
+
+    wipe_glyphs(qff);
+    font = qp_load_font_mem(qff.data());
+    ASSERT_NE(font, nullptr);
+    expect_drawn(font, {10}, true);
+    qp_close_font(font);
+}
+
+TEST_F(QuantumPainterText, LookupsTakeLogarithmicReadsAndRepeatsAreCached) {
+    TestDriver driver;
+
+    // A binary search over NUM_GLYPHS entries probes at most this many of them
+    uint32_t max_probes = 0;
+    while ((1u << max_probes) <= NUM_GLYPHS) {
+        max_probes++;
+    }
+
+    std::vector<uint8_t>  qff  = make_font(all_glyphs());
+    painter_font_handle_t font = qp_load_font_mem(qff.data());
+    ASSERT_NE(font, nullptr);
+    ASSERT_TRUE(CountingStream::wrap(font, qff));
+
+    // The last glyph is the worst case for a linear scan, which would read every entry before it
+    EXPECT_EQ(qp_textwidth(font, text_of({NUM_GLYPHS - 1}).c_str()), width_of(NUM_GLYPHS - 1));
+    // Each probe seeks to its entry, then one more seek positions the stream at the glyph's pixel data
+    EXPECT_GT(CountingStream::seeks, 1);
+    EXPECT_LE(CountingStream::seeks, max_probes + 1);
+    EXPECT_LE(CountingStream::bytes_read, max_probes * 6) << "A linear scan reads " << NUM_GLYPHS * 6 << " bytes";
+
+    // Repeated glyphs come from the glyph cache without reading the table, leaving only the seeks to the pixel data
+    CountingStream::reset();
+    EXPECT_EQ(qp_textwidth(font, text_of({NUM_GLYPHS - 1, NUM_GLYPHS - 1}).c_str()), 2 * width_of(NUM_GLYPHS - 1));
+    EXPECT_EQ(CountingStream::seeks, 2);
+    EXPECT_EQ(CountingStream::bytes_read, 0);
+
+    qp_close_font(font);
+}
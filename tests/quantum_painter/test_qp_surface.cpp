@@ -0,0 +1,200 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "qp.h"
+#include "qp_internal.h"
+#include "qp_surface.h"
+#include "qp_comms_dummy.h"
+}
+
+namespace {
+
+constexpr uint16_t SURFACE_SIZE = 64;
+
+struct viewport_t {
+    uint16_t l, t, r, b;
+};
+
+// A target device which records what a surface sends it
+struct recorder_t {
+    painter_driver_t        base;
+    std::vector<viewport_t> viewports;
+    uint32_t                pixels_sent;
+    uint16_t                framebuffer[SURFACE_SIZE * SURFACE_SIZE];
+    viewport_t              viewport;
+    uint16_t                x, y;
+} recorder;
+
+bool recorder_ok(painter_device_t device) {
+    return true;
+}
+
+bool recorder_init(painter_device_t device, painter_rotation_t rotation) {
+    return true;
+}
+
+bool recorder_power(painter_device_t device, bool power_on) {
+    return true;
+}
+
+bool recorder_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom) {
+    recorder.viewport = {left, top, right, bottom};
+    recorder.viewports.push_back(recorder.viewport);
+    recorder.x = left;
+    recorder.y = top;
+    return true;
+}
+
+bool recorder_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count) {
+    const uint16_t *pixels = (const uint16_t *)pixel_data;
+    for (uint32_t i = 0; i < native_pixel_count; i++) {
+        recorder.framebuffer[recorder.y * SURFACE_SIZE + recorder.x] = pixels[i];
+        if (++recorder.x > recorder.viewport.r) {
+            recorder.x = recorder.viewport.l;
+            recorder.y++;
+        }
+    }
+    recorder.pixels_sent += native_pixel_count;
+    return true;
+}
+
+bool recorder_palette_convert(painter_device_t device, int16_t palette_size, qp_pixel_t *palette) {
+    return true;
+}
+
+bool recorder_append_pixels(painter_device_t device, uint8_t *target_buffer, qp_pixel_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices) {
+    return true;
+}
+
+bool recorder_append_pixdata(painter_device_t device, uint8_t *target_buffer, uint32_t pixdata_offset, uint8_t pixdata_byte) {
+    return true;
+}
+
+const painter_driver_vtable_t recorder_vtable = {
+    .init            = recorder_init,
+    .power           = recorder_power,
+    .clear           = recorder_ok,
+    .flush           = recorder_ok,
+    .viewport        = recorder_viewport,
+    .pixdata         = recorder_pixdata,
+    .palette_convert = recorder_palette_convert,
+    .append_pixels   = recorder_append_pixels,
+    .append_pixdata  = recorder_append_pixdata,
+};
+
+} // namespace
+
+class QuantumPainterSurface : public TestFixture {
+   protected:
+    // Surfaces can't be released, so all tests share the one
+    static uint16_t         buffer[SURFACE_SIZE * SURFACE_SIZE];
+    static painter_device_t surface;
+
+    static void SetUpTestCase() {
+        TestFixture::SetUpTestCase();
+        surface = qp_make_rgb565_surface(SURFACE_SIZE, SURFACE_SIZE, buffer);
+        ASSERT_TRUE(qp_init(surface, QP_ROTATION_0));
+
+        recorder.base.driver_vtable         = &recorder_vtable;
+        recorder.base.comms_vtable          = &dummy_comms_vtable;
+        recorder.base.panel_width           = SURFACE_SIZE;
+        recorder.base.panel_height          = SURFACE_SIZE;
+        recorder.base.native_bits_per_pixel = 16;
+        recorder.base.validate_ok           = true;
+    }
+
+    void SetUp() override {
+        // Start from a blank surface, already on the target
+        ASSERT_TRUE(qp_clear(surface));
+        ASSERT_TRUE(qp_surface_draw(surface, &recorder, 0, 0, false));
+        recorder.viewports.clear();
+        recorder.pixels_sent = 0;
+    }
+
+    void draw() {
+        ASSERT_TRUE(qp_surface_draw(surface, &recorder, 0, 0, false));
+        EXPECT_EQ(memcmp(recorder.framebuffer, buffer, sizeof(buffer)), 0) << "The target should match the surface";
+    }
+};
+
+uint16_t         QuantumPainterSurface::buffer[SURFACE_SIZE * SURFACE_SIZE];
+painter_device_t QuantumPainterSurface::surface;
+
+TEST_F(QuantumPainterSurface, ClearedSurfaceIsSentWhole) {
+    TestDriver driver;
+
+    ASSERT_TRUE(qp_clear(surface));
+    draw();
+    ASSERT_EQ(recorder.viewports.size(), 1);
+    EXPECT_EQ(recorder.pixels_sent, SURFACE_SIZE * SURFACE_SIZE);
+}
+
+TEST_F(QuantumPainterSurface, DistantChangesAreSentSeparately) {
+    TestDriver driver;
+
+    // A clock in one corner, a layer indicator in the other
+    qp_rect(surface, 2, 2, 11, 5, 0, 0, 255, true);
+    qp_rect(surface, 56, 58, 61, 61, 0, 0, 255, true);
+    draw();
+
+    ASSERT_EQ(recorder.viewports.size(), 2);
+    EXPECT_EQ(recorder.pixels_sent, 10 * 4 + 6 * 4);
+}
+
+TEST_F(QuantumPainterSurface, NearbyChangesAreMerged) {
+    TestDriver driver;
+
+    qp_setpixel(surface, 10, 10, 0, 0, 255);
+    qp_setpixel(surface, 10 + SURFACE_DIRTY_MERGE_DISTANCE, 10, 0, 0, 255);
+    draw();
+
+    ASSERT_EQ(recorder.viewports.size(), 1);
+    EXPECT_EQ(recorder.pixels_sent, SURFACE_DIRTY_MERGE_DISTANCE + 1);
+}
+
+TEST_F(QuantumPainterSurface, RegionsGrowingTogetherAreMerged) {
+    TestDriver driver;
+
+    qp_setpixel(surface, 10, 10, 0, 0, 255);
+    qp_setpixel(surface, 40, 10, 0, 0, 255);
+    qp_rect(surface, 10, 10, 40, 11, 0, 0, 255, true);
+    draw();
+
+    ASSERT_EQ(recorder.viewports.size(), 1);
+    EXPECT_EQ(recorder.pixels_sent, 31 * 2);
+}
+
+TEST_F(QuantumPainterSurface, RegionsAreBounded) {
+    TestDriver driver;
+
+    for (uint16_t i = 0; i <= SURFACE_DIRTY_REGIONS; i++) {
+        qp_setpixel(surface, i * 12, i * 12, 0, 0, 255);
+    }
+    draw();
+
+    EXPECT_EQ(recorder.viewports.size(), SURFACE_DIRTY_REGIONS);
+    EXPECT_LT(recorder.pixels_sent, SURFACE_SIZE * SURFACE_SIZE / 2);
+}
+
+TEST_F(QuantumPainterSurface, EntireSurfaceIgnoresRegions) {
+    TestDriver driver;
+
+    qp_setpixel(surface, 1, 1, 0, 0, 255);
+    qp_setpixel(surface, 60, 60, 0, 0, 255);
+    ASSERT_TRUE(qp_surface_draw(surface, &recorder, 0, 0, true));
+
+    ASSERT_EQ(recorder.viewports.size(), 1);
+    EXPECT_EQ(recorder.pixels_sent, SURFACE_SIZE * SURFACE_SIZE);
+}
+
+TEST_F(QuantumPainterSurface, UnchangedSurfaceIsNotSent) {
+    TestDriver driver;
+
+    draw();
+    EXPECT_EQ(recorder.viewports.size(), 0);
+}
@@ -0,0 +1,14 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define RGB_MATRIX_LED_COUNT 2
+#define RGB_MATRIX_DIRTY_TRACKING
+#define RGB_MATRIX_IDLE_FRAME_SKIP
+#define RGB_MATRIX_IDLE_REFRESH_INTERVAL 100
+
+#define RGB_MATRIX_KEYPRESSES
+#define ENABLE_RGB_MATRIX_SOLID_REACTIVE_SIMPLE
@@ -0,0 +1,121 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "rgb_matrix.h"
+}
+
+namespace {
+
+uint32_t flushes    = 0;
+uint32_t set_colors = 0;
+uint32_t frames     = 0;
+
+void driver_init(void) {}
+
+void driver_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    set_colors++;
+}
+
+void driver_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    set_colors++;
+}
+
+void driver_flush(void) {
+    flushes++;
+}
+
+} // namespace
+
+extern "C" {
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = driver_init,
+    .set_color     = driver_set_color,
+    .set_color_all = driver_set_color_all,
+    .flush         = driver_flush,
+};
+
+// LED 0 under the key at row 0, column 0, every other key on LED 1
+led_config_t g_led_config = {{{0, 1, 1, 1, 1, 1, 1, 1, 1, 1}, {1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, {1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, {1, 1, 1, 1, 1, 1, 1, 1, 1, 1}}, {{0, 0}, {10, 0}}, {4, 4}};
+
+// Drawn once per rendered frame
+bool rgb_matrix_indicators_user(void) {
+    frames++;
+    return true;
+}
+}
+
+class RgbMatrixDirtyTracking : public TestFixture {
+   protected:
+    void SetUp() override {
+        rgb_matrix_enable_noeeprom();
+        rgb_matrix_sethsv_noeeprom(0, 255, 255);
+    }
+
+    void reset_counts() {
+        flushes    = 0;
+        set_colors = 0;
+        frames     = 0;
+    }
+};
+
+TEST_F(RgbMatrixDirtyTracking, StaticEffectStopsFlushingOnceClean) {
+    TestDriver driver;
+
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+    idle_for(50);
+    EXPECT_GT(flushes, 0U);
+
+    reset_counts();
+    idle_for(1000);
+    // The periodic refresh still renders, but nothing reaches the driver
+    EXPECT_GT(frames, 0U);
+    EXPECT_LT(frames, 20U);
+    EXPECT_EQ(set_colors, 0U);
+    EXPECT_EQ(flushes, 0U);
+
+    // A new colour is flushed once, then it is clean again
+    rgb_matrix_sethsv_noeeprom(85, 255, 255);
+    idle_for(50);
+    EXPECT_EQ(set_colors, RGB_MATRIX_LED_COUNT);
+    EXPECT_EQ(flushes, 1U);
+
+    reset_counts();
+    idle_for(1000);
+    EXPECT_EQ(flushes, 0U);
+}
+
+TEST_F(RgbMatrixDirtyTracking, ReactiveEffectRefreshesAfterKeyPress) {
+    TestDriver driver;
+    KeymapKey  key(0, 0, 0, KC_NO);
+    set_keymap({key});
+
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_REACTIVE_SIMPLE);
+    idle_for(1000);
+
+    reset_counts();
+    idle_for(500);
+    EXPECT_EQ(flushes, 0U);
+
+    key.press();
+    run_one_scan_loop();
+    idle_for(50);
+    key.release();
+    run_one_scan_loop();
+
+    // The hit fades out over several frames, each changing LED 0
+    idle_for(200);
+    EXPECT_GT(flushes, 1U);
+    EXPECT_GT(set_colors, 1U);
+
+    // Once the hit has faded, the effect settles and stops flushing
+    idle_for(5000);
+    reset_counts();
+    idle_for(1000);
+    EXPECT_EQ(flushes, 0U);
+}
@@ -0,0 +1,10 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define SPLIT_MATRIX_EVENTS
+// Keep the periodic timer sync off the bus so only matrix traffic is counted
+#define DISABLE_SYNC_TIMER
@@ -0,0 +1,5 @@
+# Copyright 2025 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+SPLIT_KEYBOARD = yes
+SERIAL_DRIVER = bitbang
@@ -0,0 +1,174 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+#include "split_loopback.h"
+
+extern "C" {
+#include "crc.h"
+#include "transport.h"
+}
+
+#define HALF_ROWS ((MATRIX_ROWS) / 2)
+
+class SplitMatrixEvents : public TestFixture {
+   protected:
+    matrix_row_t master_matrix[HALF_ROWS]        = {0};
+    matrix_row_t slave_matrix[HALF_ROWS]         = {0};
+    matrix_row_t slave_scan[HALF_ROWS]           = {0};
+    matrix_row_t slave_view_of_master[HALF_ROWS] = {0};
+
+    void SetUp() override {
+        split_loopback_init();
+        scan();
+        split_loopback_reset_stats();
+    }
+
+    /* One scan of each half: the slave publishes its matrix, then the master polls it. */
+    bool scan() {
+        split_loopback_slave(slave_view_of_master, slave_scan);
+        return split_loopback_master(master_matrix, slave_matrix);
+    }
+
+    void expect_slave_matrix_synced() {
+        for (uint8_t row = 0; row < HALF_ROWS; row++) {
+            EXPECT_EQ(slave_matrix[row], slave_scan[row]) << "row " << +row;
+        }
+    }
+};
+
+TEST_F(SplitMatrixEvents, IdleScansOnlyPollTheSequence) {
+    TestDriver driver;
+
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(split_loopback_transactions(), 1u);
+    EXPECT_EQ(split_loopback_bytes(), 1u);
+
+    // No periodic full-matrix resync while nothing changes
+    idle_for(1000);
+    split_loopback_reset_stats();
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(scan());
+    }
+    EXPECT_EQ(split_loopback_transactions(), 10u);
+    EXPECT_EQ(split_loopback_bytes(), 10u);
+    expect_slave_matrix_synced();
+}
+
+TEST_F(SplitMatrixEvents, SingleRowChangeSkipsTheMatrixRead) {
+    TestDriver driver;
+
+    // The sequence, then the event
+    slave_scan[1] = 0b1001;
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(split_loopback_transactions(), 2u);
+    expect_slave_matrix_synced();
+
+    split_loopback_reset_stats();
+    slave_scan[1] = 0b0001;
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(split_loopback_transactions(), 2u);
+    expect_slave_matrix_synced();
+
+    slave_scan[1] = 0;
+    EXPECT_TRUE(scan());
+    expect_slave_matrix_synced();
+}
+
+TEST_F(SplitMatrixEvents, MultiRowChangeFetchesFullMatrix) {
+    TestDriver driver;
+
+    slave_scan[0] = 0b0110;
+    slave_scan[1] = 0b1000;
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(split_loopback_transactions(), 3u);
+    expect_slave_matrix_synced();
+
+    slave_scan[0] = 0;
+    slave_scan[1] = 0;
+    EXPECT_TRUE(scan());
+    expect_slave_matrix_synced();
+}
+
+TEST_F(SplitMatrixEvents, MissedEventsFetchFullMatrix) {
+    TestDriver driver;
+
+    // Several slave scans between two master polls leave a sequence gap
+    slave_scan[0] = 0b0001;
+    split_loopback_slave(slave_view_of_master, slave_scan);
+    slave_scan[0] = 0b0011;
+    split_loopback_slave(slave_view_of_master, slave_scan);
+    slave_scan[0] = 0b0111;
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(split_loopback_transactions(), 3u);
+    expect_slave_matrix_synced();
+
+    // Back in step afterwards
+    split_loopback_reset_stats();
+    slave_scan[0] = 0b0110;
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(split_loopback_transactions(), 2u);
+    expect_slave_matrix_synced();
+
+    slave_scan[0] = 0;
+    EXPECT_TRUE(scan());
+    expect_slave_matrix_synced();
+}
+
+TEST_F(SplitMatrixEvents, DroppedEventFetchesFullMatrixEvenIfChecksumMatches) {
+    TestDriver driver;
+
+    // Find a two-row state whose checksum collides with the idle matrix, so the
+    // checksum alone can't reveal that the master missed getting there
+    matrix_row_t idle[HALF_ROWS]   = {0};
+    matrix_row_t target[HALF_ROWS] = {0};
+    uint8_t      idle_checksum     = crc8(idle, sizeof(idle));
+    bool         found             = false;
+    for (uint16_t a = 1; a <= 0xFF && !found; a++) {
+        for (uint16_t b = 1; b <= 0xFF && !found; b++) {
+            target[0] = a;
+            target[1] = b;
+            found     = crc8(target, sizeof(target)) == idle_checksum;
+        }
+    }
+    ASSERT_TRUE(found);
+
+    // The master misses the event for the first row, then sees the second one
+    slave_scan[0] = target[0];
+    split_loopback_slave(slave_view_of_master, slave_scan);
+    slave_scan[1] = target[1];
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(split_loopback_transactions(), 3u);
+    expect_slave_matrix_synced();
+
+    // Back in step afterwards
+    split_loopback_reset_stats();
+    slave_scan[0] = 0;
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(split_loopback_transactions(), 2u);
+    expect_slave_matrix_synced();
+
+    slave_scan[1] = 0;
+    EXPECT_TRUE(scan());
+    expect_slave_matrix_synced();
+}
+
+TEST_F(SplitMatrixEvents, KeysHeldAtStartupAreRead) {
+    TestDriver driver;
+
+    // Restart both halves with a key already down, the master has never seen a sequence
+    split_loopback_init();
+    slave_scan[0] = 0b0100;
+    split_loopback_slave(slave_view_of_master, slave_scan);
+    split_loopback_reset_stats();
+
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(split_loopback_transactions(), 3u);
+    expect_slave_matrix_synced();
+
+    split_loopback_reset_stats();
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(split_loopback_transactions(), 1u);
+    expect_slave_matrix_synced();
+}
@@ -0,0 +1,101 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+#include "test_common.hpp"
+#include "split_loopback.h"
+
+extern "C" {
+#include "transport.h"
+}
+
+#define HALF_ROWS ((MATRIX_ROWS) / 2)
+
+// Both halves share the same globals in the loopback, so anything the slave applies
+// from stale shared memory overwrites what the master just set.
+class SplitTransactionBatching : public TestFixture {
+   protected:
+    matrix_row_t master_matrix[HALF_ROWS]        = {0};
+    matrix_row_t slave_matrix[HALF_ROWS]         = {0};
+    matrix_row_t slave_scan[HALF_ROWS]           = {0};
+    matrix_row_t slave_view_of_master[HALF_ROWS] = {0};
+
+    void SetUp() override {
+        layer_state = 0;
+        clear_mods();
+        split_loopback_init();
+        scan();
+        scan();
+    }
+
+    void TearDown() override {
+        layer_state = 0;
+        clear_mods();
+    }
+
+    bool master() {
+        return split_loopback_master(master_matrix, slave_matrix);
+    }
+
+    void slave() {
+        split_loopback_slave(slave_view_of_master, slave_scan);
+    }
+
+    /* One scan of each half: the slave applies what it was sent, then the master syncs. */
+    bool scan() {
+        slave();
+        return master();
+    }
+};
+
+TEST_F(SplitTransactionBatching, ChangesReachTheSlave) {
+    TestDriver driver;
+
+    layer_state = 0b10;
+    EXPECT_TRUE(master());
+    slave();
+    EXPECT_EQ(layer_state, 0b10u);
+
+    set_mods(MOD_BIT(KC_LSFT));
+    EXPECT_TRUE(master());
+    slave();
+    EXPECT_EQ(get_mods(), MOD_BIT(KC_LSFT));
+    EXPECT_EQ(layer_state, 0b10u);
+}
+
+TEST_F(SplitTransactionBatching, FrameOverwrittenBeforeSlaveLoopIsNotLost) {
+    TestDriver driver;
+
+    // Two frames go out before the slave loop runs, each with a different change
+    layer_state = 0b100;
+    EXPECT_TRUE(master());
+    set_mods(MOD_BIT(KC_LCTL));
+    EXPECT_TRUE(master());
+
+    slave();
+    EXPECT_EQ(layer_state, 0b100u);
+    EXPECT_EQ(get_mods(), MOD_BIT(KC_LCTL));
+
+    // Once acknowledged the slave keeps the state without it being resent
+    EXPECT_TRUE(master());
+    slave();
+    EXPECT_EQ(layer_state, 0b100u);
+    EXPECT_EQ(get_mods(), MOD_BIT(KC_LCTL));
+}
+
+TEST_F(SplitTransactionBatching, MasterRebootDoesNotRepeatSequence) {
+    TestDriver driver;
+
+    layer_state = 0b10;
+    EXPECT_TRUE(master());
+    slave();
+    EXPECT_EQ(layer_state, 0b10u);
+
+    // The master restarts its sequence while the slave keeps running
+    transport_master_init();
+    layer_state = 0b1000;
+    EXPECT_TRUE(master());
+    EXPECT_TRUE(master());
+    slave();
+    EXPECT_EQ(layer_state, 0b1000u);
+}
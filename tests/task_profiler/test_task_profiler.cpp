@@ -0,0 +1,171 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "task_profiler.h"
+
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+
+namespace {
+
+// Simulated cost, in milliseconds, of the user hooks below
+uint32_t process_record_cost = 0;
+uint32_t housekeeping_cost   = 0;
+
+extern "C" bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    advance_time(process_record_cost);
+    return true;
+}
+
+extern "C" void housekeeping_task_user(void) {
+    advance_time(housekeeping_cost);
+}
+
+task_profiler_stats_t stats_for(task_profiler_slot_t slot) {
+    task_profiler_stats_t stats;
+    EXPECT_TRUE(task_profiler_get_stats(slot, &stats));
+    return stats;
+}
+
+uint32_t get_u32(const uint8_t *data) {
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+}
+
+} // namespace
+
+class TaskProfiler : public TestFixture {
+   protected:
+    void SetUp() override {
+        process_record_cost = 0;
+        housekeeping_cost   = 0;
+        task_profiler_reset();
+    }
+};
+
+TEST_F(TaskProfiler, PercentilesComeFromTheHistogram) {
+    TestDriver driver;
+
+    for (int i = 0; i < 98; i++) {
+        task_profiler_record(TASK_PROFILER_SLOT_RGB_MATRIX, 3);
+    }
+    task_profiler_record(TASK_PROFILER_SLOT_RGB_MATRIX, 700);
+    task_profiler_record(TASK_PROFILER_SLOT_RGB_MATRIX, 1000);
+
+    auto stats = stats_for(TASK_PROFILER_SLOT_RGB_MATRIX);
+    EXPECT_EQ(stats.count, 100u);
+    EXPECT_EQ(stats.min, 3u);
+    EXPECT_EQ(stats.p50, 3u);
+    // Both outliers land in the 512..1023 bucket, whose upper bound is clamped to the observed maximum
+    EXPECT_EQ(stats.p99, 1000u);
+    EXPECT_EQ(stats.max, 1000u);
+
+    EXPECT_EQ(stats_for(TASK_PROFILER_SLOT_OLED).count, 0u);
+}
+
+TEST_F(TaskProfiler, HistogramHalvesInsteadOfSaturating) {
+    TestDriver driver;
+
+    for (uint32_t i = 0; i < 70000; i++) {
+        task_profiler_record(TASK_PROFILER_SLOT_QUANTUM, 1);
+    }
+    for (uint32_t i = 0; i < 40000; i++) {
+        task_profiler_record(TASK_PROFILER_SLOT_QUANTUM, 100);
+    }
+
+    auto stats = stats_for(TASK_PROFILER_SLOT_QUANTUM);
+    EXPECT_EQ(stats.count, 110000u);
+    EXPECT_EQ(stats.min, 1u);
+    EXPECT_EQ(stats.max, 100u);
+    // Older samples were halved away, so the median follows the recent ones
+    EXPECT_EQ(stats.p50, 100u);
+}
+
+TEST_F(TaskProfiler, EveryScanLoopIsRecorded) {
+    TestDriver driver;
+
+    housekeeping_cost = 2;
+    idle_for(10);
+
+    EXPECT_EQ(stats_for(TASK_PROFILER_SLOT_MATRIX).count, 10u);
+    EXPECT_EQ(stats_for(TASK_PROFILER_SLOT_QUANTUM).count, 10u);
+    EXPECT_EQ(stats_for(TASK_PROFILER_SLOT_OTHER).count, 10u);
+    EXPECT_EQ(stats_for(TASK_PROFILER_SLOT_KEYBOARD_TASK).count, 10u);
+    EXPECT_EQ(stats_for(TASK_PROFILER_SLOT_KEYBOARD_TASK).max, 0u);
+
+    auto housekeeping = stats_for(TASK_PROFILER_SLOT_HOUSEKEEPING);
+    EXPECT_EQ(housekeeping.count, 10u);
+    EXPECT_EQ(housekeeping.min, 2u);
+    EXPECT_EQ(housekeeping.max, 2u);
+
+    // Each loop is the slow housekeeping plus the fixture's 1ms tick
+    auto loop = stats_for(TASK_PROFILER_SLOT_LOOP);
+    EXPECT_EQ(loop.count, 9u);
+    EXPECT_EQ(loop.p50, 3u);
+    EXPECT_EQ(loop.max, 3u);
+
+    // Features that are not compiled in stay empty
+    EXPECT_EQ(stats_for(TASK_PROFILER_SLOT_RGB_MATRIX).count, 0u);
+    EXPECT_EQ(stats_for(TASK_PROFILER_SLOT_TRANSACTIONS).count, 0u);
+}
+
+TEST_F(TaskProfiler, KeyLatencyRunsFromMatrixEdgeToReport) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key_a});
+    process_record_cost = 4;
+
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    auto latency = stats_for(TASK_PROFILER_SLOT_KEY_LATENCY);
+    EXPECT_EQ(latency.count, 2u);
+    EXPECT_EQ(latency.min, 4u);
+    EXPECT_EQ(latency.max, 4u);
+    EXPECT_EQ(stats_for(TASK_PROFILER_SLOT_MATRIX).max, 4u);
+}
+
+TEST_F(TaskProfiler, RawHidReturnsStats) {
+    TestDriver driver;
+
+    task_profiler_record(TASK_PROFILER_SLOT_MATRIX, 5);
+    task_profiler_record(TASK_PROFILER_SLOT_MATRIX, 300);
+
+    uint8_t data[32] = {TASK_PROFILER_COMMAND_ID, id_task_profiler_get_slot_count};
+    task_profiler_handle_cmd(data, sizeof(data));
+    EXPECT_EQ(data[2], TASK_PROFILER_SLOT_COUNT);
+
+    uint8_t stats[32] = {TASK_PROFILER_COMMAND_ID, id_task_profiler_get_stats, TASK_PROFILER_SLOT_MATRIX};
+    task_profiler_handle_cmd(stats, sizeof(stats));
+    EXPECT_EQ(stats[1], id_task_profiler_get_stats);
+    EXPECT_EQ(stats[2], TASK_PROFILER_SLOT_MATRIX);
+    EXPECT_EQ(get_u32(&stats[3]), 2u);
+    EXPECT_EQ(get_u32(&stats[7]), 5u);
+    EXPECT_EQ(get_u32(&stats[11]), 7u);
+    EXPECT_EQ(get_u32(&stats[15]), 300u);
+    EXPECT_EQ(get_u32(&stats[19]), 300u);
+
+    uint8_t bad_slot[32] = {TASK_PROFILER_COMMAND_ID, id_task_profiler_get_stats, TASK_PROFILER_SLOT_COUNT};
+    task_profiler_handle_cmd(bad_slot, sizeof(bad_slot));
+    EXPECT_EQ(bad_slot[1], 0xFF);
+
+    uint8_t reset[32] = {TASK_PROFILER_COMMAND_ID, id_task_profiler_reset};
+    task_profiler_handle_cmd(reset, sizeof(reset));
+    EXPECT_EQ(stats_for(TASK_PROFILER_SLOT_MATRIX).count, 0u);
+}
@@ -0,0 +1,183 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "task_scheduler.h"
+#include "timer.h"
+}
+
+using testing::_;
+using testing::ElementsAre;
+
+namespace {
+
+std::vector<char> runs;
+
+// Microseconds spent in tasks, on top of the milliseconds of the test timer
+uint32_t task_time = 0;
+
+// Simulated cost, in microseconds, of the slow task
+uint32_t slow_cost = 0;
+
+void task_a(void) {
+    runs.push_back('a');
+}
+
+void task_b(void) {
+    runs.push_back('b');
+}
+
+void slow_task(void) {
+    runs.push_back('s');
+    task_time += slow_cost;
+}
+
+int8_t add(void (*task)(void), uint16_t period, uint8_t priority, uint16_t budget) {
+    task_scheduler_task_t definition = {task, period, priority, budget, TASK_PROFILER_SLOT_COUNT};
+    return task_scheduler_add(&definition);
+}
+
+task_scheduler_stats_t stats_for(int8_t id) {
+    task_scheduler_stats_t stats;
+    EXPECT_TRUE(task_scheduler_get_stats(id, &stats));
+    return stats;
+}
+
+} // namespace
+
+extern "C" uint32_t task_scheduler_timestamp(void) {
+    return timer_read32() * 1000 + task_time;
+}
+
+class TaskScheduler : public TestFixture {
+   protected:
+    void SetUp() override {
+        runs.clear();
+        task_time = 0;
+        slow_cost = 0;
+        task_scheduler_init();
+    }
+};
+
+TEST_F(TaskScheduler, HigherPriorityRunsFirst) {
+    TestDriver driver;
+
+    add(task_a, 0, 1, 0);
+    add(task_b, 0, 5, 0);
+
+    run_one_scan_loop();
+    EXPECT_THAT(runs, ElementsAre('b', 'a'));
+}
+
+TEST_F(TaskScheduler, PeriodLimitsRuns) {
+    TestDriver driver;
+
+    int8_t id = add(task_a, 10, 1, 0);
+
+    idle_for(30);
+    EXPECT_EQ(stats_for(id).runs, 3);
+}
+
+TEST_F(TaskScheduler, SlowPassDefersLowerPriority) {
+    TestDriver driver;
+
+    slow_cost          = 3000;
+    int8_t slow        = add(slow_task, 0, 2, TASK_SCHEDULER_SCAN_INTERVAL);
+    int8_t lightweight = add(task_a, 0, 1, 1000);
+
+    run_one_scan_loop();
+    EXPECT_THAT(runs, ElementsAre('s'));
+    EXPECT_EQ(stats_for(lightweight).deferrals, 1);
+    EXPECT_EQ(stats_for(slow).overruns, 1);
+    EXPECT_EQ(stats_for(slow).max_duration, 3000);
+
+    // The slow task stops being slow, so the deferred one catches up
+    slow_cost = 0;
+    run_one_scan_loop();
+    EXPECT_THAT(runs, ElementsAre('s', 's', 'a'));
+    EXPECT_EQ(stats_for(lightweight).runs, 1);
+}
+
+TEST_F(TaskScheduler, SubMillisecondTimesAreMeasured) {
+    TestDriver driver;
+
+    slow_cost   = 300;
+    int8_t slow  = add(slow_task, 0, 2, 200);
+    int8_t big   = add(task_a, 0, 1, TASK_SCHEDULER_SCAN_INTERVAL - 200);
+    int8_t small = add(task_b, 0, 0, TASK_SCHEDULER_SCAN_INTERVAL - 400);
+
+    run_one_scan_loop();
+    EXPECT_EQ(stats_for(slow).overruns, 1);
+    EXPECT_EQ(stats_for(slow).max_duration, 300);
+    EXPECT_EQ(stats_for(big).runs, 0);
+    EXPECT_EQ(stats_for(big).deferrals, 1);
+    EXPECT_EQ(stats_for(small).runs, 1);
+}
+
+TEST_F(TaskScheduler, DeferralsAreBounded) {
+    TestDriver driver;
+
+    slow_cost = 3000;
+    add(slow_task, 0, 2, TASK_SCHEDULER_SCAN_INTERVAL);
+    int8_t starved = add(task_a, 0, 1, 1000);
+
+    for (int i = 0; i < TASK_SCHEDULER_MAX_DEFERRALS; i++) {
+        run_one_scan_loop();
+    }
+    EXPECT_EQ(stats_for(starved).runs, 0);
+    EXPECT_EQ(stats_for(starved).deferrals, TASK_SCHEDULER_MAX_DEFERRALS);
+
+    run_one_scan_loop();
+    EXPECT_EQ(stats_for(starved).runs, 1);
+}
+
+TEST_F(TaskScheduler, KeysAreReportedWhileTasksAreSlow) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+    slow_cost = 5000;
+    add(slow_task, 0, 1, TASK_SCHEDULER_SCAN_INTERVAL);
+
+    EXPECT_REPORT(driver, (KC_A));
+    key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    slow_cost = 0;
+}
+
+TEST_F(TaskScheduler, TableIsBounded) {
+    TestDriver driver;
+
+    for (int i = 0; i < TASK_SCHEDULER_MAX_TASKS; i++) {
+        EXPECT_EQ(add(task_a, 0, 0, 0), i);
+    }
+    EXPECT_EQ(add(task_a, 0, 0, 0), -1);
+}
+
+TEST_F(TaskScheduler, StatsCanBeReset) {
+    TestDriver driver;
+
+    int8_t id = add(task_a, 0, 0, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(stats_for(id).runs, 1);
+
+    task_scheduler_reset_stats();
+    EXPECT_EQ(stats_for(id).runs, 0);
+
+    task_scheduler_stats_t stats;
+    EXPECT_FALSE(task_scheduler_get_stats(id + 1, &stats));
+}
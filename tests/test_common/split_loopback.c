@@ -0,0 +1,76 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "split_loopback.h"
+#include "serial.h"
+#include "transactions.h"
+#include "transport.h"
+
+static split_shared_memory_t slave_shmem;
+static uint32_t              transaction_count;
+static uint32_t              byte_count;
+
+static void swap_shared_memory(void) {
+    split_shared_memory_t temp;
+    memcpy(&temp, split_shmem, sizeof(temp));
+    memcpy(split_shmem, &slave_shmem, sizeof(temp));
+    memcpy(&slave_shmem, &temp, sizeof(temp));
+}
+
+void soft_serial_initiator_init(void) {}
+
+void soft_serial_target_init(void) {}
+
+bool soft_serial_transaction(int sstd_index) {
+    split_transaction_desc_t *trans = &split_transaction_table[sstd_index];
+
+    transaction_count++;
+    byte_count += trans->initiator2target_buffer_size + trans->target2initiator_buffer_size;
+
+    if (trans->initiator2target_buffer_size) {
+        memcpy((uint8_t *)&slave_shmem + trans->initiator2target_offset, split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size);
+    }
+    if (trans->slave_callback) {
+        swap_shared_memory();
+        trans->slave_callback(trans->initiator2target_buffer_size, split_trans_initiator2target_buffer(trans), trans->target2initiator_buffer_size, split_trans_target2initiator_buffer(trans));
+        swap_shared_memory();
+    }
+    if (trans->target2initiator_buffer_size) {
+        memcpy(split_trans_target2initiator_buffer(trans), (uint8_t *)&slave_shmem + trans->target2initiator_offset, trans->target2initiator_buffer_size);
+    }
+    return true;
+}
+
+void split_loopback_init(void) {
+    memset(&slave_shmem, 0, sizeof(slave_shmem));
+    memset(split_shmem, 0, sizeof(*split_shmem));
+    transport_master_init();
+    swap_shared_memory();
+    transport_slave_init();
+    swap_shared_memory();
+    split_loopback_reset_stats();
+}
+
+bool split_loopback_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    return transport_master(master_matrix, slave_matrix);
+}
+
+void split_loopback_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    swap_shared_memory();
+    transport_slave(master_matrix, slave_matrix);
+    swap_shared_memory();
+}
+
+void split_loopback_reset_stats(void) {
+    transaction_count = 0;
+    byte_count        = 0;
+}
+
+uint32_t split_loopback_transactions(void) {
+    return transaction_count;
+}
+
+uint32_t split_loopback_bytes(void) {
+    return byte_count;
+}
@@ -0,0 +1,32 @@
+// Copyright 2025 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * In-process stand-in for the split serial transport. Both halves run in the
+ * same executable: the master uses the real split_shmem, while the slave's
+ * copy is swapped in only for the duration of its handlers and transaction
+ * callbacks. Globals outside the shared memory (layer state, mods, ...) are
+ * not duplicated, so the slave side will overwrite them.
+ */
+void split_loopback_init(void);
+
+bool split_loopback_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+void split_loopback_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+
+void     split_loopback_reset_stats(void);
+uint32_t split_loopback_transactions(void);
+uint32_t split_loopback_bytes(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -104,6 +104,12 @@ void TestFixture::add_key(KeymapKey key) {
     }
 
     this->keymap.push_back(key);
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+    layer_lookup_cache_invalidate();
+#endif
+#ifdef KEY_FAST_PATH
+    key_fast_path_invalidate();
+#endif
 }
 
 void TestFixture::tap_key(KeymapKey key, unsigned delay_ms) {
@@ -131,6 +137,12 @@ void TestFixture::tap_combo(const std::vector<KeymapKey>& chord_keys, unsigned d
 
 void TestFixture::set_keymap(std::initializer_list<KeymapKey> keys) {
     this->keymap.clear();
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+    layer_lookup_cache_invalidate();
+#endif
+#ifdef KEY_FAST_PATH
+    key_fast_path_invalidate();
+#endif
     for (auto& key : keys) {
         add_key(key);
     }
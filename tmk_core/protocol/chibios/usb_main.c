@@ -446,18 +446,149 @@ static bool receive_report(usb_endpoint_out_lut_t endpoint, void *report, size_t
     return usb_endpoint_out_receive(&usb_endpoints_out[endpoint], (uint8_t *)report, size, TIME_IMMEDIATE);
 }
 
+#ifdef USB_REPORT_COALESCING
+/* ---------------------------------------------------------
+ *                Keyboard report coalescing
+ * ---------------------------------------------------------
+ */
+
+/* Only the most recent keyboard or NKRO report is held back, while the
+ * endpoint is still busy with earlier ones. */
+typedef struct {
+    usb_endpoint_in_lut_t endpoint;
+    size_t                size;
+    bool                  pending;
+    uint8_t               queued[sizeof(report_nkro_t)]; /* last report handed to the endpoint */
+    uint8_t               report[sizeof(report_nkro_t)]; /* latest report, not yet handed over */
+} usb_coalesced_report_t;
+
+_Static_assert(sizeof(report_keyboard_t) <= sizeof(report_nkro_t), "Keyboard report does not fit the coalescing buffer");
+
+static usb_coalesced_report_t coalesced_report;
+
+/**
+ * @brief Checks whether replacing the pending report would hide a change
+ * from the host, i.e. a bit that the pending report flips and the next one
+ * flips back, such as a key pressed and released within one interval.
+ */
+static bool report_bits_hide_transition(const uint8_t *queued, const uint8_t *pending, const uint8_t *next, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if ((queued[i] ^ pending[i]) & (pending[i] ^ next[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool report_keys_contain(const uint8_t *keys, uint8_t key) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keys[i] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Same as `report_bits_hide_transition` for 6KRO reports, whose keys
+ * are compared as a set since they may move between slots. The modifiers
+ * and keys are the last bytes of both the boot and report protocol layouts.
+ */
+static bool report_keys_hide_transition(const uint8_t *queued, const uint8_t *pending, const uint8_t *next, size_t size) {
+    const size_t keys = size - KEYBOARD_REPORT_KEYS;
+    const size_t mods = keys - 2;
+
+    if (report_bits_hide_transition(&queued[mods], &pending[mods], &next[mods], 1)) {
+        return true;
+    }
+
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        /* Pressed and released again */
+        uint8_t key = pending[keys + i];
+        if (key != KC_NO && !report_keys_contain(&queued[keys], key) && !report_keys_contain(&next[keys], key)) {
+            return true;
+        }
+        /* Released and pressed again */
+        key = queued[keys + i];
+        if (key != KC_NO && !report_keys_contain(&pending[keys], key) && report_keys_contain(&next[keys], key)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void coalesced_report_commit(void) {
+    if (coalesced_report.pending) {
+        coalesced_report.pending = false;
+        send_report(coalesced_report.endpoint, coalesced_report.report, coalesced_report.size);
+        memcpy(coalesced_report.queued, coalesced_report.report, coalesced_report.size);
+    }
+}
+
+/**
+ * @brief Send a keyboard report, merging it with any report still waiting
+ * for the endpoint. Reports are handed over straight away while the
+ * endpoint is idle; otherwise only the latest state is kept, unless it
+ * would hide a press or release from the host, and is handed over by
+ * `usb_report_coalescing_task` once the endpoint has drained.
+ *
+ * @param endpoint USB IN endpoint to send the report from
+ * @param report pointer to the report
+ * @param size size of the report
+ * @param hides_transition check for changes that must not be merged away
+ */
+static void send_report_coalesced(usb_endpoint_in_lut_t endpoint, const void *report, size_t size, bool (*hides_transition)(const uint8_t *, const uint8_t *, const uint8_t *, size_t)) {
+    const bool same_report = coalesced_report.endpoint == endpoint && coalesced_report.size == size;
+
+    if (coalesced_report.pending && (!same_report || hides_transition(coalesced_report.queued, coalesced_report.report, report, size))) {
+        coalesced_report_commit();
+    }
+
+    if (!same_report || usb_endpoint_in_is_inactive(&usb_endpoints_in[endpoint])) {
+        coalesced_report.endpoint = endpoint;
+        coalesced_report.size     = size;
+        coalesced_report.pending  = false;
+        memcpy(coalesced_report.queued, report, size);
+        send_report(endpoint, (void *)report, size);
+        return;
+    }
+
+    memcpy(coalesced_report.report, report, size);
+    coalesced_report.pending = true;
+}
+
+void usb_report_coalescing_task(void) {
+    if (coalesced_report.pending && usb_endpoint_in_is_inactive(&usb_endpoints_in[coalesced_report.endpoint])) {
+        coalesced_report_commit();
+    }
+}
+#endif
+
 void send_keyboard(report_keyboard_t *report) {
+#ifdef USB_REPORT_COALESCING
+    /* If we're in Boot Protocol, don't send any report ID or other funky fields */
+    if (usb_device_state_get_protocol() == USB_PROTOCOL_BOOT) {
+        send_report_coalesced(USB_ENDPOINT_IN_KEYBOARD, &report->mods, 8, report_keys_hide_transition);
+    } else {
+        send_report_coalesced(USB_ENDPOINT_IN_KEYBOARD, report, KEYBOARD_REPORT_SIZE, report_keys_hide_transition);
+    }
+#else
     /* If we're in Boot Protocol, don't send any report ID or other funky fields */
     if (usb_device_state_get_protocol() == USB_PROTOCOL_BOOT) {
         send_report(USB_ENDPOINT_IN_KEYBOARD, &report->mods, 8);
     } else {
         send_report(USB_ENDPOINT_IN_KEYBOARD, report, KEYBOARD_REPORT_SIZE);
     }
+#endif
 }
 
 void send_nkro(report_nkro_t *report) {
 #ifdef NKRO_ENABLE
+#    ifdef USB_REPORT_COALESCING
+    send_report_coalesced(USB_ENDPOINT_IN_SHARED, report, sizeof(report_nkro_t), report_bits_hide_transition);
+#    else
     send_report(USB_ENDPOINT_IN_SHARED, report, sizeof(report_nkro_t));
+#    endif
 #endif
 }
 
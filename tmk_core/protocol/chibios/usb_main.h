@@ -34,6 +34,11 @@ void restart_usb_driver(USBDriver *usbp);
 
 bool send_report(usb_endpoint_in_lut_t endpoint, void *report, size_t size);
 
+#ifdef USB_REPORT_COALESCING
+/* Hand over a held back keyboard report once its endpoint has drained */
+void usb_report_coalescing_task(void);
+#endif
+
 /* ---------------
  * USB Event queue
  * ---------------